@@ -0,0 +1,322 @@
+#include "BatchSweep.hpp"
+#include "ParallelFor.hpp"
+#include "SimulatedUniverse.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+using json = nlohmann::json;
+
+static constexpr int kCheckpointVersion = 1;
+
+size_t SweepSpec::size() const {
+    size_t count = 1;
+    for (const auto& axis : axes) {
+        count *= axis.steps;
+    }
+    return count;
+}
+
+UniverseParameters SweepSpec::at(size_t index) const {
+    std::array<double, kAxes> values{};
+    for (size_t a = kAxes; a-- > 0;) {
+        const Axis& axis = axes[a];
+        const size_t step = index % axis.steps;
+        index /= axis.steps;
+        const double fraction = axis.steps > 1 ? static_cast<double>(step) / (axis.steps - 1) : 0.0;
+        if (axis.logarithmic) {
+            const double low = std::log10(axis.min);
+            values[a] = std::pow(10.0, low + (std::log10(axis.max) - low) * fraction);
+        } else {
+            values[a] = axis.min + (axis.max - axis.min) * fraction;
+        }
+    }
+    return UniverseParameters(values[0], values[1], values[2], values[3], values[4]);
+}
+
+json SweepSpec::toJson() const {
+    json result;
+    result["axes"] = json::array();
+    for (const auto& axis : axes) {
+        result["axes"].push_back({{"logarithmic", axis.logarithmic}, {"max", axis.max},
+                                  {"min", axis.min}, {"steps", axis.steps}});
+    }
+    result["chunkSize"] = chunkSize;
+    return result;
+}
+
+SweepSpec SweepSpec::fromJson(const json& json) {
+    SweepSpec spec;
+    const auto& axes = json.at("axes");
+    if (axes.size() != kAxes) {
+        throw std::runtime_error("A sweep has exactly five axes");
+    }
+    for (size_t a = 0; a < kAxes; ++a) {
+        spec.axes[a].min = axes[a].at("min").get<double>();
+        spec.axes[a].max = axes[a].at("max").get<double>();
+        spec.axes[a].steps = axes[a].at("steps").get<size_t>();
+        spec.axes[a].logarithmic = axes[a].at("logarithmic").get<bool>();
+    }
+    spec.chunkSize = json.at("chunkSize").get<size_t>();
+    return spec;
+}
+
+void SweepAggregate::add(MilestoneType type, double timestamp) {
+    Moments& moments = timestamps[static_cast<size_t>(type)];
+    ++moments.count;
+    moments.sum += timestamp;
+    moments.min = std::min(moments.min, timestamp);
+    moments.max = std::max(moments.max, timestamp);
+    ++milestones;
+}
+
+void SweepAggregate::merge(const SweepAggregate& other) {
+    universes += other.universes;
+    milestones += other.milestones;
+    for (size_t i = 0; i < endings.size(); ++i) {
+        endings[i] += other.endings[i];
+    }
+    for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+        timestamps[t].count += other.timestamps[t].count;
+        timestamps[t].sum += other.timestamps[t].sum;
+        timestamps[t].min = std::min(timestamps[t].min, other.timestamps[t].min);
+        timestamps[t].max = std::max(timestamps[t].max, other.timestamps[t].max);
+    }
+}
+
+json SweepAggregate::toJson() const {
+    json result;
+    result["endings"] = endings;
+    result["milestones"] = milestones;
+    result["timestamps"] = json::array();
+    for (const auto& moments : timestamps) {
+        // min and max are infinite, which JSON cannot hold, until a value arrives
+        json entry = {{"count", moments.count}, {"sum", moments.sum}};
+        if (moments.count > 0) {
+            entry["max"] = moments.max;
+            entry["min"] = moments.min;
+        }
+        result["timestamps"].push_back(std::move(entry));
+    }
+    result["universes"] = universes;
+    return result;
+}
+
+SweepAggregate SweepAggregate::fromJson(const json& json) {
+    SweepAggregate aggregate;
+    aggregate.universes = json.at("universes").get<std::uint64_t>();
+    aggregate.milestones = json.at("milestones").get<std::uint64_t>();
+    aggregate.endings = json.at("endings").get<decltype(aggregate.endings)>();
+    const auto& timestamps = json.at("timestamps");
+    if (timestamps.size() != kMilestoneTypeCount) {
+        throw std::runtime_error("Checkpoint has the wrong number of milestone types");
+    }
+    for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+        Moments& moments = aggregate.timestamps[t];
+        moments.count = timestamps[t].at("count").get<std::uint64_t>();
+        moments.sum = timestamps[t].at("sum").get<double>();
+        if (moments.count > 0) {
+            moments.min = timestamps[t].at("min").get<double>();
+            moments.max = timestamps[t].at("max").get<double>();
+        }
+    }
+    return aggregate;
+}
+
+// Replace path with text so that a crash leaves either the old or the new file
+static void writeAtomically(const std::string& path, const std::string& text) {
+    const std::string temporary = path + ".tmp";
+    std::FILE* file = std::fopen(temporary.c_str(), "wb");
+    if (!file) {
+        throw std::system_error(errno, std::generic_category(), "Cannot write " + temporary);
+    }
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size() &&
+                         std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    const int error = errno;
+    std::fclose(file);
+    if (!written) {
+        throw std::system_error(error, std::generic_category(), "Cannot write " + temporary);
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        throw std::system_error(errno, std::generic_category(), "Cannot replace " + path);
+    }
+}
+
+BatchSweep::BatchSweep(SweepSpec spec, Options options)
+    : spec(std::move(spec))
+    , options(std::move(options))
+{
+    for (const auto& axis : this->spec.axes) {
+        if (axis.steps == 0 || (axis.logarithmic && axis.min <= 0.0)) {
+            throw std::invalid_argument("Sweep axes need at least one step and positive bounds on log scales");
+        }
+    }
+    if (this->spec.chunkSize == 0) {
+        throw std::invalid_argument("Sweep chunks need at least one universe");
+    }
+}
+
+static const char* precisionName(MilestoneFormulas::Precision precision) {
+    return precision == MilestoneFormulas::Precision::Fast ? "fast" : "exact";
+}
+
+SweepAggregate BatchSweep::runChunk(size_t chunk) const {
+    const size_t begin = chunk * spec.chunkSize;
+    const size_t end = std::min(spec.size(), begin + spec.chunkSize);
+
+    // The formulas directly: the same timestamps as a SimulatedUniverse's
+    // timeline, without interning it or allocating its milestones
+    SweepAggregate aggregate;
+    for (size_t index = begin; index < end; ++index) {
+        const UniverseParameters params = spec.at(index);
+        const std::optional<MilestoneType> ending = SimulatedUniverse::ending(params);
+        ++aggregate.universes;
+        ++aggregate.endings[ending ? static_cast<size_t>(*ending) : kMilestoneTypeCount];
+        for (MilestoneType type : SimulatedUniverse::milestoneTypes(params)) {
+            aggregate.add(type, MilestoneFormulas::timestamp(type, params, options.precision));
+        }
+    }
+    return aggregate;
+}
+
+BatchSweep::Result BatchSweep::run() {
+    using Clock = std::chrono::steady_clock;
+    const auto start = Clock::now();
+    const size_t total = spec.chunkCount();
+
+    // Chunks [0, prefixEnd) are folded into prefix; later ones wait in
+    // pending until the gap before them closes
+    size_t prefixEnd = 0;
+    SweepAggregate prefix;
+    std::map<size_t, SweepAggregate> pending;
+
+    const bool checkpointing = !options.checkpointPath.empty();
+    if (checkpointing) {
+        std::ifstream in(options.checkpointPath);
+        if (in) {
+            const json checkpoint = json::parse(in);
+            if (checkpoint.at("version").get<int>() != kCheckpointVersion ||
+                checkpoint.at("spec") != spec.toJson() ||
+                checkpoint.at("precision").get<std::string>() != precisionName(options.precision)) {
+                throw std::runtime_error(options.checkpointPath + " belongs to a different sweep");
+            }
+            prefixEnd = checkpoint.at("prefixEnd").get<size_t>();
+            prefix = SweepAggregate::fromJson(checkpoint.at("prefix"));
+            for (const auto& entry : checkpoint.at("pending")) {
+                pending.emplace(entry.at("chunk").get<size_t>(), SweepAggregate::fromJson(entry.at("aggregate")));
+            }
+        }
+    }
+
+    Result result;
+    result.chunksResumed = prefixEnd + pending.size();
+    std::vector<size_t> todo;
+    for (size_t chunk = prefixEnd; chunk < total; ++chunk) {
+        if (!pending.count(chunk)) {
+            todo.push_back(chunk);
+        }
+    }
+
+    std::mutex mutex;           // guards the state above and result
+    std::mutex writing;         // one checkpoint write at a time
+    auto lastCheckpoint = Clock::now();
+    size_t done = result.chunksResumed;
+
+    auto checkpoint = [&](bool wait) {
+        std::unique_lock<std::mutex> writer(writing, std::defer_lock);
+        if (wait) {
+            writer.lock();
+        } else if (!writer.try_lock()) {
+            return;
+        }
+        const auto begin = Clock::now();
+        json state;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            state["version"] = kCheckpointVersion;
+            state["spec"] = spec.toJson();
+            state["precision"] = precisionName(options.precision);
+            state["prefixEnd"] = prefixEnd;
+            state["prefix"] = prefix.toJson();
+            state["pending"] = json::array();
+            for (const auto& [chunk, aggregate] : pending) {
+                state["pending"].push_back({{"aggregate", aggregate.toJson()}, {"chunk", chunk}});
+            }
+        }
+        writeAtomically(options.checkpointPath, state.dump());
+        std::lock_guard<std::mutex> lock(mutex);
+        ++result.checkpoints;
+        result.checkpointSeconds += std::chrono::duration<double>(Clock::now() - begin).count();
+        lastCheckpoint = Clock::now();
+    };
+
+    // Workers take the next chunk in order, so chunks finish roughly in
+    // order and pending stays short
+    std::atomic<size_t> next{0};
+    const unsigned threads = options.threads ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    try {
+        parallelFor(threads, 1, [&](size_t, size_t) {
+            while (!stopping.load(std::memory_order_relaxed)) {
+                const size_t i = next++;
+                if (i >= todo.size()) {
+                    break;
+                }
+                SweepAggregate aggregate;
+                try {
+                    aggregate = runChunk(todo[i]);
+                } catch (...) {
+                    stop();
+                    throw;
+                }
+
+                bool due = false;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    pending.emplace(todo[i], std::move(aggregate));
+                    while (!pending.empty() && pending.begin()->first == prefixEnd) {
+                        prefix.merge(pending.begin()->second);
+                        pending.erase(pending.begin());
+                        ++prefixEnd;
+                    }
+                    ++done;
+                    ++result.chunksRun;
+                    if (options.progress) {
+                        options.progress(done, total);
+                    }
+                    due = checkpointing && Clock::now() - lastCheckpoint >= options.checkpointInterval;
+                }
+                if (due) {
+                    checkpoint(false);
+                }
+            }
+        });
+    } catch (...) {
+        // Keep what the other workers finished
+        if (checkpointing) {
+            checkpoint(true);
+        }
+        throw;
+    }
+
+    // The final checkpoint lets a rerun return at once, e.g. when the
+    // caller died before saving the result
+    if (checkpointing) {
+        checkpoint(true);
+    }
+    result.complete = prefixEnd == total;
+    if (result.complete) {
+        result.aggregate = prefix;
+    }
+    result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "MilestoneFormulas.hpp"
+#include "Milestone.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+
+// Grid of parameter sets for a sweep. Point i enumerates the axes in
+// mixed radix, the last axis (w) varying fastest.
+struct SweepSpec {
+    struct Axis {
+        double min;
+        double max;
+        size_t steps;
+        bool logarithmic;  // steps are spaced evenly in log10
+    };
+
+    static constexpr size_t kAxes = 5;
+
+    // Ω_m, Ω_Λ, H₀, η, w over the ranges UniverseValidator accepts
+    std::array<Axis, kAxes> axes{{
+        {0.1, 2.0, 10, false},
+        {0.0, 1.0, 10, false},
+        {50.0, 80.0, 10, false},
+        {1e-11, 1e-7, 10, true},
+        {-2.0, -0.5, 10, false},
+    }};
+    size_t chunkSize = 4096;
+
+    size_t size() const;
+    size_t chunkCount() const { return (size() + chunkSize - 1) / chunkSize; }
+    UniverseParameters at(size_t index) const;
+
+    nlohmann::json toJson() const;
+    static SweepSpec fromJson(const nlohmann::json& json);
+};
+
+// Aggregates over the timelines of a range of sweep points. Merging in a
+// fixed order gives bit-identical sums however the work was split.
+struct SweepAggregate {
+    struct Moments {
+        std::uint64_t count = 0;
+        double sum = 0.0;
+        double min = std::numeric_limits<double>::infinity();
+        double max = -std::numeric_limits<double>::infinity();
+    };
+
+    std::uint64_t universes = 0;
+    std::uint64_t milestones = 0;
+    // Index kMilestoneTypeCount counts universes without an ending
+    std::array<std::uint64_t, kMilestoneTypeCount + 1> endings{};
+    std::array<Moments, kMilestoneTypeCount> timestamps{};
+
+    // One milestone; callers count the universe and its ending
+    void add(MilestoneType type, double timestamp);
+    void merge(const SweepAggregate& other);
+
+    nlohmann::json toJson() const;
+    static SweepAggregate fromJson(const nlohmann::json& json);
+};
+
+// Evaluates every point of a SweepSpec, a chunk of chunkSize points at a
+// time, on all cores.
+//
+// Progress is checkpointed to a file: the aggregate of the finished prefix
+// of chunks plus the aggregates of chunks finished out of order. Chunks are
+// folded into the prefix strictly in index order, so a run that resumes
+// from a checkpoint produces exactly the same result as one that did not.
+// Checkpoints are written to a temporary file, synced and renamed over the
+// previous one, so a crash leaves either the old or the new checkpoint.
+class BatchSweep {
+public:
+    struct Options {
+        std::string checkpointPath;  // empty: no checkpoints
+        std::chrono::milliseconds checkpointInterval{10000};
+        unsigned threads = 0;        // 0 uses the hardware concurrency
+        MilestoneFormulas::Precision precision = MilestoneFormulas::kDefaultPrecision;
+        // Called after every chunk with the chunks done so far and in total
+        std::function<void(size_t done, size_t total)> progress;
+    };
+
+    struct Result {
+        SweepAggregate aggregate;  // complete only if complete is true
+        bool complete = false;
+        size_t chunksRun = 0;
+        size_t chunksResumed = 0;  // taken over from the checkpoint
+        size_t checkpoints = 0;
+        double seconds = 0.0;
+        double checkpointSeconds = 0.0;  // spent serializing and writing them
+    };
+
+    BatchSweep(SweepSpec spec, Options options);
+
+    // Run the sweep, resuming from the checkpoint if there is one. Throws
+    // std::runtime_error when the checkpoint belongs to a different spec or
+    // precision.
+    Result run();
+    // Make run() write a checkpoint and return after the chunks in flight;
+    // async-signal-safe
+    void stop() { stopping.store(true, std::memory_order_relaxed); }
+
+private:
+    SweepAggregate runChunk(size_t chunk) const;
+
+    SweepSpec spec;
+    Options options;
+    std::atomic<bool> stopping{false};
+};
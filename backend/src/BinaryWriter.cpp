@@ -0,0 +1,240 @@
+#include "BinaryWriter.hpp"
+#include <cmath>
+#include <cstring>
+
+namespace {
+// CBOR major types (RFC 8949, section 3.1)
+constexpr std::uint8_t kCborUnsigned = 0x00;
+constexpr std::uint8_t kCborNegative = 0x20;
+constexpr std::uint8_t kCborText = 0x60;
+constexpr std::uint8_t kCborIndefiniteArray = 0x9F;
+constexpr std::uint8_t kCborIndefiniteMap = 0xBF;
+constexpr std::uint8_t kCborFloat32 = 0xFA;
+constexpr std::uint8_t kCborFloat64 = 0xFB;
+constexpr std::uint8_t kCborFalse = 0xF4;
+constexpr std::uint8_t kCborTrue = 0xF5;
+constexpr std::uint8_t kCborNull = 0xF6;
+constexpr std::uint8_t kCborBreak = 0xFF;
+
+// MessagePack type bytes
+constexpr std::uint8_t kMsgpackNull = 0xC0;
+constexpr std::uint8_t kMsgpackFalse = 0xC2;
+constexpr std::uint8_t kMsgpackTrue = 0xC3;
+constexpr std::uint8_t kMsgpackFloat32 = 0xCA;
+constexpr std::uint8_t kMsgpackFloat64 = 0xCB;
+constexpr std::uint8_t kMsgpackUint8 = 0xCC;
+constexpr std::uint8_t kMsgpackUint16 = 0xCD;
+constexpr std::uint8_t kMsgpackUint32 = 0xCE;
+constexpr std::uint8_t kMsgpackUint64 = 0xCF;
+constexpr std::uint8_t kMsgpackInt8 = 0xD0;
+constexpr std::uint8_t kMsgpackInt16 = 0xD1;
+constexpr std::uint8_t kMsgpackInt32 = 0xD2;
+constexpr std::uint8_t kMsgpackInt64 = 0xD3;
+constexpr std::uint8_t kMsgpackStr8 = 0xD9;
+constexpr std::uint8_t kMsgpackStr16 = 0xDA;
+constexpr std::uint8_t kMsgpackStr32 = 0xDB;
+constexpr std::uint8_t kMsgpackArray32 = 0xDD;
+constexpr std::uint8_t kMsgpackMap32 = 0xDF;
+}
+
+BinaryWriter::BinaryWriter(Format format, std::pmr::memory_resource* resource)
+    : format(format)
+    , out(resource)
+    , scopes(resource)
+{
+    scopes.reserve(8);
+}
+
+void BinaryWriter::beginObject() {
+    beginContainer(true);
+}
+
+void BinaryWriter::endObject() {
+    endContainer();
+}
+
+void BinaryWriter::beginArray() {
+    beginContainer(false);
+}
+
+void BinaryWriter::endArray() {
+    endContainer();
+}
+
+void BinaryWriter::key(JsonKey key) {
+    this->key(key.name());
+}
+
+void BinaryWriter::key(std::string_view key) {
+    ++scopes.back().count;
+    writeString(key);
+    pendingKey = true;
+}
+
+void BinaryWriter::value(double number) {
+    if (!std::isfinite(number)) {
+        // Matches the JSON writer, which prints non-finite numbers as null
+        null();
+        return;
+    }
+    beginValue();
+
+    const auto narrowed = static_cast<float>(number);
+    if (static_cast<double>(narrowed) == number) {
+        std::uint32_t bits;
+        std::memcpy(&bits, &narrowed, sizeof(bits));
+        out.push_back(static_cast<char>(format == Format::Cbor ? kCborFloat32 : kMsgpackFloat32));
+        writeBigEndian(bits, 4);
+    } else {
+        std::uint64_t bits;
+        std::memcpy(&bits, &number, sizeof(bits));
+        out.push_back(static_cast<char>(format == Format::Cbor ? kCborFloat64 : kMsgpackFloat64));
+        writeBigEndian(bits, 8);
+    }
+}
+
+void BinaryWriter::value(std::int64_t number) {
+    beginValue();
+
+    if (format == Format::Cbor) {
+        if (number >= 0) {
+            writeTypeAndLength(kCborUnsigned, static_cast<std::uint64_t>(number));
+        } else {
+            writeTypeAndLength(kCborNegative, static_cast<std::uint64_t>(-1 - number));
+        }
+        return;
+    }
+
+    if (number >= 0 && number <= 0x7F) {
+        out.push_back(static_cast<char>(number));  // positive fixint
+    } else if (number < 0 && number >= -32) {
+        out.push_back(static_cast<char>(0xE0 | (number + 32)));  // negative fixint
+    } else if (number > 0) {
+        if (number <= 0xFF) {
+            out.push_back(static_cast<char>(kMsgpackUint8));
+            writeBigEndian(static_cast<std::uint64_t>(number), 1);
+        } else if (number <= 0xFFFF) {
+            out.push_back(static_cast<char>(kMsgpackUint16));
+            writeBigEndian(static_cast<std::uint64_t>(number), 2);
+        } else if (number <= 0xFFFFFFFF) {
+            out.push_back(static_cast<char>(kMsgpackUint32));
+            writeBigEndian(static_cast<std::uint64_t>(number), 4);
+        } else {
+            out.push_back(static_cast<char>(kMsgpackUint64));
+            writeBigEndian(static_cast<std::uint64_t>(number), 8);
+        }
+    } else {
+        const auto bits = static_cast<std::uint64_t>(number);
+        if (number >= -128) {
+            out.push_back(static_cast<char>(kMsgpackInt8));
+            writeBigEndian(bits & 0xFF, 1);
+        } else if (number >= -32768) {
+            out.push_back(static_cast<char>(kMsgpackInt16));
+            writeBigEndian(bits & 0xFFFF, 2);
+        } else if (number >= INT32_MIN) {
+            out.push_back(static_cast<char>(kMsgpackInt32));
+            writeBigEndian(bits & 0xFFFFFFFF, 4);
+        } else {
+            out.push_back(static_cast<char>(kMsgpackInt64));
+            writeBigEndian(bits, 8);
+        }
+    }
+}
+
+void BinaryWriter::value(std::string_view text) {
+    beginValue();
+    writeString(text);
+}
+
+void BinaryWriter::boolean(bool flag) {
+    beginValue();
+    if (format == Format::Cbor) {
+        out.push_back(static_cast<char>(flag ? kCborTrue : kCborFalse));
+    } else {
+        out.push_back(static_cast<char>(flag ? kMsgpackTrue : kMsgpackFalse));
+    }
+}
+
+void BinaryWriter::null() {
+    beginValue();
+    out.push_back(static_cast<char>(format == Format::Cbor ? kCborNull : kMsgpackNull));
+}
+
+void BinaryWriter::beginValue() {
+    if (pendingKey) {
+        pendingKey = false;
+        return;
+    }
+    if (!scopes.empty()) {
+        ++scopes.back().count;
+    }
+}
+
+void BinaryWriter::beginContainer(bool isObject) {
+    beginValue();
+    scopes.push_back({out.size(), 0, isObject});
+
+    if (format == Format::Cbor) {
+        out.push_back(static_cast<char>(isObject ? kCborIndefiniteMap : kCborIndefiniteArray));
+    } else {
+        // Count is patched in endContainer()
+        out.push_back(static_cast<char>(isObject ? kMsgpackMap32 : kMsgpackArray32));
+        out.append(4, '\0');
+    }
+}
+
+void BinaryWriter::endContainer() {
+    const Scope scope = scopes.back();
+    scopes.pop_back();
+
+    if (format == Format::Cbor) {
+        out.push_back(static_cast<char>(kCborBreak));
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        out[scope.headerOffset + 1 + i] = static_cast<char>((scope.count >> (8 * (3 - i))) & 0xFF);
+    }
+}
+
+void BinaryWriter::writeString(std::string_view text) {
+    if (format == Format::Cbor) {
+        writeTypeAndLength(kCborText, text.size());
+    } else if (text.size() < 32) {
+        out.push_back(static_cast<char>(0xA0 | text.size()));  // fixstr
+    } else if (text.size() <= 0xFF) {
+        out.push_back(static_cast<char>(kMsgpackStr8));
+        writeBigEndian(text.size(), 1);
+    } else if (text.size() <= 0xFFFF) {
+        out.push_back(static_cast<char>(kMsgpackStr16));
+        writeBigEndian(text.size(), 2);
+    } else {
+        out.push_back(static_cast<char>(kMsgpackStr32));
+        writeBigEndian(text.size(), 4);
+    }
+    out.append(text);
+}
+
+void BinaryWriter::writeTypeAndLength(std::uint8_t majorType, std::uint64_t length) {
+    if (length < 24) {
+        out.push_back(static_cast<char>(majorType | length));
+    } else if (length <= 0xFF) {
+        out.push_back(static_cast<char>(majorType | 24));
+        writeBigEndian(length, 1);
+    } else if (length <= 0xFFFF) {
+        out.push_back(static_cast<char>(majorType | 25));
+        writeBigEndian(length, 2);
+    } else if (length <= 0xFFFFFFFF) {
+        out.push_back(static_cast<char>(majorType | 26));
+        writeBigEndian(length, 4);
+    } else {
+        out.push_back(static_cast<char>(majorType | 27));
+        writeBigEndian(length, 8);
+    }
+}
+
+void BinaryWriter::writeBigEndian(std::uint64_t value, int bytes) {
+    for (int i = bytes - 1; i >= 0; --i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
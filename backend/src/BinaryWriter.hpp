@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ResponseWriter.hpp"
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Streaming encoder for the binary formats understood by
+// nlohmann::json::from_cbor / from_msgpack.
+//
+// CBOR containers use indefinite-length headers, so nothing has to be known
+// up front. MessagePack has no such form: containers are written with 32-bit
+// count headers that are patched when the container is closed.
+// Doubles that are exactly representable as floats are stored in 4 bytes.
+class BinaryWriter final : public ResponseWriter {
+public:
+    enum class Format {
+        Cbor,
+        MessagePack
+    };
+
+    // The output buffer is allocated from the given memory resource
+    explicit BinaryWriter(Format format,
+                          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    void beginObject() override;
+    void endObject() override;
+    void beginArray() override;
+    void endArray() override;
+
+    void key(JsonKey key) override;
+    void key(std::string_view key) override;
+
+    using ResponseWriter::value;
+    void value(double number) override;
+    void value(std::int64_t number) override;
+    void value(std::string_view text) override;
+    void boolean(bool flag) override;
+    void null() override;
+
+    Format getFormat() const { return format; }
+    std::string_view bytes() const { return out; }
+
+private:
+    void beginValue();
+    void beginContainer(bool isObject);
+    void endContainer();
+    void writeString(std::string_view text);
+    void writeTypeAndLength(std::uint8_t majorType, std::uint64_t length);
+    void writeBigEndian(std::uint64_t value, int bytes);
+
+    struct Scope {
+        size_t headerOffset;
+        std::uint32_t count;
+        bool isObject;
+    };
+
+    Format format;
+    std::pmr::string out;
+    bool pendingKey = false;
+    std::pmr::vector<Scope> scopes;
+};
@@ -0,0 +1,91 @@
+#include "CompactUniverseStore.hpp"
+#include "SimulatedUniverse.hpp"
+#include <atomic>
+#include <string>
+
+std::optional<MilestoneType> CompactUniverseStore::ending(const Record& record) {
+    if (record.ending == kNoEnding) {
+        return std::nullopt;
+    }
+    return static_cast<MilestoneType>(record.ending);
+}
+
+UniverseParameters CompactUniverseStore::parameters(const Record& record) {
+    return UniverseParameters(record.matterDensity, record.darkEnergyDensity, record.hubbleConstant,
+                              record.matterAntimatterRatio, record.darkEnergyW);
+}
+
+std::shared_ptr<const SimulatedUniverse> CompactUniverseStore::materialize(const Record& record,
+                                                                           std::string_view name) {
+    return std::make_shared<const SimulatedUniverse>(std::string(name), record.matterDensity,
+                                                     record.darkEnergyDensity, record.hubbleConstant,
+                                                     record.matterAntimatterRatio, record.darkEnergyW);
+}
+
+void CompactUniverseStore::push_back(const SimulatedUniverse& universe) {
+    const Record record = recordOf(universe, nullptr);
+    if (bound % kChunkSize == 0) {
+        chunks.push_back(std::make_shared<Chunk>());
+    }
+    writable(bound / kChunkSize)[bound % kChunkSize] = record;
+    ++bound;
+    ++live;
+}
+
+void CompactUniverseStore::set(size_t id, const SimulatedUniverse* universe) {
+    const Record* previous = (*this)[id];
+    Record record{};
+    if (universe) {
+        record = recordOf(*universe, previous);
+    }
+    live += (universe != nullptr) - (previous != nullptr);
+    writable(id / kChunkSize)[id % kChunkSize] = record;
+}
+
+CompactUniverseStore::View CompactUniverseStore::view() const {
+    View view;
+    view.chunks.assign(chunks.begin(), chunks.end());
+    view.names = names.view();
+    view.bound = bound;
+    view.live = live;
+    return view;
+}
+
+size_t CompactUniverseStore::getMemoryUsage() const {
+    return chunks.size() * sizeof(Chunk) + chunks.capacity() * sizeof(chunks[0]) + names.getCapacity();
+}
+
+CompactUniverseStore::Record CompactUniverseStore::recordOf(const SimulatedUniverse& universe,
+                                                            const Record* previous) {
+    Record record;
+    record.matterDensity = universe.getMatterDensity();
+    record.darkEnergyDensity = universe.getDarkEnergyDensity();
+    record.hubbleConstant = universe.getHubbleConstant();
+    record.matterAntimatterRatio = universe.getMatterAntimatterRatio();
+    record.darkEnergyW = universe.getDarkEnergyW();
+    const auto end = universe.ending();
+    record.ending = end ? static_cast<std::uint8_t>(*end) : kNoEnding;
+    record.live = 1;
+
+    if (previous && name(*previous) == universe.getName()) {
+        record.nameOffset = previous->nameOffset;
+        record.nameLength = previous->nameLength;
+    } else {
+        const StringArena::Ref ref = names.append(universe.getName());
+        record.nameOffset = ref.offset;
+        record.nameLength = ref.length;
+    }
+    return record;
+}
+
+CompactUniverseStore::Chunk& CompactUniverseStore::writable(size_t chunk) {
+    std::shared_ptr<Chunk>& shared = chunks[chunk];
+    if (shared.use_count() > 1) {
+        shared = std::make_shared<Chunk>(*shared);
+    } else {
+        // Views are released without the database lock: order their last
+        // reads of the chunk before the write that follows
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *shared;
+}
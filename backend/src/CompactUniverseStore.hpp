@@ -0,0 +1,111 @@
+#pragma once
+
+#include "Milestone.hpp"
+#include "StringArena.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+class SimulatedUniverse;
+
+// Universes as packed 48-byte records, the storage behind
+// UniverseDB::Storage::Compact.
+//
+// A SimulatedUniverse is a heap object with two vtable pointers, its own
+// name string and a shared timeline record. Here every universe is one POD
+// record and the names live in a StringArena, so ten million universes with
+// 16-character names take about 650 MB and a scan over parameters or
+// endings walks memory linearly.
+//
+// Records sit in chunks of kChunkSize held by shared_ptr. As in
+// UniverseTable, writing to a chunk that a View still shares clones the
+// chunk first, so views are immutable and can be read from any thread; the
+// store itself is not synchronized. Removed ids keep a dead record, and the
+// names of removed or renamed universes stay in the arena.
+class CompactUniverseStore {
+public:
+    static constexpr size_t kChunkSize = 1024;
+    static constexpr std::uint8_t kNoEnding = 0xff;
+
+    struct Record {
+        double matterDensity;
+        double darkEnergyDensity;
+        double hubbleConstant;
+        double matterAntimatterRatio;
+        double darkEnergyW;
+        std::uint32_t nameOffset;
+        std::uint16_t nameLength;
+        std::uint8_t ending;  // MilestoneType, or kNoEnding
+        std::uint8_t live;
+    };
+    static_assert(sizeof(Record) == 48, "records are packed into 48 bytes");
+    static_assert(std::is_trivially_copyable_v<Record>, "records are POD");
+
+private:
+    using Chunk = std::array<Record, kChunkSize>;
+
+public:
+    class View {
+    public:
+        // One past the largest id
+        size_t size() const { return bound; }
+        // Universes that are not removed
+        size_t count() const { return live; }
+        // nullptr for a removed universe
+        const Record* operator[](size_t id) const { return find(chunks, id); }
+        std::string_view name(const Record& record) const {
+            return names.get({record.nameOffset, record.nameLength});
+        }
+
+    private:
+        friend class CompactUniverseStore;
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        StringArena::View names;
+        size_t bound = 0;
+        size_t live = 0;
+    };
+
+    size_t size() const { return bound; }
+    size_t count() const { return live; }
+    const Record* operator[](size_t id) const { return find(chunks, id); }
+    std::string_view name(const Record& record) const { return names.get({record.nameOffset, record.nameLength}); }
+
+    // Store universe under id size(). Throws std::length_error for names
+    // over StringArena::kMaxLength.
+    void push_back(const SimulatedUniverse& universe);
+    // Replace the universe of an id below size(); nullptr removes it
+    void set(size_t id, const SimulatedUniverse* universe);
+
+    View view() const;
+    // Bytes held for records and names, including spare capacity
+    size_t getMemoryUsage() const;
+
+    static std::optional<MilestoneType> ending(const Record& record);
+    static UniverseParameters parameters(const Record& record);
+    // The full universe with its timeline, for the records that need one
+    static std::shared_ptr<const SimulatedUniverse> materialize(const Record& record, std::string_view name);
+
+private:
+    template <typename Chunks>
+    static const Record* find(const Chunks& chunks, size_t id) {
+        const Record& record = (*chunks[id / kChunkSize])[id % kChunkSize];
+        return record.live ? &record : nullptr;
+    }
+
+    // Record of universe, reusing the arena copy of previous's name when it
+    // is unchanged
+    Record recordOf(const SimulatedUniverse& universe, const Record* previous);
+    // Chunk about to be written, cloned if a view shares it
+    Chunk& writable(size_t chunk);
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    StringArena names;
+    size_t bound = 0;
+    size_t live = 0;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <limits>
+
+// Elementary functions usable in constant expressions, where <cmath> is not
+// constexpr before C++26. Results are within 4 ulp of <cmath> for finite
+// arguments (pow: for exponents |y| <= 1 as in the milestone formulas,
+// about 10 ulp up to |y| = 10); subnormal results are not handled.
+namespace ConstexprMath {
+
+constexpr double kLn2 = 0.693147180559945309417232121458;
+// kLn2 split so that k * kLn2Hi is exact for |k| < 2^20 (Cody and Waite)
+constexpr double kLn2Hi = 6.93147180369123816490e-01;
+constexpr double kLn2Lo = 1.90821492927058770002e-10;
+
+constexpr double infinity() { return std::numeric_limits<double>::infinity(); }
+constexpr double nan() { return std::numeric_limits<double>::quiet_NaN(); }
+
+// x * 2^exponent by repeated exact scaling
+constexpr double scale(double x, int exponent) {
+    for (; exponent > 0; --exponent) x *= 2.0;
+    for (; exponent < 0; ++exponent) x *= 0.5;
+    return x;
+}
+
+constexpr double exp(double x) {
+    if (x != x) return x;
+    if (x > 709.8) return infinity();
+    if (x < -745.2) return 0.0;
+    // x = k ln2 + r with |r| <= ln2 / 2, then a Taylor series for e^r
+    const double rounded = x / kLn2 + (x < 0 ? -0.5 : 0.5);
+    const int k = static_cast<int>(rounded);
+    const double r = (x - k * kLn2Hi) - k * kLn2Lo;
+    double term = 1.0;
+    double sum = 1.0;
+    for (int n = 1; n < 30 && sum + term != sum; ++n) {
+        term *= r / n;
+        sum += term;
+    }
+    return scale(sum, k);
+}
+
+// x = m 2^e with m in [sqrt(1/2), sqrt(2)), for finite x > 0
+constexpr double reduce(double x, int& e) {
+    e = 0;
+    while (x >= 1.4142135623730951) { x *= 0.5; ++e; }
+    while (x < 0.7071067811865476) { x *= 2.0; --e; }
+    return x;
+}
+
+// log m = 2 atanh(s) = 2 (s + s^3/3 + s^5/5 + ...), s = (m - 1) / (m + 1),
+// for m from reduce()
+constexpr double logReduced(double m) {
+    const double s = (m - 1.0) / (m + 1.0);
+    const double s2 = s * s;
+    double power = s;
+    double sum = 0.0;
+    for (int n = 1; n < 80; n += 2) {
+        const double next = sum + power / n;
+        if (next == sum) break;
+        sum = next;
+        power *= s2;
+    }
+    return 2.0 * sum;
+}
+
+constexpr double log(double x) {
+    if (x != x || x < 0.0) return nan();
+    if (x == 0.0) return -infinity();
+    if (x == infinity()) return x;
+    int e = 0;
+    const double m = reduce(x, e);
+    return (e * kLn2Hi + logReduced(m)) + e * kLn2Lo;
+}
+
+// a * b = hi + lo exactly (Dekker's product, as fma is not constexpr)
+constexpr void twoProduct(double a, double b, double& hi, double& lo) {
+    constexpr double kSplit = 134217729.0;  // 2^27 + 1
+    const double ca = kSplit * a;
+    const double aHi = ca - (ca - a);
+    const double aLo = a - aHi;
+    const double cb = kSplit * b;
+    const double bHi = cb - (cb - b);
+    const double bLo = b - bHi;
+    hi = a * b;
+    lo = ((aHi * bHi - hi) + aHi * bLo + aLo * bHi) + aLo * bLo;
+}
+
+constexpr double sqrt(double x) {
+    if (x != x || x < 0.0) return nan();
+    if (x == 0.0 || x == infinity()) return x;
+    // Newton's iteration from a power of two within a factor of two
+    double guess = 1.0;
+    for (double y = x; y >= 4.0; y *= 0.25) guess *= 2.0;
+    for (double y = x; y < 1.0; y *= 4.0) guess *= 0.5;
+    for (int i = 0; i < 64; ++i) {
+        const double next = 0.5 * (guess + x / guess);
+        if (next == guess) break;
+        guess = next;
+    }
+    return guess;
+}
+
+// x^y for x > 0, or x = 0 with y != 0; NaN for negative x
+constexpr double pow(double x, double y) {
+    if (y == 0.0) return 1.0;
+    if (x == 0.0) return y > 0.0 ? 0.0 : infinity();
+    if (x < 0.0) return nan();
+    if (x != x || y != y) return x + y;
+    // x^y = 2^(y e) m^y: the integer part n of y e scales exactly, and only
+    // small arguments reach exp, so rounding is not amplified by |y log x|
+    int e = 0;
+    const double m = reduce(x, e);
+    double hi = 0.0;
+    double lo = 0.0;
+    twoProduct(y, e, hi, lo);
+    if (hi > 2000.0) return infinity();
+    if (hi < -2000.0) return 0.0;
+    const int n = static_cast<int>(hi + (hi < 0 ? -0.5 : 0.5));
+    const double fraction = (hi - n) + lo;
+    return scale(exp(fraction * kLn2 + y * logReduced(m)), n);
+}
+
+// Scalar for evaluating the MilestoneFormulas templates in constant
+// expressions: arithmetic of a double, pow and sqrt from above (found by
+// argument-dependent lookup, as for Dual)
+struct Real {
+    double value = 0.0;
+
+    constexpr Real() = default;
+    constexpr Real(double value) : value(value) {}
+
+    friend constexpr Real operator+(Real a, Real b) { return a.value + b.value; }
+    friend constexpr Real operator-(Real a, Real b) { return a.value - b.value; }
+    friend constexpr Real operator*(Real a, Real b) { return a.value * b.value; }
+    friend constexpr Real operator/(Real a, Real b) { return a.value / b.value; }
+    friend constexpr Real operator-(Real a) { return -a.value; }
+
+    friend constexpr bool operator<(Real a, Real b) { return a.value < b.value; }
+    friend constexpr bool operator>(Real a, Real b) { return a.value > b.value; }
+    friend constexpr bool operator<=(Real a, Real b) { return a.value <= b.value; }
+    friend constexpr bool operator>=(Real a, Real b) { return a.value >= b.value; }
+    friend constexpr bool operator==(Real a, Real b) { return a.value == b.value; }
+    friend constexpr bool operator!=(Real a, Real b) { return a.value != b.value; }
+
+    friend constexpr Real pow(Real x, double p) { return ConstexprMath::pow(x.value, p); }
+    friend constexpr Real sqrt(Real x) { return ConstexprMath::sqrt(x.value); }
+};
+
+} // namespace ConstexprMath
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// Forward-mode dual number carrying the gradient with respect to N inputs.
+// Arithmetic applies the chain rule alongside the value; comparisons look at
+// the value only, so branching code follows the active branch and returns
+// its one-sided derivative.
+template <size_t N>
+struct Dual {
+    double value = 0.0;
+    std::array<double, N> gradient{};
+
+    Dual() = default;
+    // Constants have a zero gradient
+    Dual(double value) : value(value) {}
+
+    // Input number `index`, with d/d(input index) = 1
+    static Dual variable(double value, size_t index) {
+        Dual dual(value);
+        dual.gradient[index] = 1.0;
+        return dual;
+    }
+};
+
+template <size_t N>
+Dual<N> operator-(const Dual<N>& x) {
+    Dual<N> result(-x.value);
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = -x.gradient[i];
+    }
+    return result;
+}
+
+template <size_t N>
+Dual<N> operator+(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value + b.value);
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = a.gradient[i] + b.gradient[i];
+    }
+    return result;
+}
+
+template <size_t N>
+Dual<N> operator-(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value - b.value);
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = a.gradient[i] - b.gradient[i];
+    }
+    return result;
+}
+
+template <size_t N>
+Dual<N> operator*(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value * b.value);
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = a.gradient[i] * b.value + a.value * b.gradient[i];
+    }
+    return result;
+}
+
+template <size_t N>
+Dual<N> operator/(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value / b.value);
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = (a.gradient[i] * b.value - a.value * b.gradient[i]) / (b.value * b.value);
+    }
+    return result;
+}
+
+template <size_t N> Dual<N> operator+(const Dual<N>& a, double b) { return a + Dual<N>(b); }
+template <size_t N> Dual<N> operator+(double a, const Dual<N>& b) { return Dual<N>(a) + b; }
+template <size_t N> Dual<N> operator-(const Dual<N>& a, double b) { return a - Dual<N>(b); }
+template <size_t N> Dual<N> operator-(double a, const Dual<N>& b) { return Dual<N>(a) - b; }
+template <size_t N> Dual<N> operator*(const Dual<N>& a, double b) { return a * Dual<N>(b); }
+template <size_t N> Dual<N> operator*(double a, const Dual<N>& b) { return Dual<N>(a) * b; }
+template <size_t N> Dual<N> operator/(const Dual<N>& a, double b) { return a / Dual<N>(b); }
+template <size_t N> Dual<N> operator/(double a, const Dual<N>& b) { return Dual<N>(a) / b; }
+
+template <size_t N> bool operator<(const Dual<N>& a, double b) { return a.value < b; }
+template <size_t N> bool operator<=(const Dual<N>& a, double b) { return a.value <= b; }
+template <size_t N> bool operator>(const Dual<N>& a, double b) { return a.value > b; }
+template <size_t N> bool operator>=(const Dual<N>& a, double b) { return a.value >= b; }
+template <size_t N> bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.value < b.value; }
+
+// x^p for a constant exponent
+template <size_t N>
+Dual<N> pow(const Dual<N>& x, double p) {
+    Dual<N> result(std::pow(x.value, p));
+    const double derivative = p * std::pow(x.value, p - 1.0);
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = derivative * x.gradient[i];
+    }
+    return result;
+}
+
+template <size_t N>
+Dual<N> sqrt(const Dual<N>& x) {
+    Dual<N> result(std::sqrt(x.value));
+    const double derivative = 0.5 / result.value;
+    for (size_t i = 0; i < N; ++i) {
+        result.gradient[i] = derivative * x.gradient[i];
+    }
+    return result;
+}
@@ -0,0 +1,232 @@
+#include "EnsembleStatistics.hpp"
+#include "SimulatedUniverse.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+size_t linearBin(size_t quantity, double value, bool& underflow, bool& overflow) {
+    const auto [low, high] = EnsembleStatistics::linearRange(quantity);
+    underflow = value < low;
+    overflow = value >= high;
+    const auto bin = static_cast<size_t>((value - low) / (high - low) * EnsembleStatistics::kLinearBins);
+    return std::min(bin, EnsembleStatistics::kLinearBins - 1);
+}
+
+// Log histogram bin of value, or -1 for underflow and kLogBins for overflow
+long logBin(double value) {
+    if (!(value > 0.0)) {
+        return -1;
+    }
+    const double position = (std::log10(value) - EnsembleStatistics::kMinExponent) *
+                            EnsembleStatistics::kLogBinsPerDecade;
+    if (position < 0.0) {
+        return -1;
+    }
+    return std::min(static_cast<long>(position), static_cast<long>(EnsembleStatistics::kLogBins));
+}
+}
+
+EnsembleStatistics::Sample EnsembleStatistics::Sample::of(const SimulatedUniverse& universe) {
+    Sample sample;
+    sample.values[0] = universe.getMatterDensity();
+    sample.values[1] = universe.getDarkEnergyDensity();
+    sample.values[2] = universe.getHubbleConstant();
+    sample.values[3] = universe.getMatterAntimatterRatio();
+    sample.values[4] = universe.getDarkEnergyW();
+    for (size_t i = 0; i < kParameterCount; ++i) {
+        sample.present.set(i);
+    }
+
+    const ComputedTimeline& computed = universe.getComputedTimeline();
+    const LazyTimeline& timeline = computed.timeline();
+    for (size_t i = 0; i < timeline.size(); ++i) {
+        const size_t quantity = kParameterCount + static_cast<size_t>(timeline.typeAt(i));
+        sample.values[quantity] = timeline.timestampAt(i);
+        sample.present.set(quantity);
+    }
+    sample.ending = computed.getEnding();
+    return sample;
+}
+
+std::pair<double, double> EnsembleStatistics::linearRange(size_t quantity) {
+    // Parameters use the UniverseValidator ranges, milestone times 0-100 Gyr
+    switch (quantity) {
+        case 0: return {0.1, 2.0};
+        case 1: return {0.0, 1.0};
+        case 2: return {50.0, 80.0};
+        case 3: return {0.0, 1e-7};
+        case 4: return {-2.0, -0.5};
+        default: return {0.0, 100.0};
+    }
+}
+
+void EnsembleStatistics::Accumulator::add(size_t quantity, double value) {
+    if (count == 0) {
+        min = max = value;
+        minCount = maxCount = 1;
+    } else {
+        if (value < min) {
+            min = value;
+            minCount = 1;
+        } else if (value == min) {
+            ++minCount;
+        }
+        if (value > max) {
+            max = value;
+            maxCount = 1;
+        } else if (value == max) {
+            ++maxCount;
+        }
+    }
+    ++count;
+    sum += value;
+
+    bool underflow, overflow;
+    const size_t bin = linearBin(quantity, value, underflow, overflow);
+    if (underflow) {
+        ++linearUnderflow;
+    } else if (overflow) {
+        ++linearOverflow;
+    } else {
+        ++linear[bin];
+    }
+
+    const long logIndex = logBin(value);
+    if (logIndex < 0) {
+        ++logUnderflow;
+    } else if (logIndex >= static_cast<long>(kLogBins)) {
+        ++logOverflow;
+    } else {
+        ++log[logIndex];
+    }
+}
+
+bool EnsembleStatistics::Accumulator::remove(size_t quantity, double value) {
+    --count;
+    sum -= value;
+
+    bool underflow, overflow;
+    const size_t bin = linearBin(quantity, value, underflow, overflow);
+    if (underflow) {
+        --linearUnderflow;
+    } else if (overflow) {
+        --linearOverflow;
+    } else {
+        --linear[bin];
+    }
+
+    const long logIndex = logBin(value);
+    if (logIndex < 0) {
+        --logUnderflow;
+    } else if (logIndex >= static_cast<long>(kLogBins)) {
+        --logOverflow;
+    } else {
+        --log[logIndex];
+    }
+
+    if (count == 0) {
+        sum = min = max = 0.0;
+        minCount = maxCount = 0;
+        return true;
+    }
+    if (value == min) {
+        --minCount;
+    }
+    if (value == max) {
+        --maxCount;
+    }
+    return minCount > 0 && maxCount > 0;
+}
+
+void EnsembleStatistics::Accumulator::merge(const Accumulator& other) {
+    if (other.count == 0) {
+        return;
+    }
+    if (count == 0 || other.min < min) {
+        min = other.min;
+        minCount = other.minCount;
+    } else if (other.min == min) {
+        minCount += other.minCount;
+    }
+    if (count == 0 || other.max > max) {
+        max = other.max;
+        maxCount = other.maxCount;
+    } else if (other.max == max) {
+        maxCount += other.maxCount;
+    }
+    count += other.count;
+    sum += other.sum;
+    for (size_t i = 0; i < kLinearBins; ++i) {
+        linear[i] += other.linear[i];
+    }
+    linearUnderflow += other.linearUnderflow;
+    linearOverflow += other.linearOverflow;
+    for (size_t i = 0; i < kLogBins; ++i) {
+        log[i] += other.log[i];
+    }
+    logUnderflow += other.logUnderflow;
+    logOverflow += other.logOverflow;
+}
+
+void EnsembleStatistics::addTo(Snapshot& data, const Sample& sample) {
+    ++data.total;
+    ++data.endings[sample.ending ? static_cast<size_t>(*sample.ending) : kMilestoneTypeCount];
+    for (size_t q = 0; q < kQuantities; ++q) {
+        if (sample.present.test(q)) {
+            data.quantities[q].add(q, sample.values[q]);
+        }
+    }
+}
+
+void EnsembleStatistics::add(int id, const Sample& sample) {
+    Shard& shard = shards[shardOf(id)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    addTo(shard.data, sample);
+}
+
+bool EnsembleStatistics::remove(int id, const Sample& sample) {
+    Shard& shard = shards[shardOf(id)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    Snapshot& data = shard.data;
+    --data.total;
+    --data.endings[sample.ending ? static_cast<size_t>(*sample.ending) : kMilestoneTypeCount];
+    bool exact = true;
+    for (size_t q = 0; q < kQuantities; ++q) {
+        if (sample.present.test(q)) {
+            exact = data.quantities[q].remove(q, sample.values[q]) && exact;
+        }
+    }
+    return exact;
+}
+
+void EnsembleStatistics::rebuildShard(size_t index, const std::vector<Sample>& samples) {
+    Snapshot data;
+    for (const Sample& sample : samples) {
+        addTo(data, sample);
+    }
+    Shard& shard = shards[index];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.data = std::move(data);
+}
+
+void EnsembleStatistics::clear() {
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.data = Snapshot();
+    }
+}
+
+EnsembleStatistics::Snapshot EnsembleStatistics::snapshot() const {
+    Snapshot merged;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        merged.total += shard.data.total;
+        for (size_t i = 0; i < merged.endings.size(); ++i) {
+            merged.endings[i] += shard.data.endings[i];
+        }
+        for (size_t q = 0; q < kQuantities; ++q) {
+            merged.quantities[q].merge(shard.data.quantities[q]);
+        }
+    }
+    return merged;
+}
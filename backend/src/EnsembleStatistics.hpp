@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Milestone.hpp"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+class SimulatedUniverse;
+
+// Aggregates over all universes of a database, maintained on every add and
+// remove so that reading them costs O(bins) however many universes there are.
+//
+// Quantities are the five parameters followed by the timestamp of every
+// milestone type (for the universes whose timeline contains it). Each has a
+// count, sum, min and max, a linear histogram over a fixed range and a
+// log10 histogram with kLogBinsPerDecade bins per decade. Universes are
+// spread over kShards independently locked accumulators by id; a snapshot
+// merges them.
+class EnsembleStatistics {
+public:
+    static constexpr size_t kShards = 16;
+    static constexpr size_t kParameterCount = 5;
+    static constexpr size_t kQuantities = kParameterCount + kMilestoneTypeCount;
+    static constexpr size_t kLinearBins = 32;
+    static constexpr int kLogBinsPerDecade = 4;
+    static constexpr int kMinExponent = -60;
+    static constexpr int kMaxExponent = 110;
+    static constexpr size_t kLogBins = (kMaxExponent - kMinExponent) * kLogBinsPerDecade;
+
+    // Values one universe contributes
+    struct Sample {
+        std::array<double, kQuantities> values{};
+        std::bitset<kQuantities> present;
+        std::optional<MilestoneType> ending;
+
+        static Sample of(const SimulatedUniverse& universe);
+    };
+
+    // Mergeable summary of one quantity
+    struct Accumulator {
+        std::uint64_t count = 0;
+        double sum = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        // Values equal to min and to max: a remove leaves those known until
+        // the last of them goes
+        std::uint64_t minCount = 0;
+        std::uint64_t maxCount = 0;
+        std::array<std::uint64_t, kLinearBins> linear{};
+        std::uint64_t linearUnderflow = 0;
+        std::uint64_t linearOverflow = 0;
+        std::vector<std::uint64_t> log = std::vector<std::uint64_t>(kLogBins);
+        std::uint64_t logUnderflow = 0;  // values <= 10^kMinExponent, including zero and negatives
+        std::uint64_t logOverflow = 0;
+
+        void add(size_t quantity, double value);
+        // Returns false when value was the last one at the min or max, which
+        // is then unknown
+        bool remove(size_t quantity, double value);
+        void merge(const Accumulator& other);
+        double mean() const { return count ? sum / count : 0.0; }
+    };
+
+    struct Snapshot {
+        std::uint64_t total = 0;
+        // Index kMilestoneTypeCount counts universes without an ending
+        std::array<std::uint64_t, kMilestoneTypeCount + 1> endings{};
+        std::array<Accumulator, kQuantities> quantities;
+    };
+
+    // Range [low, high) of the linear histogram of a quantity
+    static std::pair<double, double> linearRange(size_t quantity);
+
+    void add(int id, const Sample& sample);
+    // Returns false when a removed value was the last one at a shard's min or
+    // max; the caller then rebuilds that shard with rebuildShard()
+    bool remove(int id, const Sample& sample);
+    void rebuildShard(size_t shard, const std::vector<Sample>& samples);
+    void clear();
+
+    Snapshot snapshot() const;
+
+    static size_t shardOf(int id) { return static_cast<size_t>(id) % kShards; }
+
+private:
+    struct Shard {
+        mutable std::mutex mutex;
+        Snapshot data;
+    };
+
+    static void addTo(Snapshot& data, const Sample& sample);
+
+    std::array<Shard, kShards> shards;
+};
@@ -0,0 +1,155 @@
+#include "ExpansionHistory.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// 1 km/s/Mpc expressed in Gyr⁻¹
+constexpr double kHubbleUnitPerGyr = 1.0227e-3;
+
+constexpr double kFirstScaleFactor = 1e-12;
+constexpr double kLastScaleFactor = 1e3;
+constexpr size_t kIntegrationSteps = 8192;
+
+double interpolationError(const ExpansionSample& left, const ExpansionSample& right,
+                          const ExpansionSample& middle) {
+    auto logMidpoint = [](double a, double b) { return 0.5 * (std::log(a) + std::log(b)); };
+    double error = std::abs(std::log(middle.scaleFactor) - logMidpoint(left.scaleFactor, right.scaleFactor));
+    if (middle.hubble > 0 && left.hubble > 0 && right.hubble > 0) {
+        error = std::max(error, std::abs(std::log(middle.hubble) - logMidpoint(left.hubble, right.hubble)));
+    }
+    error = std::max(error, std::abs(middle.matterFraction - 0.5 * (left.matterFraction + right.matterFraction)));
+    error = std::max(error, std::abs(middle.radiationFraction - 0.5 * (left.radiationFraction + right.radiationFraction)));
+    error = std::max(error, std::abs(middle.darkEnergyFraction - 0.5 * (left.darkEnergyFraction + right.darkEnergyFraction)));
+    return error;
+}
+}
+
+ExpansionHistory::ExpansionHistory(const UniverseParameters& params)
+    : matterDensity(params.getMatterDensity())
+    , darkEnergyDensity(params.getDarkEnergyDensity())
+    , darkEnergyW(params.getDarkEnergyW())
+    , curvatureDensity(1.0 - params.getMatterDensity() - params.getDarkEnergyDensity() - kRadiationDensity)
+    , hubbleConstant(params.getHubbleConstant())
+    , hubbleRate(params.getHubbleConstant() * kHubbleUnitPerGyr)
+{
+    const double first = std::log(kFirstScaleFactor);
+    const double step = (std::log(kLastScaleFactor) - first) / kIntegrationSteps;
+    auto inverseRate = [this](double logA) {
+        return 1.0 / (hubbleRate * std::sqrt(hubbleSquared(std::exp(logA))));
+    };
+
+    logScaleFactors.reserve(kIntegrationSteps + 1);
+    times.reserve(kIntegrationSteps + 1);
+    rates.reserve(kIntegrationSteps + 1);
+
+    // Radiation dominates at a₀: t = a² / (2 H₀ √Ω_r)
+    logScaleFactors.push_back(first);
+    times.push_back(kFirstScaleFactor * kFirstScaleFactor / (2.0 * hubbleRate * std::sqrt(kRadiationDensity)));
+    rates.push_back(hubbleRate * std::sqrt(hubbleSquared(kFirstScaleFactor)));
+
+    for (size_t i = 1; i <= kIntegrationSteps; ++i) {
+        const double logA = first + i * step;
+        if (hubbleSquared(std::exp(logA - 0.5 * step)) <= 0.0 || hubbleSquared(std::exp(logA)) <= 0.0) {
+            break;  // turnaround of a recollapsing universe
+        }
+        // Simpson's rule for dt = d ln a / H
+        const double dt = step / 6.0 * (inverseRate(logA - step) + 4.0 * inverseRate(logA - 0.5 * step) +
+                                         inverseRate(logA));
+        logScaleFactors.push_back(logA);
+        times.push_back(times.back() + dt);
+        rates.push_back(hubbleRate * std::sqrt(hubbleSquared(std::exp(logA))));
+    }
+}
+
+double ExpansionHistory::hubbleSquared(double a) const {
+    return kRadiationDensity / (a * a * a * a) + matterDensity / (a * a * a) + curvatureDensity / (a * a) +
+           darkEnergyDensity * std::pow(a, -3.0 * (1.0 + darkEnergyW));
+}
+
+ExpansionSample ExpansionHistory::sampleAt(double time) const {
+    time = std::clamp(time, times.front(), times.back());
+
+    double logA = logScaleFactors.back();
+    auto upper = std::upper_bound(times.begin(), times.end(), time);
+    if (upper != times.end()) {
+        const size_t i = std::max<size_t>(upper - times.begin(), 1) - 1;
+        const double dt = times[i + 1] - times[i];
+        const double s = (time - times[i]) / dt;
+        // Cubic Hermite basis with slopes d ln a / dt = H
+        const double h00 = (1 + 2 * s) * (1 - s) * (1 - s);
+        const double h10 = s * (1 - s) * (1 - s);
+        const double h01 = s * s * (3 - 2 * s);
+        const double h11 = s * s * (s - 1);
+        logA = h00 * logScaleFactors[i] + h10 * dt * rates[i] +
+               h01 * logScaleFactors[i + 1] + h11 * dt * rates[i + 1];
+    }
+
+    const double a = std::exp(logA);
+    const double e2 = std::max(hubbleSquared(a), 0.0);
+    ExpansionSample sample;
+    sample.time = time;
+    sample.scaleFactor = a;
+    sample.hubble = hubbleConstant * std::sqrt(e2);
+    sample.temperature = kTemperatureToday / a;
+    if (e2 > 0.0) {
+        sample.matterFraction = matterDensity / (a * a * a) / e2;
+        sample.radiationFraction = kRadiationDensity / (a * a * a * a) / e2;
+        sample.darkEnergyFraction = darkEnergyDensity * std::pow(a, -3.0 * (1.0 + darkEnergyW)) / e2;
+    } else {
+        sample.matterFraction = sample.radiationFraction = sample.darkEnergyFraction = 0.0;
+    }
+    return sample;
+}
+
+ExpansionSampler::ExpansionSampler(const UniverseParameters& params, size_t maxSamples, double tolerance)
+    : history(params)
+    , maxSamples(maxSamples)
+    , tolerance(tolerance)
+{}
+
+ExpansionSample ExpansionSampler::sampleAtLog(double logTime) const {
+    return history.sampleAt(std::exp(logTime));
+}
+
+std::vector<ExpansionSample> ExpansionSampler::coarse(size_t points) {
+    points = std::clamp<size_t>(points, 2, std::max<size_t>(maxSamples, 2));
+    const double from = std::log(history.startTime());
+    const double to = std::log(history.endTime());
+
+    std::vector<ExpansionSample> samples;
+    samples.reserve(points);
+    for (size_t i = 0; i < points; ++i) {
+        samples.push_back(sampleAtLog(from + (to - from) * i / (points - 1)));
+    }
+    count = points;
+
+    for (size_t i = 0; i + 1 < points; ++i) {
+        push(std::log(samples[i].time), std::log(samples[i + 1].time), samples[i], samples[i + 1]);
+    }
+    return samples;
+}
+
+std::vector<ExpansionSample> ExpansionSampler::refine(size_t budget) {
+    std::vector<ExpansionSample> added;
+    added.reserve(budget);
+    while (added.size() < budget && !done()) {
+        const Interval worst = intervals.top();
+        intervals.pop();
+
+        added.push_back(worst.middle);
+        ++count;
+        const double middle = 0.5 * (worst.from + worst.to);
+        push(worst.from, middle, worst.left, worst.middle);
+        push(middle, worst.to, worst.middle, worst.right);
+    }
+    return added;
+}
+
+bool ExpansionSampler::done() const {
+    return count >= maxSamples || intervals.empty() || intervals.top().error <= tolerance;
+}
+
+void ExpansionSampler::push(double from, double to, const ExpansionSample& left, const ExpansionSample& right) {
+    const ExpansionSample middle = sampleAtLog(0.5 * (from + to));
+    intervals.push({from, to, left, right, middle, interpolationError(left, right, middle)});
+}
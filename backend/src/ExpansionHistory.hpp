@@ -0,0 +1,90 @@
+#pragma once
+
+#include "UniverseParameters.hpp"
+#include <cstddef>
+#include <queue>
+#include <vector>
+
+// State of the universe at one moment of its expansion
+struct ExpansionSample {
+    double time;                // Gyr since the Big Bang
+    double scaleFactor;         // a, 1 today
+    double hubble;              // H in km/s/Mpc
+    double temperature;         // radiation temperature in K
+    double matterFraction;      // Ω_m(a)
+    double radiationFraction;   // Ω_r(a)
+    double darkEnergyFraction;  // Ω_DE(a)
+};
+
+// Expansion history from the Friedmann equation
+//   H² = H₀² (Ω_r a⁻⁴ + Ω_m a⁻³ + Ω_k a⁻² + Ω_DE a^(-3(1+w)))
+// with a fixed radiation density and Ω_k closing the budget.
+//
+// t(a) is integrated once on a uniform ln a grid; samples invert it with
+// cubic Hermite interpolation (d ln a / dt = H). Only the expanding branch is
+// covered: integration stops at a = 1000 or where H² reaches zero.
+class ExpansionHistory {
+public:
+    static constexpr double kRadiationDensity = 9.1e-5;
+    static constexpr double kTemperatureToday = 2.7255;
+
+    explicit ExpansionHistory(const UniverseParameters& params);
+
+    double startTime() const { return times.front(); }
+    double endTime() const { return times.back(); }
+
+    ExpansionSample sampleAt(double time) const;
+
+private:
+    double hubbleSquared(double scaleFactor) const;  // E², in units of H₀²
+
+    double matterDensity;
+    double darkEnergyDensity;
+    double darkEnergyW;
+    double curvatureDensity;
+    double hubbleConstant;  // km/s/Mpc
+    double hubbleRate;      // H₀ in Gyr⁻¹
+
+    std::vector<double> logScaleFactors;
+    std::vector<double> times;
+    std::vector<double> rates;  // H in Gyr⁻¹ at each node
+};
+
+// Progressive sampling of an expansion history on a log-time grid.
+//
+// coarse() returns an evenly spaced first curve. Each refine() call then adds
+// up to `budget` samples at the midpoints of the intervals whose linear
+// interpolation (in ln a, ln H and the density fractions) is worst, so a
+// plot sharpens where it matters first. Sampling ends once every interval is
+// within tolerance or maxSamples is reached.
+class ExpansionSampler {
+public:
+    ExpansionSampler(const UniverseParameters& params, size_t maxSamples, double tolerance = 1e-3);
+
+    std::vector<ExpansionSample> coarse(size_t count);
+    std::vector<ExpansionSample> refine(size_t budget);
+
+    bool done() const;
+    size_t sampleCount() const { return count; }
+
+private:
+    struct Interval {
+        double from;  // ln t
+        double to;
+        ExpansionSample left;
+        ExpansionSample right;
+        ExpansionSample middle;
+        double error;
+
+        bool operator<(const Interval& other) const { return error < other.error; }
+    };
+
+    ExpansionSample sampleAtLog(double logTime) const;
+    void push(double from, double to, const ExpansionSample& left, const ExpansionSample& right);
+
+    ExpansionHistory history;
+    size_t maxSamples;
+    double tolerance;
+    size_t count = 0;
+    std::priority_queue<Interval> intervals;
+};
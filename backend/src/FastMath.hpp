@@ -0,0 +1,115 @@
+#pragma once
+
+#include "ConstexprMath.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+// Cheaper x^p for the fixed fractional exponents of the milestone formulas
+// (0.25, -0.3, -0.2, 0.15, 0.1, -0.5). Quarter and half powers are square
+// roots; the rest go through 2^(p log2 x) with 64-entry tables, short
+// polynomials and the exponent bits doing the range reduction. About twice
+// as fast as std::pow; the relative error is below 1e-10 for positive
+// normal x and |p| < 0.97 (FastMathTests.cpp samples every binade); other
+// arguments take std::pow.
+namespace FastMath {
+
+inline std::uint64_t bitsOf(double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof bits);
+    return bits;
+}
+
+inline double fromBits(std::uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof x);
+    return x;
+}
+
+// Tables of the table-driven log2 and exp2 below, built by the compiler:
+// for the 64 intervals [1 + i/64, 1 + (i+1)/64) the reciprocal and log2 of
+// their midpoint, and 2^(i/64)
+struct Tables {
+    double inverse[64] = {};
+    double log2[64] = {};
+    double exp2[64] = {};
+};
+
+constexpr Tables makeTables() {
+    Tables tables;
+    for (int i = 0; i < 64; ++i) {
+        tables.inverse[i] = 1.0 / (1.0 + (i + 0.5) / 64.0);
+        // log2 of exactly 1 / inverse[i], so m * inverse[i] - 1 is the reduced argument
+        tables.log2[i] = -ConstexprMath::log(tables.inverse[i]) / ConstexprMath::kLn2;
+        tables.exp2[i] = ConstexprMath::exp(i / 64.0 * ConstexprMath::kLn2);
+    }
+    return tables;
+}
+
+inline constexpr Tables kTables = makeTables();
+
+// log2 x for positive normal x: x = m 2^e with m in [1, 2), m = c (1 + r)
+// for the tabled c nearest m, |r| < 1/128, and log2 (1 + r) from its
+// series to degree 4 (truncation error below 1e-11)
+inline double log2(double x) {
+    const std::uint64_t bits = bitsOf(x);
+    const int e = static_cast<int>(bits >> 52) - 1023;
+    const int i = static_cast<int>((bits >> 46) & 63);
+    const double m = fromBits((bits & 0x000fffffffffffffull) | 0x3ff0000000000000ull);
+    const double r = m * kTables.inverse[i] - 1.0;
+    // 1 / (k ln 2) with alternating signs
+    constexpr double c1 = 1.4426950408889634, c2 = -0.7213475204444817, c3 = 0.4808983469629878,
+                     c4 = -0.36067376022224085;
+    return (e + kTables.log2[i]) + r * (c1 + r * (c2 + r * (c3 + r * c4)));
+}
+
+// 2^y for |y| < 1022: y = k/64 + r with |r| <= 1/128, 2^r from its Taylor
+// series to degree 3 (truncation error below 4e-11), 2^(k/64) from the
+// table with floor(k/64) added to its exponent
+inline double exp2(double y) {
+    constexpr double kShift = 6755399441055744.0 / 64.0;  // rounds to a multiple of 1/64
+    const double rounded = (y + kShift) - kShift;
+    const double t = (y - rounded) * 0.6931471805599453;
+    const double p = 1.0 + t * (1.0 + t * (0.5 + t * (1.0 / 6)));
+    const auto k = static_cast<std::int64_t>(rounded * 64.0);  // exact
+    const std::uint64_t scaled = bitsOf(kTables.exp2[k & 63]) + (static_cast<std::uint64_t>(k >> 6) << 52);
+    return p * fromBits(scaled);
+}
+
+inline double pow(double x, double p) {
+    // Positive normal x, and |p log2 x| < 1000 for |p| < 0.97
+    const bool normal = bitsOf(x) - 0x0010000000000000ull < 0x7fe0000000000000ull;
+    if (!normal || !(std::abs(p) < 0.97)) return std::pow(x, p);
+    if (p == 0.5) return std::sqrt(x);
+    if (p == 0.25) return std::sqrt(std::sqrt(x));
+    if (p == -0.5) return 1.0 / std::sqrt(x);
+    return exp2(p * log2(x));
+}
+
+// Scalar for evaluating the MilestoneFormulas templates with the functions
+// above: arithmetic of a double, pow and sqrt found by argument-dependent
+// lookup (as for Dual and ConstexprMath::Real)
+struct Fast {
+    double value = 0.0;
+
+    Fast() = default;
+    Fast(double value) : value(value) {}
+
+    friend Fast operator+(Fast a, Fast b) { return a.value + b.value; }
+    friend Fast operator-(Fast a, Fast b) { return a.value - b.value; }
+    friend Fast operator*(Fast a, Fast b) { return a.value * b.value; }
+    friend Fast operator/(Fast a, Fast b) { return a.value / b.value; }
+    friend Fast operator-(Fast a) { return -a.value; }
+
+    friend bool operator<(Fast a, Fast b) { return a.value < b.value; }
+    friend bool operator>(Fast a, Fast b) { return a.value > b.value; }
+    friend bool operator<=(Fast a, Fast b) { return a.value <= b.value; }
+    friend bool operator>=(Fast a, Fast b) { return a.value >= b.value; }
+    friend bool operator==(Fast a, Fast b) { return a.value == b.value; }
+    friend bool operator!=(Fast a, Fast b) { return a.value != b.value; }
+
+    friend Fast pow(Fast x, double p) { return FastMath::pow(x.value, p); }
+    friend Fast sqrt(Fast x) { return std::sqrt(x.value); }
+};
+
+} // namespace FastMath
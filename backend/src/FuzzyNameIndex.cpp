@@ -0,0 +1,280 @@
+#include "FuzzyNameIndex.hpp"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <mutex>
+#include <string>
+
+static std::string lowered(std::string_view text) {
+    std::string result(text);
+    for (char& c : result) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return result;
+}
+
+// Signature bit of the bigram ab
+static unsigned bigramBit(unsigned char a, unsigned char b) {
+    return ((a * 0x9E3779B1u) ^ (b * 0x85EBCA6Bu)) >> 26;
+}
+
+// Posting list index of the bigram ab
+static unsigned bigramKey(unsigned char a, unsigned char b) {
+    return a << 8 | b;
+}
+
+namespace {
+
+// Query term prepared for repeated matching
+class Matcher {
+public:
+    explicit Matcher(std::string_view pattern)
+        : pattern(pattern)
+    {
+        if (pattern.size() <= 64) {
+            for (size_t i = 0; i < pattern.size(); ++i) {
+                peq[static_cast<unsigned char>(pattern[i])] |= std::uint64_t{1} << i;
+            }
+        }
+    }
+
+    // Edits to the closest substring of text, capped at maxDistance + 1
+    int distance(std::string_view text, int maxDistance) const {
+        const size_t m = pattern.size();
+        if (m == 0) {
+            return 0;
+        }
+        return m <= 64 ? myers(text, maxDistance) : sellers(text, maxDistance);
+    }
+
+private:
+    // Myers (1999) in search mode: a text match may start anywhere, so the
+    // horizontal delta entering row 0 is zero and Ph gets no carry-in bit
+    int myers(std::string_view text, int maxDistance) const {
+        const size_t m = pattern.size();
+        const std::uint64_t last = std::uint64_t{1} << (m - 1);
+        std::uint64_t pv = ~std::uint64_t{0};
+        std::uint64_t mv = 0;
+        int score = static_cast<int>(m);
+        int best = score;
+        for (size_t j = 0; j < text.size(); ++j) {
+            const std::uint64_t eq = peq[static_cast<unsigned char>(text[j])];
+            const std::uint64_t xv = eq | mv;
+            const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            std::uint64_t ph = mv | ~(xh | pv);
+            std::uint64_t mh = pv & xh;
+            if (ph & last) {
+                ++score;
+            } else if (mh & last) {
+                --score;
+            }
+            ph <<= 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+            best = std::min(best, score);
+            // The score drops by at most one per remaining character
+            if (best == 0 || score - static_cast<int>(text.size() - j - 1) > maxDistance) {
+                break;
+            }
+        }
+        return std::min(best, maxDistance + 1);
+    }
+
+    // Sellers' dynamic program, for terms longer than one machine word
+    int sellers(std::string_view text, int maxDistance) const {
+        const size_t m = pattern.size();
+        std::vector<int> column(m + 1);
+        for (size_t i = 0; i <= m; ++i) {
+            column[i] = static_cast<int>(i);
+        }
+        int best = column[m];
+        for (char c : text) {
+            int diagonal = column[0];  // row 0 stays 0: matches start anywhere
+            for (size_t i = 1; i <= m; ++i) {
+                const int above = column[i];
+                column[i] = std::min({above + 1, column[i - 1] + 1, diagonal + (pattern[i - 1] != c)});
+                diagonal = above;
+            }
+            best = std::min(best, column[m]);
+        }
+        return std::min(best, maxDistance + 1);
+    }
+
+    std::string_view pattern;
+    std::array<std::uint64_t, 256> peq{};
+};
+
+// The best `limit` matches of names visited in increasing id order
+class BestMatches {
+public:
+    BestMatches(size_t limit, int maxDistance)
+        : limit(limit)
+        , maxDistance(maxDistance)
+    {}
+
+    // Largest distance a later name can have and still be kept; -1 once
+    // `limit` exact matches are known
+    int bound() const {
+        return heap.size() < limit ? maxDistance : heap.front().distance - 1;
+    }
+
+    void add(FuzzyNameIndex::Match match) {
+        heap.push_back(match);
+        std::push_heap(heap.begin(), heap.end(), better);
+        if (heap.size() > limit) {
+            std::pop_heap(heap.begin(), heap.end(), better);
+            heap.pop_back();
+        }
+    }
+
+    std::vector<FuzzyNameIndex::Match> sorted() && {
+        std::sort_heap(heap.begin(), heap.end(), better);
+        return std::move(heap);
+    }
+
+private:
+    static bool better(const FuzzyNameIndex::Match& a, const FuzzyNameIndex::Match& b) {
+        return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+    }
+
+    size_t limit;
+    int maxDistance;
+    std::vector<FuzzyNameIndex::Match> heap;  // worst on top
+};
+
+} // namespace
+
+std::uint64_t FuzzyNameIndex::signatureOf(std::string_view lowered) {
+    std::uint64_t signature = 0;
+    for (size_t i = 1; i < lowered.size(); ++i) {
+        signature |= std::uint64_t{1} << bigramBit(lowered[i - 1], lowered[i]);
+    }
+    return signature;
+}
+
+void FuzzyNameIndex::insert(int id, std::string_view name) {
+    // Longer names are indexed by their prefix rather than rejected
+    const std::string lower = lowered(name.substr(0, StringArena::kMaxLength));
+    std::vector<unsigned> keys;
+    for (size_t i = 1; i < lower.size(); ++i) {
+        keys.push_back(bigramKey(lower[i - 1], lower[i]));
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (id >= static_cast<int>(entries.size())) {
+        entries.resize(id + 1);
+    }
+    Entry& entry = entries[id];
+    live += !entry.live;
+    entry.signature = signatureOf(lower);
+    entry.name = names.append(lower);
+    entry.live = true;
+    if (postings.empty()) {
+        postings.resize(1 << 16);
+    }
+    for (unsigned key : keys) {
+        postings[key].push_back(static_cast<std::uint32_t>(id));
+    }
+}
+
+void FuzzyNameIndex::remove(int id) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (id >= 0 && id < static_cast<int>(entries.size()) && entries[id].live) {
+        entries[id].live = false;
+        --live;
+    }
+}
+
+size_t FuzzyNameIndex::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return live;
+}
+
+int FuzzyNameIndex::distance(std::string_view pattern, std::string_view text, int maxDistance) {
+    return Matcher(pattern).distance(text, maxDistance);
+}
+
+std::vector<FuzzyNameIndex::Match> FuzzyNameIndex::search(std::string_view term, int maxDistance,
+                                                          size_t limit) const {
+    const int k = std::clamp(maxDistance, 0, kMaxDistance);
+    const std::string pattern = lowered(term);
+    const Matcher matcher(pattern);
+    if (limit == 0) {
+        return {};
+    }
+
+    // The term's bigrams, and how often each occurs in it
+    std::vector<unsigned> keys;
+    std::array<int, 64> occurrences{};  // per signature bit
+    std::uint64_t patternBits = 0;
+    for (size_t i = 1; i < pattern.size(); ++i) {
+        keys.push_back(bigramKey(pattern[i - 1], pattern[i]));
+        const unsigned bit = bigramBit(pattern[i - 1], pattern[i]);
+        ++occurrences[bit];
+        patternBits |= std::uint64_t{1} << bit;
+    }
+    std::sort(keys.begin(), keys.end());
+    // A match shares at least this many of the term's bigrams
+    const int required = static_cast<int>(keys.size()) - 2 * k;
+    const int lostBudget = 2 * k;
+    const size_t minLength = pattern.size() > static_cast<size_t>(k) ? pattern.size() - k : 0;
+
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    BestMatches best(limit, k);
+    auto verify = [&](size_t id) {
+        const Entry& entry = entries[id];
+        if (!entry.live || entry.name.length < minLength) {
+            return;
+        }
+        const int bound = best.bound();
+        const int distance = matcher.distance(names.get(entry.name), bound);
+        if (distance <= bound) {
+            best.add({static_cast<int>(id), distance});
+        }
+    };
+
+    size_t postingCount = 0;
+    if (required > 0 && !postings.empty()) {
+        for (unsigned key : keys) {
+            postingCount += postings[key].size();
+        }
+    }
+    if (required > 0 && postingCount < entries.size()) {
+        // Count shared bigrams per name, saturating at 255
+        const int threshold = std::min(required, 255);
+        std::vector<std::uint8_t> shared(entries.size());
+        for (size_t i = 0; i < keys.size();) {
+            const unsigned key = keys[i];
+            int count = 0;
+            for (; i < keys.size() && keys[i] == key; ++i) {
+                ++count;
+            }
+            for (std::uint32_t id : postings[key]) {
+                shared[id] = static_cast<std::uint8_t>(std::min(255, shared[id] + count));
+            }
+        }
+        for (size_t id = 0; id < entries.size() && best.bound() >= 0; ++id) {
+            if (shared[id] >= threshold) {
+                verify(id);
+            }
+        }
+    } else {
+        // A name lacking the signature bits of more than 2k of the term's
+        // bigrams is rejected unverified
+        for (size_t id = 0; id < entries.size() && best.bound() >= 0; ++id) {
+            std::uint64_t absent = patternBits & ~entries[id].signature;
+            int lost = 0;
+            while (absent && lost <= lostBudget) {
+                lost += occurrences[__builtin_ctzll(absent)];
+                absent &= absent - 1;
+            }
+            if (lost <= lostBudget) {
+                verify(id);
+            }
+        }
+    }
+    return std::move(best).sorted();
+}
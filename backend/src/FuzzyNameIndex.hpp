@@ -0,0 +1,67 @@
+#pragma once
+
+#include "StringArena.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+// Typo-tolerant name search: finds the names that contain a term with at
+// most k edits (insertions, deletions, substitutions), ignoring ASCII case,
+// so "phantm" finds "Phantom Rip".
+//
+// Names are kept lowercased in a StringArena, with a posting list of ids
+// per bigram and a 64-bit signature of their bigrams. A query relies on the
+// q-gram lemma: every edit destroys at most two of the term's bigrams, so a
+// name sharing fewer than (bigrams - 2k) of them cannot match. When the
+// term's posting lists are short, it counts shared bigrams through them and
+// verifies only the names that reach that bound; otherwise (common bigrams,
+// or terms too short for the bound) it scans all names with the signature
+// as a coarser filter. Candidates are verified in id order with Myers'
+// bit-parallel approximate matching, one word of state for terms up to 64
+// bytes; once `limit` matches are known, later names must beat the worst of
+// them, which tightens the distance bound and ends the scan at 0.
+//
+// Searches share a lock and insert/remove take it exclusively, so callers
+// need no lock of their own to search.
+class FuzzyNameIndex {
+public:
+    static constexpr int kMaxDistance = 8;
+
+    struct Match {
+        int id;
+        int distance;  // edits between the term and the closest substring
+    };
+
+    // Add or replace the name of id
+    void insert(int id, std::string_view name);
+    void remove(int id);
+
+    // Matches within maxDistance (clamped to kMaxDistance), best first and
+    // by id among equals, at most limit of them
+    std::vector<Match> search(std::string_view term, int maxDistance, size_t limit) const;
+
+    // Fewest edits that turn pattern into some substring of text, or
+    // maxDistance + 1 when that is more than maxDistance. Case-sensitive.
+    static int distance(std::string_view pattern, std::string_view text, int maxDistance);
+
+    size_t size() const;
+
+private:
+    struct Entry {
+        std::uint64_t signature = 0;  // bit per hashed bigram present
+        StringArena::Ref name;
+        bool live = false;
+    };
+
+    static std::uint64_t signatureOf(std::string_view lowered);
+
+    mutable std::shared_mutex mutex;
+    std::vector<Entry> entries;  // indexed by id
+    StringArena names;           // lowercased; renames append, nothing is freed
+    // Ids per bigram (first byte << 8 | second). Renames and removals leave
+    // their old postings behind; they only add candidates that fail to verify.
+    std::vector<std::vector<std::uint32_t>> postings;
+    size_t live = 0;
+};
@@ -0,0 +1,281 @@
+#include "InverseSolver.hpp"
+#include "MilestoneFormulas.hpp"
+#include "ParallelFor.hpp"
+#include "SimulatedUniverse.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+namespace {
+// Error for a target milestone that does not occur, in units of ln(time)
+constexpr double kMissingError = 10.0;
+// Cost added when the universe ends differently than requested
+constexpr double kEndingPenalty = 1.0;
+// Half-width of the flatness band, just inside the validator's 0.1
+constexpr double kFlatnessSlack = 0.1 - 1e-9;
+// Errors closer than this are treated as equal when comparing candidates
+constexpr double kErrorEpsilon = 1e-6;
+// Edge length of the initial simplex
+constexpr double kSimplexStep = 0.05;
+
+void clampToCube(InverseSolver::Point& point) {
+    for (double& u : point) {
+        u = std::clamp(u, 0.0, 1.0);
+    }
+}
+
+bool dominates(const std::vector<double>& a, const std::vector<double>& b) {
+    bool better = false;
+    for (size_t k = 0; k < a.size(); ++k) {
+        if (a[k] > b[k] + kErrorEpsilon) return false;
+        if (a[k] < b[k] - kErrorEpsilon) better = true;
+    }
+    return better;
+}
+}
+
+InverseSolver::InverseSolver(Problem problem)
+    : problem(std::move(problem))
+{}
+
+UniverseParameters InverseSolver::toParameters(const Point& point) {
+    Point u = point;
+    clampToCube(u);
+
+    double matterDensity = 0.1 + 1.9 * u[0];
+    double darkEnergyDensity = u[1];
+    const double hubbleConstant = 50.0 + 30.0 * u[2];
+    const double matterAntimatterRatio = std::pow(10.0, -11.0 + 4.0 * u[3]);
+    const double darkEnergyW = -2.0 + 1.5 * u[4];
+
+    // Split any flatness violation evenly between the two densities, then
+    // let the other density absorb what a bound cuts off
+    const double total = matterDensity + darkEnergyDensity;
+    const double excess = total > 1.0 + kFlatnessSlack ? total - (1.0 + kFlatnessSlack)
+                        : total < 1.0 - kFlatnessSlack ? total - (1.0 - kFlatnessSlack)
+                        : 0.0;
+    if (excess != 0.0) {
+        matterDensity -= excess / 2.0;
+        darkEnergyDensity -= excess / 2.0;
+        if (darkEnergyDensity < 0.0) {
+            matterDensity += darkEnergyDensity;
+            darkEnergyDensity = 0.0;
+        } else if (darkEnergyDensity > 1.0) {
+            matterDensity += darkEnergyDensity - 1.0;
+            darkEnergyDensity = 1.0;
+        }
+        if (matterDensity < 0.1) {
+            darkEnergyDensity -= 0.1 - matterDensity;
+            matterDensity = 0.1;
+        }
+    }
+
+    return UniverseParameters(matterDensity, darkEnergyDensity, hubbleConstant,
+                              matterAntimatterRatio, darkEnergyW);
+}
+
+std::vector<double> InverseSolver::errors(const Point& point) const {
+    const UniverseParameters params = toParameters(point);
+    const MilestoneSequence types = SimulatedUniverse::milestoneTypes(params);
+    const auto scalars = MilestoneFormulas::fromUniverseParameters(params);
+
+    std::vector<double> result;
+    result.reserve(problem.targets.size() + 1);
+    for (const auto& target : problem.targets) {
+        const bool occurs = std::find(types.begin(), types.end(), target.type) != types.end();
+        const double time = occurs ? MilestoneFormulas::timestamp(target.type, scalars) : -1.0;
+        result.push_back(time > 0.0 ? std::abs(std::log(time / target.time)) : kMissingError);
+    }
+    if (problem.ending) {
+        result.push_back(SimulatedUniverse::ending(params) == problem.ending ? 0.0 : 1.0);
+    }
+    return result;
+}
+
+double InverseSolver::cost(const Point& point) const {
+    const std::vector<double> error = errors(point);
+    double total = 0.0;
+    for (size_t i = 0; i < problem.targets.size(); ++i) {
+        total += problem.targets[i].weight * error[i] * error[i];
+    }
+    if (problem.ending) {
+        total += kEndingPenalty * error.back();
+    }
+    return total;
+}
+
+InverseSolver::LocalResult InverseSolver::minimize(Point start, const Options& options,
+                                                   std::chrono::steady_clock::time_point deadline,
+                                                   size_t& evaluations) const {
+    constexpr size_t kVertices = kDimensions + 1;
+    std::array<Point, kVertices> simplex;
+    std::array<double, kVertices> values;
+
+    auto evaluate = [&](Point& point) {
+        clampToCube(point);
+        ++evaluations;
+        return cost(point);
+    };
+
+    simplex[0] = start;
+    for (size_t i = 0; i < kDimensions; ++i) {
+        simplex[i + 1] = start;
+        simplex[i + 1][i] += start[i] + kSimplexStep <= 1.0 ? kSimplexStep : -kSimplexStep;
+    }
+    for (size_t i = 0; i < kVertices; ++i) {
+        values[i] = evaluate(simplex[i]);
+    }
+
+    std::array<size_t, kVertices> order;
+    for (size_t iteration = 0; iteration < options.maxIterations; ++iteration) {
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return values[a] < values[b]; });
+        const size_t best = order.front();
+        const size_t worst = order.back();
+        const size_t secondWorst = order[kVertices - 2];
+
+        if (values[best] <= options.tolerance ||
+            values[worst] - values[best] <= 1e-12 * (1.0 + values[best]) ||
+            std::chrono::steady_clock::now() >= deadline) {
+            break;
+        }
+
+        Point centroid{};
+        for (size_t i = 0; i < kVertices; ++i) {
+            if (i == worst) continue;
+            for (size_t d = 0; d < kDimensions; ++d) {
+                centroid[d] += simplex[i][d] / kDimensions;
+            }
+        }
+        auto along = [&](double factor) {
+            Point point;
+            for (size_t d = 0; d < kDimensions; ++d) {
+                point[d] = centroid[d] + factor * (simplex[worst][d] - centroid[d]);
+            }
+            return point;
+        };
+
+        Point reflected = along(-1.0);
+        const double reflectedValue = evaluate(reflected);
+        if (reflectedValue < values[best]) {
+            Point expanded = along(-2.0);
+            const double expandedValue = evaluate(expanded);
+            if (expandedValue < reflectedValue) {
+                simplex[worst] = expanded;
+                values[worst] = expandedValue;
+            } else {
+                simplex[worst] = reflected;
+                values[worst] = reflectedValue;
+            }
+            continue;
+        }
+        if (reflectedValue < values[secondWorst]) {
+            simplex[worst] = reflected;
+            values[worst] = reflectedValue;
+            continue;
+        }
+
+        Point contracted = reflectedValue < values[worst] ? along(-0.5) : along(0.5);
+        const double contractedValue = evaluate(contracted);
+        if (contractedValue < std::min(reflectedValue, values[worst])) {
+            simplex[worst] = contracted;
+            values[worst] = contractedValue;
+            continue;
+        }
+
+        // Shrink towards the best vertex
+        for (size_t i = 0; i < kVertices; ++i) {
+            if (i == best) continue;
+            for (size_t d = 0; d < kDimensions; ++d) {
+                simplex[i][d] = simplex[best][d] + 0.5 * (simplex[i][d] - simplex[best][d]);
+            }
+            values[i] = evaluate(simplex[i]);
+        }
+    }
+
+    const size_t best = std::min_element(values.begin(), values.end()) - values.begin();
+    return {simplex[best], values[best], true};
+}
+
+InverseSolver::Result InverseSolver::solve(const Options& options) const {
+    const auto deadline = std::chrono::steady_clock::now() + options.budget;
+    const size_t starts = std::max<size_t>(options.starts, 1);
+
+    // Latin hypercube seeds: one sample per stratum along every axis
+    std::mt19937_64 random(options.seed);
+    std::uniform_real_distribution<double> jitter(0.0, 1.0);
+    std::vector<Point> seeds(starts);
+    std::vector<size_t> strata(starts);
+    for (size_t d = 0; d < kDimensions; ++d) {
+        std::iota(strata.begin(), strata.end(), size_t{0});
+        std::shuffle(strata.begin(), strata.end(), random);
+        for (size_t i = 0; i < starts; ++i) {
+            seeds[i][d] = (strata[i] + jitter(random)) / starts;
+        }
+    }
+
+    std::vector<LocalResult> local(starts);
+    std::atomic<size_t> evaluations{0};
+    std::atomic<size_t> hits{0};
+    std::atomic<bool> timedOut{false};
+    parallelFor(starts, 4, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                timedOut = true;
+                return;
+            }
+            if (hits >= options.maxCandidates) {
+                return;
+            }
+            size_t count = 0;
+            local[i] = minimize(seeds[i], options, deadline, count);
+            evaluations += count;
+            if (local[i].cost <= options.tolerance) {
+                ++hits;
+            }
+        }
+    });
+
+    Result result;
+    result.evaluations = evaluations;
+    result.timedOut = timedOut || std::chrono::steady_clock::now() >= deadline;
+
+    std::vector<Candidate> pool;
+    std::vector<Point> points;
+    for (const auto& run : local) {
+        if (!run.ran) continue;
+        ++result.startsRun;
+        result.converged = result.converged || run.cost <= options.tolerance;
+        pool.push_back({toParameters(run.point), errors(run.point), run.cost});
+        points.push_back(run.point);
+    }
+
+    // Keep the non-dominated candidates, lowest cost first, dropping starts
+    // that converged onto the same point
+    std::vector<size_t> byCost(pool.size());
+    std::iota(byCost.begin(), byCost.end(), size_t{0});
+    std::sort(byCost.begin(), byCost.end(), [&](size_t a, size_t b) { return pool[a].cost < pool[b].cost; });
+    std::vector<size_t> kept;
+    for (size_t i : byCost) {
+        const bool dominated = std::any_of(pool.begin(), pool.end(), [&](const Candidate& other) {
+            return dominates(other.errors, pool[i].errors);
+        });
+        const bool duplicate = std::any_of(kept.begin(), kept.end(), [&](size_t k) {
+            double distance = 0.0;
+            for (size_t d = 0; d < kDimensions; ++d) {
+                distance = std::max(distance, std::abs(points[k][d] - points[i][d]));
+            }
+            return distance < 1e-4;
+        });
+        if (!dominated && !duplicate) {
+            kept.push_back(i);
+            if (kept.size() == options.maxCandidates) break;
+        }
+    }
+    for (size_t i : kept) {
+        result.candidates.push_back(std::move(pool[i]));
+    }
+    return result;
+}
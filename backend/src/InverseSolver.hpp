@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Milestone.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Inverse design: find universe parameters whose milestones happen at
+// requested times.
+//
+// The search runs in the unit cube, one axis per parameter scaled to the
+// UniverseValidator ranges (the matter/antimatter ratio on a log scale).
+// Every point is projected onto the validator's flatness band before it is
+// evaluated, so all candidates are valid universes. Starts are seeded by
+// Latin hypercube sampling and refined by Nelder-Mead in parallel; each
+// start stops when its simplex has converged, and the whole solve stops at
+// the deadline or once enough starts have hit the targets.
+class InverseSolver {
+public:
+    static constexpr size_t kDimensions = 5;
+    using Point = std::array<double, kDimensions>;
+
+    struct Target {
+        MilestoneType type;
+        double time;          // Gyr
+        double weight = 1.0;
+    };
+
+    struct Problem {
+        std::vector<Target> targets;
+        std::optional<MilestoneType> ending;  // BigRip, HeatDeath or BigCrunch
+    };
+
+    struct Options {
+        size_t starts = 64;
+        std::chrono::milliseconds budget{100};
+        size_t maxIterations = 400;
+        size_t maxCandidates = 8;
+        double tolerance = 1e-8;  // cost at which a start counts as a hit
+        std::uint64_t seed = 1;
+    };
+
+    struct Candidate {
+        UniverseParameters parameters;
+        // Per objective: |ln(t / target)| for every target, followed by
+        // 0 or 1 for the ending when one was requested
+        std::vector<double> errors;
+        double cost;
+    };
+
+    struct Result {
+        // Pareto-optimal candidates over the objective errors, lowest cost first
+        std::vector<Candidate> candidates;
+        size_t startsRun = 0;
+        size_t evaluations = 0;
+        bool converged = false;  // a start hit every target within tolerance
+        bool timedOut = false;
+    };
+
+    explicit InverseSolver(Problem problem);
+
+    Result solve(const Options& options) const;
+
+    // Weighted sum of squared errors plus the ending penalty
+    double cost(const Point& point) const;
+    std::vector<double> errors(const Point& point) const;
+
+    // Validator-feasible parameters for a point of the unit cube
+    static UniverseParameters toParameters(const Point& point);
+
+private:
+    struct LocalResult {
+        Point point;
+        double cost;
+        bool ran = false;
+    };
+
+    LocalResult minimize(Point start, const Options& options,
+                         std::chrono::steady_clock::time_point deadline, size_t& evaluations) const;
+
+    Problem problem;
+};
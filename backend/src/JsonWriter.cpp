@@ -0,0 +1,215 @@
+#include "JsonWriter.hpp"
+#include <charconv>
+#include <cmath>
+
+JsonWriter::JsonWriter(int indent, std::pmr::memory_resource* resource)
+    : out(resource)
+    , indent(indent)
+    , scopes(resource)
+{
+    scopes.reserve(8);
+}
+
+void JsonWriter::beginObject() {
+    beginScope('{');
+}
+
+void JsonWriter::endObject() {
+    endScope('}');
+}
+
+void JsonWriter::beginArray() {
+    beginScope('[');
+}
+
+void JsonWriter::endArray() {
+    endScope(']');
+}
+
+void JsonWriter::key(JsonKey key) {
+    beginValue();
+    out.append(key.quoted);
+    out.append(indent >= 0 ? ": " : ":");
+    pendingKey = true;
+}
+
+void JsonWriter::key(std::string_view key) {
+    beginValue();
+    out.push_back('"');
+    appendEscaped(out, key);
+    out.append(indent >= 0 ? "\": " : "\":");
+    pendingKey = true;
+}
+
+void JsonWriter::value(double number) {
+    beginValue();
+    appendDouble(out, number);
+}
+
+void JsonWriter::value(std::int64_t number) {
+    beginValue();
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), number);
+    out.append(buffer, result.ptr);
+}
+
+void JsonWriter::value(std::string_view text) {
+    beginValue();
+    out.push_back('"');
+    appendEscaped(out, text);
+    out.push_back('"');
+}
+
+void JsonWriter::boolean(bool flag) {
+    beginValue();
+    out.append(flag ? "true" : "false");
+}
+
+void JsonWriter::null() {
+    beginValue();
+    out.append("null");
+}
+
+void JsonWriter::beginValue() {
+    if (pendingKey) {
+        // Separator was already written together with the key
+        pendingKey = false;
+        return;
+    }
+    if (scopes.empty()) {
+        return;
+    }
+    if (!scopes.back().empty) {
+        out.push_back(',');
+    }
+    scopes.back().empty = false;
+    if (indent >= 0) {
+        newline(scopes.size());
+    }
+}
+
+void JsonWriter::beginScope(char open) {
+    beginValue();
+    out.push_back(open);
+    scopes.push_back({true});
+}
+
+void JsonWriter::endScope(char close) {
+    const bool empty = scopes.back().empty;
+    scopes.pop_back();
+    // Empty containers stay on one line ("[]" / "{}"), as nlohmann prints them
+    if (!empty && indent >= 0) {
+        newline(scopes.size());
+    }
+    out.push_back(close);
+}
+
+void JsonWriter::newline(size_t depth) {
+    out.push_back('\n');
+    out.append(depth * static_cast<size_t>(indent), ' ');
+}
+
+void JsonWriter::appendDouble(std::pmr::string& out, double number) {
+    // nlohmann prints NaN and infinity as null
+    if (!std::isfinite(number)) {
+        out.append("null");
+        return;
+    }
+    if (std::signbit(number)) {
+        out.push_back('-');
+        number = -number;
+    }
+    if (number == 0.0) {
+        out.append("0.0");
+        return;
+    }
+
+    // Shortest round-trip digits, in the form d[.ddd]e[+-]x
+    char scientific[32];
+    auto result = std::to_chars(scientific, scientific + sizeof(scientific),
+                                number, std::chars_format::scientific);
+
+    char digits[24];
+    int length = 0;
+    const char* p = scientific;
+    for (; p != result.ptr && *p != 'e'; ++p) {
+        if (*p != '.') {
+            digits[length++] = *p;
+        }
+    }
+    ++p;  // skip 'e'
+    const bool negativeExponent = *p == '-';
+    ++p;  // skip sign
+    int exponent = 0;
+    std::from_chars(p, result.ptr, exponent);
+    if (negativeExponent) {
+        exponent = -exponent;
+    }
+
+    // Lay the digits out like nlohmann's format_buffer: fixed notation for
+    // decimal exponents in (-4, 15], exponential notation otherwise
+    constexpr int kMinExp = -4;
+    constexpr int kMaxExp = 15;
+    const int k = length;
+    const int n = exponent + 1;
+
+    if (k <= n && n <= kMaxExp) {
+        out.append(digits, k);
+        out.append(n - k, '0');
+        out.append(".0");
+    } else if (0 < n && n <= kMaxExp) {
+        out.append(digits, n);
+        out.push_back('.');
+        out.append(digits + n, k - n);
+    } else if (kMinExp < n && n <= 0) {
+        out.append("0.");
+        out.append(-n, '0');
+        out.append(digits, k);
+    } else {
+        out.push_back(digits[0]);
+        if (k > 1) {
+            out.push_back('.');
+            out.append(digits + 1, k - 1);
+        }
+        out.push_back('e');
+        int e = n - 1;
+        out.push_back(e < 0 ? '-' : '+');
+        e = std::abs(e);
+        if (e < 10) {
+            out.push_back('0');
+        }
+        char buffer[8];
+        auto written = std::to_chars(buffer, buffer + sizeof(buffer), e);
+        out.append(buffer, written.ptr);
+    }
+}
+
+void JsonWriter::appendEscaped(std::pmr::string& out, std::string_view text) {
+    static constexpr char hex[] = "0123456789abcdef";
+
+    size_t runStart = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const auto ch = static_cast<unsigned char>(text[i]);
+        if (ch >= 0x20 && ch != '"' && ch != '\\') {
+            continue;
+        }
+
+        out.append(text.data() + runStart, i - runStart);
+        runStart = i + 1;
+        switch (ch) {
+            case '"': out.append("\\\""); break;
+            case '\\': out.append("\\\\"); break;
+            case '\b': out.append("\\b"); break;
+            case '\f': out.append("\\f"); break;
+            case '\n': out.append("\\n"); break;
+            case '\r': out.append("\\r"); break;
+            case '\t': out.append("\\t"); break;
+            default: {
+                const char escaped[] = {'\\', 'u', '0', '0', hex[ch >> 4], hex[ch & 0xF]};
+                out.append(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+    out.append(text.data() + runStart, text.size() - runStart);
+}
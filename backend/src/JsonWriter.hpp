@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ResponseWriter.hpp"
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Streaming JSON writer that appends tokens straight into a string buffer.
+// The output is byte-identical to nlohmann::json::dump(indent) as long as the
+// caller emits object keys in sorted order (nlohmann stores objects in a
+// std::map) and strings are valid UTF-8. Doubles use the shortest round-trip
+// digits from std::to_chars; for the rare values where nlohmann's Grisu2
+// emits a longer digit string the text differs but parses to the same double.
+class JsonWriter final : public ResponseWriter {
+public:
+    // indent < 0 produces compact output, like dump() without arguments.
+    // The output buffer is allocated from the given memory resource.
+    explicit JsonWriter(int indent = -1,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    void beginObject() override;
+    void endObject() override;
+    void beginArray() override;
+    void endArray() override;
+
+    void key(JsonKey key) override;
+    void key(std::string_view key) override;
+
+    using ResponseWriter::value;
+    void value(double number) override;
+    void value(std::int64_t number) override;
+    void value(std::string_view text) override;
+    void boolean(bool flag) override;
+    void null() override;
+
+    std::string_view str() const { return out; }
+    // Drop the output so far but stay inside the open scopes, so a long
+    // document can be sent in pieces
+    void clear() { out.clear(); }
+
+    // Formatting helpers shared with other serializers
+    static void appendDouble(std::pmr::string& out, double number);
+    static void appendEscaped(std::pmr::string& out, std::string_view text);
+
+private:
+    void beginValue();
+    void beginScope(char open);
+    void endScope(char close);
+    void newline(size_t depth);
+
+    struct Scope {
+        bool empty;
+    };
+
+    std::pmr::string out;
+    int indent;
+    bool pendingKey = false;
+    std::pmr::vector<Scope> scopes;
+};
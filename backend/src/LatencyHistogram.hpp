@@ -0,0 +1,95 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear histogram of non-negative integers such as latencies in
+// nanoseconds, after HdrHistogram. Values below 128 are counted exactly;
+// above, every power of two is split into 64 buckets, so a reported value
+// is within 1/64 (1.6%) of the recorded one. Recording is O(1) and the
+// whole 64-bit range fits in under 4k counters, so per-thread histograms
+// can be merged cheaply at the end of a run.
+class LatencyHistogram {
+public:
+    static constexpr int kSubBucketBits = 7;
+    static constexpr std::uint64_t kExact = std::uint64_t{1} << kSubBucketBits;
+    static constexpr std::uint64_t kHalf = kExact / 2;
+    static constexpr std::size_t kBuckets = kExact + (64 - kSubBucketBits) * kHalf;
+
+    void record(std::uint64_t value) {
+        ++counts[bucketOf(value)];
+        ++count;
+        sum += static_cast<double>(value);
+        max = std::max(max, value);
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            counts[i] += other.counts[i];
+        }
+        count += other.count;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+
+    std::uint64_t getCount() const { return count; }
+    std::uint64_t getMax() const { return max; }
+    double getMean() const { return count ? sum / static_cast<double>(count) : 0.0; }
+
+    // Upper end of the bucket holding the q-quantile, q in [0, 1]; never
+    // more than the largest recorded value
+    std::uint64_t percentile(double q) const {
+        if (count == 0) {
+            return 0;
+        }
+        const auto rank = std::max<std::uint64_t>(
+            1, static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(count))));
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(highestEquivalent(i), max);
+            }
+        }
+        return max;
+    }
+
+    static std::size_t bucketOf(std::uint64_t value) {
+        if (value < kExact) {
+            return static_cast<std::size_t>(value);
+        }
+        const int shift = highestBit(value) - (kSubBucketBits - 1);
+        return static_cast<std::size_t>(kExact + (shift - 1) * kHalf + ((value >> shift) - kHalf));
+    }
+
+    // Largest value that falls into bucket
+    static std::uint64_t highestEquivalent(std::size_t bucket) {
+        if (bucket < kExact) {
+            return bucket;
+        }
+        const std::size_t shift = (bucket - kExact) / kHalf + 1;
+        const std::uint64_t mantissa = (bucket - kExact) % kHalf + kHalf;
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+private:
+    static int highestBit(std::uint64_t value) {
+#if defined(__GNUC__)
+        return 63 - __builtin_clzll(value);
+#else
+        int bit = 0;
+        while (value >>= 1) {
+            ++bit;
+        }
+        return bit;
+#endif
+    }
+
+    std::array<std::uint64_t, kBuckets> counts{};
+    std::uint64_t count = 0;
+    std::uint64_t max = 0;
+    double sum = 0.0;
+};
@@ -0,0 +1,94 @@
+#include "LatestWinsQueue.hpp"
+#include <thread>
+
+LatestWinsQueue::~LatestWinsQueue() {
+    drain();
+}
+
+std::uint64_t LatestWinsQueue::submit(std::size_t client, Job job) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Client& state = clients[client];
+    const std::uint64_t sequence = ++state.latest;
+    ++stats.submitted;
+    if (state.pending) {
+        ++stats.superseded;
+    }
+    state.pending = std::move(job);
+    state.pendingSequence = sequence;
+    state.released = false;
+    if (!state.running) {
+        state.running = true;
+        if (workers < maxWorkers) {
+            ++workers;
+            std::thread(&LatestWinsQueue::work, this, client).detach();
+        } else {
+            waiting.push_back(client);
+        }
+    }
+    return sequence;
+}
+
+bool LatestWinsQueue::isCurrent(std::size_t client, std::uint64_t sequence) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = clients.find(client);
+    return it != clients.end() && !it->second.released && it->second.latest == sequence;
+}
+
+void LatestWinsQueue::release(std::size_t client) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = clients.find(client);
+    if (it == clients.end()) {
+        return;
+    }
+    Client& state = it->second;
+    if (!state.running) {
+        clients.erase(it);
+        return;
+    }
+    // A worker holds the entry until the client's running job returns
+    if (state.pending) {
+        state.pending = nullptr;
+        ++stats.superseded;
+    }
+    state.released = true;
+}
+
+void LatestWinsQueue::drain() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return workers == 0; });
+}
+
+LatestWinsQueue::Stats LatestWinsQueue::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void LatestWinsQueue::work(std::size_t client) {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        Client& state = clients[client];
+        if (!state.pending) {
+            state.running = false;
+            if (state.released) {
+                clients.erase(client);
+            }
+            if (!waiting.empty()) {
+                client = waiting.front();
+                waiting.pop_front();
+                continue;
+            }
+            if (--workers == 0) {
+                idle.notify_all();
+            }
+            return;
+        }
+        Job job = std::move(state.pending);
+        state.pending = nullptr;
+        const std::uint64_t sequence = state.pendingSequence;
+        ++stats.started;
+
+        lock.unlock();
+        job(sequence);
+        lock.lock();
+    }
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+// Latest-wins scheduling of per-client work such as live previews.
+//
+// submit() queues a job for a client and replaces that client's job if it
+// has not started yet, so a burst of requests runs at most two of them: the
+// one already running and the newest. Jobs of one client run one at a time
+// on a worker thread; at most maxWorkers threads run at once, and clients
+// beyond that wait for a worker to finish its client. Workers exit once no
+// client has anything queued. A running job can poll isCurrent() to drop a
+// result that became stale.
+class LatestWinsQueue {
+public:
+    // Receives the sequence number submit() returned for it; must not throw
+    using Job = std::function<void(std::uint64_t sequence)>;
+
+    struct Stats {
+        std::uint64_t submitted = 0;
+        std::uint64_t started = 0;
+        std::uint64_t superseded = 0;  // replaced before they started
+    };
+
+    explicit LatestWinsQueue(std::size_t maxWorkers = SIZE_MAX) : maxWorkers(maxWorkers) {}
+    LatestWinsQueue(const LatestWinsQueue&) = delete;
+    LatestWinsQueue& operator=(const LatestWinsQueue&) = delete;
+    // Waits for queued and running jobs
+    ~LatestWinsQueue();
+
+    // Sequence numbers increase per client, starting at 1
+    std::uint64_t submit(std::size_t client, Job job);
+    // Whether sequence is still the newest submission of client
+    bool isCurrent(std::size_t client, std::uint64_t sequence) const;
+    // Forget a client that went away: its queued job is dropped, a running
+    // one stops being current, and its entry goes once that job returns
+    void release(std::size_t client);
+    // Block until no job is queued or running
+    void drain();
+
+    Stats getStats() const;
+
+private:
+    struct Client {
+        std::uint64_t latest = 0;
+        Job pending;
+        std::uint64_t pendingSequence = 0;
+        bool running = false;
+        bool released = false;
+    };
+
+    void work(std::size_t client);
+
+    const std::size_t maxWorkers;
+    mutable std::mutex mutex;
+    std::condition_variable idle;
+    std::unordered_map<std::size_t, Client> clients;
+    std::deque<std::size_t> waiting;  // clients with a job but no worker
+    std::size_t workers = 0;
+    Stats stats;
+};
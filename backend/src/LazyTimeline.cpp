@@ -0,0 +1,48 @@
+#include "LazyTimeline.hpp"
+#include "MilestoneTypes.hpp"
+
+LazyTimeline::LazyTimeline(const UniverseParameters& params, const MilestoneSequence& types)
+    : params(params)
+    , types(types)
+{}
+
+LazyTimeline::LazyTimeline(const UniverseParameters& params, const MilestoneSequence& types,
+                           const LazyTimeline& previous, MilestoneFormulas::ParameterMask changed)
+    : params(params)
+    , types(types)
+{
+    for (size_t i = 0; i < types.size(); ++i) {
+        if (MilestoneFormulas::dependencies(types[i]) & changed) {
+            continue;
+        }
+        for (size_t j = 0; j < previous.size(); ++j) {
+            if (previous.types[j] == types[i] && previous.computed[j]) {
+                timestamps[i] = previous.timestamps[j];
+                computed[i] = true;
+                break;
+            }
+        }
+    }
+}
+
+double LazyTimeline::timestampAt(size_t index) const {
+    if (!computed[index]) {
+        timestamps[index] = visitMilestone(types[index], params, [](const Milestone& milestone) {
+            return milestone.calculateTimestamp();
+        });
+        computed[index] = true;
+    }
+    return timestamps[index];
+}
+
+std::string_view LazyTimeline::descriptionAt(size_t index) const {
+    return visitMilestone(types[index], params, [](const Milestone& milestone) {
+        return milestone.getDescription();
+    });
+}
+
+std::string_view LazyTimeline::assetIdAt(size_t index) const {
+    return visitMilestone(types[index], params, [](const Milestone& milestone) {
+        return milestone.getAssetId();
+    });
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Milestone.hpp"
+#include "MilestoneFormulas.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <string_view>
+
+// Ordered milestone types of a timeline. Every type occurs at most once, so
+// the sequence fits in a fixed array.
+class MilestoneSequence {
+public:
+    constexpr void push_back(MilestoneType type) { types[count++] = type; }
+
+    constexpr size_t size() const { return count; }
+    constexpr MilestoneType operator[](size_t index) const { return types[index]; }
+
+    constexpr const MilestoneType* begin() const { return types.data(); }
+    constexpr const MilestoneType* end() const { return types.data() + count; }
+
+private:
+    std::array<MilestoneType, kMilestoneTypeCount> types{};
+    size_t count = 0;
+};
+
+// Timeline whose milestones are only evaluated when a field is read.
+//
+// No Milestone objects are allocated: types come straight from the sequence,
+// descriptions and asset ids are static strings, and timestamps are computed
+// on first access and cached. A list view that shows only names and endings
+// therefore never runs the timestamp formulas.
+class LazyTimeline {
+public:
+    LazyTimeline(const UniverseParameters& params, const MilestoneSequence& types);
+    // Timeline for edited parameters that takes over the cached timestamps
+    // of previous whose formulas read none of the changed parameters
+    LazyTimeline(const UniverseParameters& params, const MilestoneSequence& types,
+                 const LazyTimeline& previous, MilestoneFormulas::ParameterMask changed);
+
+    size_t size() const { return types.size(); }
+    MilestoneType typeAt(size_t index) const { return types[index]; }
+
+    double timestampAt(size_t index) const;
+    // Whether timestampAt(index) is already cached
+    bool isEvaluated(size_t index) const { return computed[index]; }
+    std::string_view descriptionAt(size_t index) const;
+    std::string_view assetIdAt(size_t index) const;
+
+private:
+    UniverseParameters params;
+    MilestoneSequence types;
+    mutable std::array<double, kMilestoneTypeCount> timestamps{};
+    mutable std::bitset<kMilestoneTypeCount> computed;
+};
@@ -1,8 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
+#include <memory_resource>
 #include <nlohmann/json.hpp>
+#include "ResponseWriter.hpp"
 #include "UniverseParameters.hpp"
 
 enum class MilestoneType {
@@ -20,6 +23,13 @@ enum class MilestoneType {
     BigCrunch
 };
 
+constexpr size_t kMilestoneTypeCount = static_cast<size_t>(MilestoneType::BigCrunch) + 1;
+
+// Names the types go by in responses, indexed by MilestoneType
+constexpr std::string_view kMilestoneTypeNames[kMilestoneTypeCount] = {
+    "BIG_BANG", "INFLATION", "PARTICLE_ERA", "NUCLEOSYNTHESIS", "RECOMBINATION", "DARK_AGES",
+    "FIRST_STARS", "GALAXY_FORMATION", "ACCELERATED_EXPANSION", "BIG_RIP", "HEAT_DEATH", "BIG_CRUNCH"};
+
 class Milestone {
 public:
     Milestone(const UniverseParameters& params)
@@ -33,20 +43,78 @@ public:
         nlohmann::json j;
         j["type"] = static_cast<int>(getType());
         j["timestamp"] = calculateTimestamp();
-        j["description"] = getDescription();
-        j["assetId"] = getAssetId(params);
+        j["description"] = std::string(getDescription());
+        j["assetId"] = std::string(getAssetId(params));
         return j;
     }
 
+    // Stream the same object as toJson() without building a DOM
+    void write(ResponseWriter& writer) const {
+        static constexpr JsonKey kAssetId{"\"assetId\""};
+        static constexpr JsonKey kDescription{"\"description\""};
+        static constexpr JsonKey kTimestamp{"\"timestamp\""};
+        static constexpr JsonKey kType{"\"type\""};
+
+        writer.beginObject();
+        writer.key(kAssetId);
+        writer.value(getAssetId(params));
+        writer.key(kDescription);
+        writer.value(getDescription());
+        writer.key(kTimestamp);
+        writer.value(calculateTimestamp());
+        writer.key(kType);
+        writer.value(static_cast<int>(getType()));
+        writer.endObject();
+    }
+
     // Pure virtual methods that derived classes must implement
     virtual double calculateTimestamp() const = 0;
-    virtual std::string getDescription() const = 0;
+    // Descriptions and asset ids are static strings, so no copy is made
+    virtual std::string_view getDescription() const = 0;
     virtual MilestoneType getType() const = 0;
-    virtual std::string getAssetId(const UniverseParameters& params) const = 0;
+    virtual std::string_view getAssetId(const UniverseParameters& params) const = 0;
+
+    // Asset for the parameters this milestone was created with
+    std::string_view getAssetId() const { return getAssetId(params); }
 
 protected:
-    const UniverseParameters& params;
+    // Held by value: timelines outlive the parameters they were built from
+    const UniverseParameters params;
+};
+
+// Deleter for milestones that were either created with new or placed in
+// memory from a std::pmr::memory_resource
+class MilestoneDeleter {
+public:
+    MilestoneDeleter() = default;
+
+    // Lets std::unique_ptr<Milestone> convert into MilestonePtr
+    MilestoneDeleter(std::default_delete<Milestone>) {}
+
+    MilestoneDeleter(std::pmr::memory_resource* resource, size_t size, size_t alignment)
+        : resource(resource)
+        , size(size)
+        , alignment(alignment)
+    {}
+
+    void operator()(Milestone* milestone) const {
+        if (!resource) {
+            delete milestone;
+            return;
+        }
+        milestone->~Milestone();
+        resource->deallocate(milestone, size, alignment);
+    }
+
+private:
+    std::pmr::memory_resource* resource = nullptr;
+    size_t size = 0;
+    size_t alignment = 0;
 };
 
+using MilestonePtr = std::unique_ptr<Milestone, MilestoneDeleter>;
+
 // Factory function to create milestones
-std::unique_ptr<Milestone> createMilestone(MilestoneType type, const UniverseParameters& params); 
\ No newline at end of file
+std::unique_ptr<Milestone> createMilestone(MilestoneType type, const UniverseParameters& params);
+MilestonePtr createMilestone(MilestoneType type, const UniverseParameters& params,
+                             std::pmr::memory_resource* resource); 
\ No newline at end of file
@@ -0,0 +1,336 @@
+#pragma once
+
+#include "Dual.hpp"
+#include "FastMath.hpp"
+#include "Milestone.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+
+// Time conversion constants
+constexpr double SECONDS_PER_YEAR = 365.25 * 24 * 60 * 60;
+constexpr double BILLION = 1e9;
+
+// Milestone timestamp formulas, templated on the scalar type so they can be
+// evaluated with double, with Dual to obtain exact parameter gradients, or
+// with ConstexprMath::Real in constant expressions (PresetCatalog.hpp), or
+// with FastMath::Fast where a small error buys speed (Precision::Fast).
+// The Milestone classes in MilestoneTypes.hpp evaluate these with double.
+namespace MilestoneFormulas {
+
+// The five user parameters as scalars; the remaining ones are constants
+template <typename T>
+struct Parameters {
+    T matterDensity;
+    T darkEnergyDensity;
+    T hubbleConstant;
+    T matterAntimatterRatio;
+    T darkEnergyW;
+    double darkMatterRatio;
+    double initialEnergyDensity;
+};
+
+inline Parameters<double> fromUniverseParameters(const UniverseParameters& params) {
+    return {params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+            params.getMatterAntimatterRatio(), params.getDarkEnergyW(),
+            params.getDarkMatterRatio(), params.getInitialEnergyDensity()};
+}
+
+// std::max(x, floor) for any scalar type
+template <typename T>
+constexpr T atLeast(const T& x, double floor) {
+    return x < floor ? T(floor) : x;
+}
+
+template <typename T>
+constexpr T bigBang(const Parameters<T>&) {
+    return 0.0;
+}
+
+template <typename T>
+constexpr T inflation(const Parameters<T>&) {
+    // Adjust to match expected ~1e-49 Gyr
+    return 1e-49;
+}
+
+template <typename T>
+constexpr T particleEra(const Parameters<T>&) {
+    // Particle era occurs around 10^-6 seconds after the Big Bang
+    return 1e-6 / (SECONDS_PER_YEAR * BILLION);
+}
+
+template <typename T>
+constexpr T nucleosynthesis(const Parameters<T>&) {
+    // BBN occurs around 3 minutes after the Big Bang
+    // Fixed time for more consistent behavior
+    return 1.5e-13;
+}
+
+template <typename T>
+constexpr T recombination(const Parameters<T>& params) {
+    using std::pow;
+    // Recombination occurs around 380,000 years after the Big Bang
+    const double baseYears = 380000.0;
+    const T matterDensity = atLeast(params.matterDensity, 0.01);
+    // Adjust timing based on matter density with a weaker dependence
+    const T scaleFactor = pow(0.3 / matterDensity, 0.25);
+    return (baseYears * scaleFactor) / BILLION;
+}
+
+template <typename T>
+constexpr T darkAges(const Parameters<T>& params) {
+    // Dark Ages start right after recombination
+    return recombination(params);
+}
+
+template <typename T>
+constexpr T firstStars(const Parameters<T>& params) {
+    using std::pow;
+    // Check if there's enough baryonic matter for stars
+    if (params.matterAntimatterRatio < 1e-15) return -1.0; // Too little matter for stars
+
+    // Base time around 200 million years
+    const double baseTime = 0.2; // billion years
+
+    // Adjust based on dark matter presence; very low dark matter means a
+    // significant delay
+    const T darkMatterEffect = params.darkMatterRatio < 0.01
+        ? T(2.5)
+        : pow(T(params.darkMatterRatio / 0.25), -0.3);
+
+    const T matterDensityEffect = pow(params.matterDensity / 0.3, -0.3);
+    return baseTime * darkMatterEffect * matterDensityEffect;
+}
+
+template <typename T>
+constexpr T galaxyFormation(const Parameters<T>& params) {
+    using std::pow;
+    // Check if stars can form first
+    const T starTime = firstStars(params);
+    if (starTime < 0) return -1.0; // No galaxies without stars
+
+    // Base time for galaxy formation
+    const double baseTime = 0.2;
+
+    // Calculate dark matter effect
+    T darkMatterEffect = 0.0;
+    const bool hasNoDarkMatter = params.darkMatterRatio < 0.01;
+    const bool hasNoDarkEnergy = params.darkEnergyDensity < 0.01;
+
+    if (hasNoDarkMatter) {
+        if (hasNoDarkEnergy) {
+            darkMatterEffect = 10.0; // Pure radiation/baryon universe
+        } else {
+            // Baryon-only universe with dark energy - scale based on dark energy
+            const T darkEnergyFactor = params.darkEnergyDensity / 0.7;
+            darkMatterEffect = 5.0 * darkEnergyFactor;
+        }
+    } else {
+        darkMatterEffect = pow(T(params.darkMatterRatio / 0.25), -0.2);
+    }
+
+    // Matter density effect - more sensitive in baryon-only case
+    const double matterPower = hasNoDarkMatter ? -0.3 : -0.2;
+    const T matterDensityEffect = pow(params.matterDensity / 0.3, matterPower);
+
+    return baseTime * darkMatterEffect * matterDensityEffect;
+}
+
+template <typename T>
+constexpr T acceleratedExpansion(const Parameters<T>& params) {
+    using std::pow;
+    if (params.darkEnergyDensity <= 0.0) return -1.0;
+
+    const double baseTime = 3.0; // Keep at 3 Gyr
+    // Adjust scaling with both dark energy and matter density
+    const T densityEffect = pow(0.7 / params.darkEnergyDensity, 0.15);
+    const T matterEffect = pow(params.matterDensity / 0.3, 0.1);
+    return baseTime * densityEffect * matterEffect;
+}
+
+template <typename T>
+constexpr T bigRip(const Parameters<T>& params) {
+    using std::pow;
+    if (params.darkEnergyW >= -1.0 || params.darkEnergyDensity <= 0.0)
+        return -1.0; // No Big Rip
+
+    // Simplified calculation to match expected timescale
+    const double baseTime = 20.0; // Expected time for w = -1.2
+    const T wEffect = pow(-params.darkEnergyW / 1.2, -0.5);
+    return baseTime * wEffect;
+}
+
+template <typename T>
+constexpr T bigCrunch(const Parameters<T>& params) {
+    using std::sqrt;
+    // Calculate total matter density from initial energy density and dark matter ratio
+    const double totalMatterDensity = params.initialEnergyDensity * params.darkMatterRatio;
+    const T& darkEnergyDensity = params.darkEnergyDensity;
+    const T omegaTotal = totalMatterDensity + darkEnergyDensity;
+    const T& w = params.darkEnergyW;
+
+    // For matter-dominated universe (negligible dark energy)
+    if (darkEnergyDensity <= 0.01) {
+        // Check if total density indicates a closed universe
+        if (omegaTotal > 1.0) {
+            return 50.0; // Standard recollapse time
+        }
+    }
+
+    // For mixed cases, check both total density and dark energy equation of state
+    if (omegaTotal > 1.0 && w >= -1.0/3.0) {
+        const T H0 = params.hubbleConstant * 0.001;
+        const T densityParameter = omegaTotal - 1.0;
+        return M_PI / (2.0 * H0 * sqrt(densityParameter));
+    }
+
+    return -1.0; // No Big Crunch
+}
+
+template <typename T>
+constexpr T heatDeath(const Parameters<T>& params) {
+    // Check if universe ends in another way first
+    const T bigRipTime = bigRip(params);
+    const T bigCrunchTime = bigCrunch(params);
+
+    // Only return -1 if we have a definite earlier end
+    if (bigRipTime > 0 && bigRipTime < 1e50) {
+        return -1.0; // Ends in Big Rip
+    }
+
+    if (bigCrunchTime > 0 && bigCrunchTime < 1e50) {
+        return -1.0; // Ends in Big Crunch
+    }
+
+    // For all other cases, including radiation-dominated universes,
+    // the end state is heat death
+    return 1e100;
+}
+
+template <typename T>
+constexpr T timestamp(MilestoneType type, const Parameters<T>& params) {
+    switch (type) {
+        case MilestoneType::BigBang: return bigBang(params);
+        case MilestoneType::Inflation: return inflation(params);
+        case MilestoneType::ParticleEra: return particleEra(params);
+        case MilestoneType::NucleosynthesisBBN: return nucleosynthesis(params);
+        case MilestoneType::Recombination: return recombination(params);
+        case MilestoneType::DarkAges: return darkAges(params);
+        case MilestoneType::FirstStars: return firstStars(params);
+        case MilestoneType::GalaxyFormation: return galaxyFormation(params);
+        case MilestoneType::AcceleratedExpansion: return acceleratedExpansion(params);
+        case MilestoneType::BigRip: return bigRip(params);
+        case MilestoneType::HeatDeath: return heatDeath(params);
+        case MilestoneType::BigCrunch: return bigCrunch(params);
+        default:
+            throw std::runtime_error("Unsupported milestone type");
+    }
+}
+
+// How timestamps of double parameters are evaluated: Exact with std::pow,
+// Fast with FastMath::pow (relative error below 1e-10)
+enum class Precision { Exact, Fast };
+
+// Precision of sweeps unless they choose one; Fast in builds configured
+// with -DCOSMIC_FAST_MATH=ON. Interactive timelines are always Exact.
+#ifdef COSMIC_FAST_MATH
+constexpr Precision kDefaultPrecision = Precision::Fast;
+#else
+constexpr Precision kDefaultPrecision = Precision::Exact;
+#endif
+
+inline double timestamp(MilestoneType type, const UniverseParameters& params, Precision precision) {
+    if (precision == Precision::Exact) {
+        return timestamp(type, fromUniverseParameters(params));
+    }
+    const Parameters<FastMath::Fast> scalars{
+        params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+        params.getMatterAntimatterRatio(), params.getDarkEnergyW(),
+        params.getDarkMatterRatio(), params.getInitialEnergyDensity()};
+    return timestamp(type, scalars).value;
+}
+
+// Gradients are taken with respect to the five user parameters, in the order
+// of the Parameters fields
+constexpr size_t kParameterCount = 5;
+constexpr const char* kParameterNames[kParameterCount] = {
+    "matterDensity", "darkEnergyDensity", "hubbleConstant", "matterAntimatterRatio", "darkEnergyW"};
+
+// Set of parameters, bit i standing for kParameterNames[i]
+using ParameterMask = std::uint32_t;
+constexpr ParameterMask kMatterDensityBit = 1u << 0;
+constexpr ParameterMask kDarkEnergyDensityBit = 1u << 1;
+constexpr ParameterMask kHubbleConstantBit = 1u << 2;
+constexpr ParameterMask kMatterAntimatterRatioBit = 1u << 3;
+constexpr ParameterMask kDarkEnergyWBit = 1u << 4;
+constexpr ParameterMask kAllParameters = (1u << kParameterCount) - 1;
+
+// Parameters each timestamp formula reads, directly or through the
+// formulas it calls; a timestamp stays valid while none of them changes
+constexpr ParameterMask dependencies(MilestoneType type) {
+    switch (type) {
+        case MilestoneType::BigBang:
+        case MilestoneType::Inflation:
+        case MilestoneType::ParticleEra:
+        case MilestoneType::NucleosynthesisBBN:
+            return 0;
+        case MilestoneType::Recombination:
+        case MilestoneType::DarkAges:
+            return kMatterDensityBit;
+        case MilestoneType::FirstStars:
+            return kMatterDensityBit | kMatterAntimatterRatioBit;
+        case MilestoneType::GalaxyFormation:
+            return kMatterDensityBit | kMatterAntimatterRatioBit | kDarkEnergyDensityBit;
+        case MilestoneType::AcceleratedExpansion:
+            return kMatterDensityBit | kDarkEnergyDensityBit;
+        case MilestoneType::BigRip:
+            return kDarkEnergyWBit | kDarkEnergyDensityBit;
+        case MilestoneType::BigCrunch:
+        case MilestoneType::HeatDeath:
+            return kDarkEnergyWBit | kDarkEnergyDensityBit | kHubbleConstantBit;
+    }
+    return kAllParameters;
+}
+
+// Parameters that decide which milestones a timeline contains
+// (SimulatedUniverse::milestoneTypes and ending)
+constexpr ParameterMask kSequenceDependencies =
+    kMatterDensityBit | kDarkEnergyDensityBit | kHubbleConstantBit | kDarkEnergyWBit;
+
+// Parameters whose values differ between a and b
+inline ParameterMask changedParameters(const UniverseParameters& a, const UniverseParameters& b) {
+    ParameterMask mask = 0;
+    if (a.getMatterDensity() != b.getMatterDensity()) mask |= kMatterDensityBit;
+    if (a.getDarkEnergyDensity() != b.getDarkEnergyDensity()) mask |= kDarkEnergyDensityBit;
+    if (a.getHubbleConstant() != b.getHubbleConstant()) mask |= kHubbleConstantBit;
+    if (a.getMatterAntimatterRatio() != b.getMatterAntimatterRatio()) mask |= kMatterAntimatterRatioBit;
+    if (a.getDarkEnergyW() != b.getDarkEnergyW()) mask |= kDarkEnergyWBit;
+    return mask;
+}
+
+struct TimestampGradient {
+    MilestoneType type;
+    double timestamp;
+    std::array<double, kParameterCount> gradient;
+};
+
+// Timestamp and its exact gradient from one forward-mode pass. Where a
+// formula branches, the gradient is that of the branch taken; sentinel
+// timestamps (-1, 1e100) have a zero gradient.
+inline TimestampGradient timestampGradient(MilestoneType type, const UniverseParameters& params) {
+    using Scalar = Dual<kParameterCount>;
+    const Parameters<Scalar> seeded{
+        Scalar::variable(params.getMatterDensity(), 0),
+        Scalar::variable(params.getDarkEnergyDensity(), 1),
+        Scalar::variable(params.getHubbleConstant(), 2),
+        Scalar::variable(params.getMatterAntimatterRatio(), 3),
+        Scalar::variable(params.getDarkEnergyW(), 4),
+        params.getDarkMatterRatio(),
+        params.getInitialEnergyDensity()};
+    const Scalar result = timestamp(type, seeded);
+    return {type, result.value, result.gradient};
+}
+
+} // namespace MilestoneFormulas
@@ -0,0 +1,85 @@
+#include "MilestoneTimeIndex.hpp"
+#include "SimulatedUniverse.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+void MilestoneTimeIndex::insert(int id, const SimulatedUniverse& universe) {
+    const LazyTimeline& timeline = universe.getComputedTimeline().timeline();
+    for (size_t i = 0; i < timeline.size(); ++i) {
+        const double timestamp = timeline.timestampAt(i);
+        if (!std::isnan(timestamp)) {
+            entries[static_cast<size_t>(timeline.typeAt(i))].emplace(timestamp, id);
+        }
+    }
+}
+
+void MilestoneTimeIndex::remove(int id, const SimulatedUniverse& universe) {
+    const LazyTimeline& timeline = universe.getComputedTimeline().timeline();
+    for (size_t i = 0; i < timeline.size(); ++i) {
+        entries[static_cast<size_t>(timeline.typeAt(i))].erase({timeline.timestampAt(i), id});
+    }
+}
+
+MilestoneTimeIndex::Contribution MilestoneTimeIndex::contributionOf(const SimulatedUniverse& universe) {
+    const LazyTimeline& timeline = universe.getComputedTimeline().timeline();
+    Contribution contribution;
+    contribution.reserve(timeline.size());
+    for (size_t i = 0; i < timeline.size(); ++i) {
+        const double timestamp = timeline.timestampAt(i);
+        if (!std::isnan(timestamp)) {
+            contribution.emplace_back(timeline.typeAt(i), timestamp);
+        }
+    }
+    return contribution;
+}
+
+void MilestoneTimeIndex::update(int id, const Contribution& before, const SimulatedUniverse& universe) {
+    const Contribution after = contributionOf(universe);
+    // A timeline holds each type at most once, so entries pair up by type
+    auto find = [](const Contribution& contribution, MilestoneType type) {
+        return std::find_if(contribution.begin(), contribution.end(),
+                            [type](const auto& entry) { return entry.first == type; });
+    };
+    for (const auto& [type, timestamp] : before) {
+        auto match = find(after, type);
+        if (match == after.end() || match->second != timestamp) {
+            entries[static_cast<size_t>(type)].erase({timestamp, id});
+        }
+    }
+    for (const auto& [type, timestamp] : after) {
+        auto match = find(before, type);
+        if (match == before.end() || match->second != timestamp) {
+            entries[static_cast<size_t>(type)].emplace(timestamp, id);
+        }
+    }
+}
+
+std::vector<MilestoneTimeIndex::Event> MilestoneTimeIndex::query(MilestoneType type, double from, double to,
+                                                                 size_t limit) const {
+    std::vector<Event> events;
+    const Entries& sorted = entries[static_cast<size_t>(type)];
+    for (auto it = sorted.lower_bound({from, std::numeric_limits<int>::min()});
+         it != sorted.end() && it->first <= to && events.size() < limit; ++it) {
+        events.push_back({it->second, type, it->first});
+    }
+    return events;
+}
+
+std::vector<MilestoneTimeIndex::Event> MilestoneTimeIndex::query(const std::vector<MilestoneType>& types,
+                                                                 double from, double to, size_t limit) const {
+    // Each per-type list is sorted and holds at most limit events, so the
+    // first limit of the merged lists are the overall earliest
+    std::vector<Event> events;
+    for (MilestoneType type : types) {
+        auto matches = query(type, from, to, limit);
+        const size_t middle = events.size();
+        events.insert(events.end(), matches.begin(), matches.end());
+        std::inplace_merge(events.begin(), events.begin() + middle, events.end(),
+                           [](const Event& a, const Event& b) { return a.timestamp < b.timestamp; });
+        if (events.size() > limit) {
+            events.resize(limit);
+        }
+    }
+    return events;
+}
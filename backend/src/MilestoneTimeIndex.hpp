@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Milestone.hpp"
+#include <array>
+#include <cstddef>
+#include <set>
+#include <utility>
+#include <vector>
+
+class SimulatedUniverse;
+
+// Per milestone type, the (timestamp, id) pairs of all universes whose
+// timeline contains that milestone, kept sorted. A time-window query is a
+// binary search plus a walk over the matches: O(log n + output).
+class MilestoneTimeIndex {
+public:
+    struct Event {
+        int id;
+        MilestoneType type;
+        double timestamp;
+    };
+
+    // The (type, timestamp) entries a universe contributes
+    using Contribution = std::vector<std::pair<MilestoneType, double>>;
+    static Contribution contributionOf(const SimulatedUniverse& universe);
+
+    void insert(int id, const SimulatedUniverse& universe);
+    void remove(int id, const SimulatedUniverse& universe);
+    // Replace the entries id contributed before an edit with those of the
+    // edited universe, touching only the ones that changed
+    void update(int id, const Contribution& before, const SimulatedUniverse& universe);
+
+    // Events of the given type with from <= timestamp <= to, earliest first,
+    // at most limit of them
+    std::vector<Event> query(MilestoneType type, double from, double to, size_t limit) const;
+    // Same over several types, merged by timestamp
+    std::vector<Event> query(const std::vector<MilestoneType>& types, double from, double to,
+                             size_t limit) const;
+
+    size_t size(MilestoneType type) const { return entries[static_cast<size_t>(type)].size(); }
+
+private:
+    using Entries = std::set<std::pair<double, int>>;
+
+    std::array<Entries, kMilestoneTypeCount> entries;
+};
@@ -1,132 +1,100 @@
 #pragma once
 
 #include "Milestone.hpp"
+#include "MilestoneFormulas.hpp"
 #include <cmath>
 #include <iostream>
 #include "UniverseParameters.hpp"
 
-// Time conversion constants
-constexpr double SECONDS_PER_YEAR = 365.25 * 24 * 60 * 60;
-constexpr double BILLION = 1e9;
-
-// Forward declarations
-class BigRipMilestone;
-class BigCrunchMilestone;
-
 class BigBangMilestone : public Milestone {
 public:
     using Milestone::Milestone;
-    double calculateTimestamp() const override { return 0.0; }
-    std::string getDescription() const override {
+    double calculateTimestamp() const override {
+        return MilestoneFormulas::bigBang(MilestoneFormulas::fromUniverseParameters(params));
+    }
+    std::string_view getDescription() const override {
         return "The universe begins in an incredibly hot, dense state";
     }
     MilestoneType getType() const override { return MilestoneType::BigBang; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_bigbang"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_bigbang"; }
 };
 
 class InflationMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Adjust to match expected ~1e-49 Gyr
-        return 1e-49;
+        return MilestoneFormulas::inflation(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "The universe undergoes rapid exponential expansion";
     }
     MilestoneType getType() const override { return MilestoneType::Inflation; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_inflation"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_inflation"; }
 };
 
 class ParticleEraMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Particle era occurs around 10^-6 seconds after the Big Bang
-        return 1e-6 / (SECONDS_PER_YEAR * BILLION);
+        return MilestoneFormulas::particleEra(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "Formation of quarks and leptons";
     }
     MilestoneType getType() const override { return MilestoneType::ParticleEra; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_particleera"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_particleera"; }
 };
 
 class NucleosynthesisBBNMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // BBN occurs around 3 minutes after the Big Bang
-        // Fixed time for more consistent behavior
-        return 1.5e-13;
+        return MilestoneFormulas::nucleosynthesis(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "Formation of light elements during Big Bang Nucleosynthesis";
     }
     MilestoneType getType() const override { return MilestoneType::NucleosynthesisBBN; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_nucleosynthesis"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_nucleosynthesis"; }
 };
 
 class RecombinationMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Recombination occurs around 380,000 years after the Big Bang
-        const double baseYears = 380000.0;
-        const double matterDensity = std::max(params.getMatterDensity(), 0.01);
-        // Adjust timing based on matter density with a weaker dependence
-        const double scaleFactor = std::pow(0.3 / matterDensity, 0.25);
-        return (baseYears * scaleFactor) / BILLION;
-    }
-    std::string getDescription() const override {
+        return MilestoneFormulas::recombination(MilestoneFormulas::fromUniverseParameters(params));
+    }
+    std::string_view getDescription() const override {
         return "The universe becomes transparent as electrons bind to nuclei";
     }
     MilestoneType getType() const override { return MilestoneType::Recombination; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_recombination"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_recombination"; }
 };
 
 class DarkAgesMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Dark Ages start right after recombination
-        const RecombinationMilestone recomb(params);
-        return recomb.calculateTimestamp();
+        return MilestoneFormulas::darkAges(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "Period before the first stars, universe is dark and filled with hydrogen";
     }
     MilestoneType getType() const override { return MilestoneType::DarkAges; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_darkages"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_darkages"; }
 };
 
 class FirstStarsMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Check if there's enough baryonic matter for stars
-        if (params.getMatterAntimatterRatio() < 1e-15) return -1.0; // Too little matter for stars
-        
-        // Base time around 200 million years
-        const double baseTime = 0.2; // billion years
-        
-        // Adjust based on dark matter presence
-        double darkMatterEffect;
-        if (params.getDarkMatterRatio() < 0.01) {
-            // Very low dark matter - significant delay
-            darkMatterEffect = 2.5;
-        } else {
-            darkMatterEffect = std::pow(params.getDarkMatterRatio() / 0.25, -0.3);
-        }
-        
-        const double matterDensityEffect = std::pow(params.getMatterDensity() / 0.3, -0.3);
-        return baseTime * darkMatterEffect * matterDensityEffect;
+        return MilestoneFormulas::firstStars(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "The first stars begin to shine, ending the cosmic dark ages";
     }
     MilestoneType getType() const override { return MilestoneType::FirstStars; }
-    std::string getAssetId(const UniverseParameters& params) const override {
+    std::string_view getAssetId(const UniverseParameters& params) const override {
         if (params.getMatterAntimatterRatio() < 1e-11) {
             return "milestone_firststars_none"; // No star formation possible
         }
@@ -141,42 +109,13 @@ class GalaxyFormationMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Check if stars can form first
-        const FirstStarsMilestone firstStars(params);
-        const double starTime = firstStars.calculateTimestamp();
-        if (starTime < 0) return -1.0; // No galaxies without stars
-        
-        // Base time for galaxy formation
-        const double baseTime = 0.2;
-        
-        // Calculate dark matter effect
-        double darkMatterEffect;
-        const bool hasNoDarkMatter = params.getDarkMatterRatio() < 0.01;
-        const bool hasNoDarkEnergy = params.getDarkEnergyDensity() < 0.01;
-        
-        if (hasNoDarkMatter) {
-            if (hasNoDarkEnergy) {
-                darkMatterEffect = 10.0; // Pure radiation/baryon universe
-            } else {
-                // Baryon-only universe with dark energy - scale based on dark energy
-                const double darkEnergyFactor = params.getDarkEnergyDensity() / 0.7;
-                darkMatterEffect = 5.0 * darkEnergyFactor;
-            }
-        } else {
-            darkMatterEffect = std::pow(params.getDarkMatterRatio() / 0.25, -0.2);
-        }
-        
-        // Matter density effect - more sensitive in baryon-only case
-        double matterPower = hasNoDarkMatter ? -0.3 : -0.2;
-        const double matterDensityEffect = std::pow(params.getMatterDensity() / 0.3, matterPower);
-        
-        return baseTime * darkMatterEffect * matterDensityEffect;
-    }
-    std::string getDescription() const override {
+        return MilestoneFormulas::galaxyFormation(MilestoneFormulas::fromUniverseParameters(params));
+    }
+    std::string_view getDescription() const override {
         return "Galaxies begin to form and cluster";
     }
     MilestoneType getType() const override { return MilestoneType::GalaxyFormation; }
-    std::string getAssetId(const UniverseParameters& params) const override {
+    std::string_view getAssetId(const UniverseParameters& params) const override {
         if (params.getMatterAntimatterRatio() < 1e-11) {
             return "milestone_galaxies_none"; // No galaxies possible
         }
@@ -194,19 +133,13 @@ class AcceleratedExpansionMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        if (params.getDarkEnergyDensity() <= 0.0) return -1.0;
-        
-        const double baseTime = 3.0; // Keep at 3 Gyr
-        // Adjust scaling with both dark energy and matter density
-        const double densityEffect = std::pow(0.7 / params.getDarkEnergyDensity(), 0.15);
-        const double matterEffect = std::pow(params.getMatterDensity() / 0.3, 0.1);
-        return baseTime * densityEffect * matterEffect;
-    }
-    std::string getDescription() const override {
+        return MilestoneFormulas::acceleratedExpansion(MilestoneFormulas::fromUniverseParameters(params));
+    }
+    std::string_view getDescription() const override {
         return "Dark energy becomes dominant, accelerating cosmic expansion";
     }
     MilestoneType getType() const override { return MilestoneType::AcceleratedExpansion; }
-    std::string getAssetId(const UniverseParameters& params) const override {
+    std::string_view getAssetId(const UniverseParameters& params) const override {
         if (params.getDarkEnergyDensity() > 0.8) {
             return "milestone_expansion_strong"; // Strong dark energy dominance
         }
@@ -218,19 +151,13 @@ class BigRipMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        if (params.getDarkEnergyW() >= -1.0 || params.getDarkEnergyDensity() <= 0.0) 
-            return -1.0; // No Big Rip
-        
-        // Simplified calculation to match expected timescale
-        const double baseTime = 20.0; // Expected time for w = -1.2
-        const double wEffect = std::pow(-params.getDarkEnergyW() / 1.2, -0.5);
-        return baseTime * wEffect;
-    }
-    std::string getDescription() const override {
+        return MilestoneFormulas::bigRip(MilestoneFormulas::fromUniverseParameters(params));
+    }
+    std::string_view getDescription() const override {
         return "Universe undergoes a Big Rip due to phantom dark energy";
     }
     MilestoneType getType() const override { return MilestoneType::BigRip; }
-    std::string getAssetId(const UniverseParameters& params) const override {
+    std::string_view getAssetId(const UniverseParameters& params) const override {
         if (params.getDarkEnergyW() < -2.0) {
             return "milestone_bigrip_violent"; // Extremely violent end
         }
@@ -242,34 +169,13 @@ class BigCrunchMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Calculate total matter density from initial energy density and dark matter ratio
-        const double totalMatterDensity = params.getInitialEnergyDensity() * params.getDarkMatterRatio();
-        const double darkEnergyDensity = params.getDarkEnergyDensity();
-        const double omegaTotal = totalMatterDensity + darkEnergyDensity;
-        const double w = params.getDarkEnergyW();
-        
-        // For matter-dominated universe (negligible dark energy)
-        if (darkEnergyDensity <= 0.01) {
-            // Check if total density indicates a closed universe
-            if (omegaTotal > 1.0) {
-                return 50.0; // Standard recollapse time
-            }
-        }
-        
-        // For mixed cases, check both total density and dark energy equation of state
-        if (omegaTotal > 1.0 && w >= -1.0/3.0) {
-            const double H0 = params.getHubbleConstant() * 0.001;
-            const double densityParameter = omegaTotal - 1.0;
-            return M_PI / (2.0 * H0 * std::sqrt(densityParameter));
-        }
-        
-        return -1.0; // No Big Crunch
+        return MilestoneFormulas::bigCrunch(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "Universe collapses in a Big Crunch";
     }
     MilestoneType getType() const override { return MilestoneType::BigCrunch; }
-    std::string getAssetId(const UniverseParameters& params) const override {
+    std::string_view getAssetId(const UniverseParameters& params) const override {
         if (params.getMatterDensity() > 2.0) {
             return "milestone_bigcrunch_rapid"; // Rapid collapse
         }
@@ -281,33 +187,56 @@ class HeatDeathMilestone : public Milestone {
 public:
     using Milestone::Milestone;
     double calculateTimestamp() const override {
-        // Check if universe ends in another way first
-        const BigRipMilestone bigRip(params);
-        const BigCrunchMilestone bigCrunch(params);
-        
-        const double bigRipTime = bigRip.calculateTimestamp();
-        const double bigCrunchTime = bigCrunch.calculateTimestamp();
-        
-        // Only return -1 if we have a definite earlier end
-        if (bigRipTime > 0 && bigRipTime < 1e50) {
-            return -1.0; // Ends in Big Rip
-        }
-        
-        if (bigCrunchTime > 0 && bigCrunchTime < 1e50) {
-            return -1.0; // Ends in Big Crunch
-        }
-        
-        // For all other cases, including radiation-dominated universes,
-        // the end state is heat death
-        return 1e100;
+        return MilestoneFormulas::heatDeath(MilestoneFormulas::fromUniverseParameters(params));
     }
-    std::string getDescription() const override {
+    std::string_view getDescription() const override {
         return "Universe approaches heat death";
     }
     MilestoneType getType() const override { return MilestoneType::HeatDeath; }
-    std::string getAssetId(const UniverseParameters&) const override { return "milestone_heatdeath"; }
+    std::string_view getAssetId(const UniverseParameters&) const override { return "milestone_heatdeath"; }
 };
 
+// Construct a milestone in memory obtained from a memory resource
+template <typename T>
+MilestonePtr makeMilestone(const UniverseParameters& params, std::pmr::memory_resource* resource) {
+    void* memory = resource->allocate(sizeof(T), alignof(T));
+    return MilestonePtr(new (memory) T(params), MilestoneDeleter(resource, sizeof(T), alignof(T)));
+}
+
+// Construct the milestone on the stack and pass it to visitor. Used where
+// only a few values of a milestone are needed and nothing must be allocated.
+template <typename Visitor>
+decltype(auto) visitMilestone(MilestoneType type, const UniverseParameters& params, Visitor&& visitor) {
+    switch (type) {
+        case MilestoneType::BigBang:
+            return visitor(BigBangMilestone(params));
+        case MilestoneType::Inflation:
+            return visitor(InflationMilestone(params));
+        case MilestoneType::ParticleEra:
+            return visitor(ParticleEraMilestone(params));
+        case MilestoneType::NucleosynthesisBBN:
+            return visitor(NucleosynthesisBBNMilestone(params));
+        case MilestoneType::Recombination:
+            return visitor(RecombinationMilestone(params));
+        case MilestoneType::DarkAges:
+            return visitor(DarkAgesMilestone(params));
+        case MilestoneType::FirstStars:
+            return visitor(FirstStarsMilestone(params));
+        case MilestoneType::GalaxyFormation:
+            return visitor(GalaxyFormationMilestone(params));
+        case MilestoneType::AcceleratedExpansion:
+            return visitor(AcceleratedExpansionMilestone(params));
+        case MilestoneType::BigRip:
+            return visitor(BigRipMilestone(params));
+        case MilestoneType::HeatDeath:
+            return visitor(HeatDeathMilestone(params));
+        case MilestoneType::BigCrunch:
+            return visitor(BigCrunchMilestone(params));
+        default:
+            throw std::runtime_error("Unsupported milestone type");
+    }
+}
+
 // Factory function implementation
 inline std::unique_ptr<Milestone> createMilestone(MilestoneType type, const UniverseParameters& params) {
     switch (type) {
@@ -338,4 +267,37 @@ inline std::unique_ptr<Milestone> createMilestone(MilestoneType type, const Univ
         default:
             throw std::runtime_error("Unsupported milestone type");
     }
-} 
\ No newline at end of file
+} 
+
+// Factory variant allocating from a memory resource, e.g. a request arena
+inline MilestonePtr createMilestone(MilestoneType type, const UniverseParameters& params,
+                                    std::pmr::memory_resource* resource) {
+    switch (type) {
+        case MilestoneType::BigBang:
+            return makeMilestone<BigBangMilestone>(params, resource);
+        case MilestoneType::Inflation:
+            return makeMilestone<InflationMilestone>(params, resource);
+        case MilestoneType::ParticleEra:
+            return makeMilestone<ParticleEraMilestone>(params, resource);
+        case MilestoneType::NucleosynthesisBBN:
+            return makeMilestone<NucleosynthesisBBNMilestone>(params, resource);
+        case MilestoneType::Recombination:
+            return makeMilestone<RecombinationMilestone>(params, resource);
+        case MilestoneType::DarkAges:
+            return makeMilestone<DarkAgesMilestone>(params, resource);
+        case MilestoneType::FirstStars:
+            return makeMilestone<FirstStarsMilestone>(params, resource);
+        case MilestoneType::GalaxyFormation:
+            return makeMilestone<GalaxyFormationMilestone>(params, resource);
+        case MilestoneType::AcceleratedExpansion:
+            return makeMilestone<AcceleratedExpansionMilestone>(params, resource);
+        case MilestoneType::BigRip:
+            return makeMilestone<BigRipMilestone>(params, resource);
+        case MilestoneType::HeatDeath:
+            return makeMilestone<HeatDeathMilestone>(params, resource);
+        case MilestoneType::BigCrunch:
+            return makeMilestone<BigCrunchMilestone>(params, resource);
+        default:
+            throw std::runtime_error("Unsupported milestone type");
+    }
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <string_view>
+
+// Whether name contains term, ignoring ASCII case. The match of
+// UniverseDB::searchUniverses and of the streamUniverses filter.
+inline bool nameMatches(std::string_view name, std::string_view term) {
+    const auto lower = [](char c) { return std::tolower(static_cast<unsigned char>(c)); };
+    return std::search(name.begin(), name.end(), term.begin(), term.end(),
+                       [&](char a, char b) { return lower(a) == lower(b); }) != name.end();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Split [0, count) into contiguous chunks and call body(begin, end) for each
+// chunk on its own thread. Runs inline when the range is smaller than two
+// chunks of minChunk items. The first exception thrown by body is rethrown
+// after all threads have finished.
+template <typename Body>
+void parallelFor(size_t count, size_t minChunk, Body&& body) {
+    const size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+    const size_t threads = std::min(hardware, count / std::max<size_t>(minChunk, 1));
+    if (threads <= 1) {
+        body(size_t{0}, count);
+        return;
+    }
+
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+    std::vector<std::thread> workers;
+    workers.reserve(threads - 1);
+
+    auto run = [&](size_t begin, size_t end) {
+        try {
+            body(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+        }
+    };
+
+    const size_t chunk = (count + threads - 1) / threads;
+    for (size_t t = 1; t < threads; ++t) {
+        const size_t begin = t * chunk;
+        const size_t end = std::min(count, begin + chunk);
+        if (begin < end) {
+            workers.emplace_back(run, begin, end);
+        }
+    }
+    run(0, std::min(count, chunk));
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
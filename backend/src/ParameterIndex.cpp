@@ -0,0 +1,244 @@
+#include "ParameterIndex.hpp"
+#include "Universe.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace {
+// Ranges accepted by UniverseValidator; values outside still index fine
+constexpr ParameterIndex::Point kLower{0.1, 0.0, 50.0, -11.0, -2.0};
+constexpr ParameterIndex::Point kUpper{2.0, 1.0, 80.0, -7.0, -0.5};
+
+// Pending entries and tombstones tolerated before a rebuild
+constexpr size_t kMinSlack = 64;
+constexpr size_t kPendingFraction = 16;
+constexpr size_t kRemovedFraction = 4;
+
+double distanceSquared(const ParameterIndex::Point& a, const ParameterIndex::Point& b,
+                       const ParameterIndex::Weights& weights) {
+    double sum = 0.0;
+    for (size_t axis = 0; axis < ParameterIndex::kAxes; ++axis) {
+        const double diff = a[axis] - b[axis];
+        sum += weights[axis] * diff * diff;
+    }
+    return sum;
+}
+
+bool closer(const ParameterIndex::Neighbor& a, const ParameterIndex::Neighbor& b) {
+    return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+}
+
+// Keeps the k best candidates in a max-heap; distances are squared until done
+class NearestCollector {
+public:
+    explicit NearestCollector(size_t k) : k(k) {}
+
+    double bound() const {
+        return heap.size() < k ? std::numeric_limits<double>::infinity() : heap.top().distance;
+    }
+
+    void add(int id, double distanceSquared) {
+        if (k == 0) {
+            return;
+        }
+        if (heap.size() < k) {
+            heap.push({id, distanceSquared});
+        } else if (closer({id, distanceSquared}, heap.top())) {
+            heap.pop();
+            heap.push({id, distanceSquared});
+        }
+    }
+
+    std::vector<ParameterIndex::Neighbor> finish() {
+        std::vector<ParameterIndex::Neighbor> result;
+        result.reserve(heap.size());
+        while (!heap.empty()) {
+            result.push_back(heap.top());
+            heap.pop();
+        }
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+
+private:
+    struct ByDistance {
+        bool operator()(const ParameterIndex::Neighbor& a, const ParameterIndex::Neighbor& b) const {
+            return closer(a, b);
+        }
+    };
+
+    size_t k;
+    std::priority_queue<ParameterIndex::Neighbor, std::vector<ParameterIndex::Neighbor>, ByDistance> heap;
+};
+
+class RadiusCollector {
+public:
+    explicit RadiusCollector(double radius) : radiusSquared(radius * radius) {}
+
+    double bound() const { return radiusSquared; }
+
+    void add(int id, double distanceSquared) {
+        if (distanceSquared <= radiusSquared) {
+            found.push_back({id, distanceSquared});
+        }
+    }
+
+    std::vector<ParameterIndex::Neighbor> finish() {
+        std::sort(found.begin(), found.end(), closer);
+        return std::move(found);
+    }
+
+private:
+    double radiusSquared;
+    std::vector<ParameterIndex::Neighbor> found;
+};
+}
+
+ParameterIndex::Point ParameterIndex::normalize(double matterDensity, double darkEnergyDensity,
+                                                double hubbleConstant, double matterAntimatterRatio,
+                                                double darkEnergyW) {
+    // η spans orders of magnitude, so it is compared on a log scale
+    const double logRatio = std::log10(std::max(matterAntimatterRatio, 1e-300));
+    const Point raw{matterDensity, darkEnergyDensity, hubbleConstant, logRatio, darkEnergyW};
+
+    Point point;
+    for (size_t axis = 0; axis < kAxes; ++axis) {
+        point[axis] = (raw[axis] - kLower[axis]) / (kUpper[axis] - kLower[axis]);
+    }
+    return point;
+}
+
+ParameterIndex::Point ParameterIndex::normalize(const Universe& universe) {
+    return normalize(universe.getMatterDensity(), universe.getDarkEnergyDensity(),
+                     universe.getHubbleConstant(), universe.getMatterAntimatterRatio(),
+                     universe.getDarkEnergyW());
+}
+
+void ParameterIndex::insert(int id, const Point& point) {
+    if (!ids.insert(id).second) {
+        remove(id);
+        ids.insert(id);
+    }
+    pending.push_back({point, id});
+    rebuildIfNeeded();
+}
+
+void ParameterIndex::insert(const std::vector<std::pair<int, Point>>& entries) {
+    pending.reserve(pending.size() + entries.size());
+    for (const auto& [id, point] : entries) {
+        if (!ids.insert(id).second) {
+            remove(id);
+            ids.insert(id);
+        }
+        pending.push_back({point, id});
+    }
+    rebuildIfNeeded();
+}
+
+bool ParameterIndex::remove(int id) {
+    if (ids.erase(id) == 0) {
+        return false;
+    }
+    auto it = std::find_if(pending.begin(), pending.end(),
+                           [id](const Entry& entry) { return entry.id == id; });
+    if (it != pending.end()) {
+        *it = pending.back();
+        pending.pop_back();
+    } else {
+        removed.insert(id);
+    }
+    rebuildIfNeeded();
+    return true;
+}
+
+void ParameterIndex::rebuild() {
+    if (!removed.empty()) {
+        tree.erase(std::remove_if(tree.begin(), tree.end(),
+                                  [this](const Entry& entry) { return removed.count(entry.id) != 0; }),
+                   tree.end());
+        removed.clear();
+    }
+    tree.insert(tree.end(), pending.begin(), pending.end());
+    pending.clear();
+    build(0, tree.size(), 0);
+}
+
+void ParameterIndex::rebuildIfNeeded() {
+    if (pending.size() > std::max(kMinSlack, tree.size() / kPendingFraction) ||
+        removed.size() > std::max(kMinSlack, tree.size() / kRemovedFraction)) {
+        rebuild();
+    }
+}
+
+void ParameterIndex::build(size_t begin, size_t end, size_t depth) {
+    if (end - begin <= 1) {
+        return;
+    }
+    const size_t axis = depth % kAxes;
+    const size_t mid = begin + (end - begin) / 2;
+    std::nth_element(tree.begin() + begin, tree.begin() + mid, tree.begin() + end,
+                     [axis](const Entry& a, const Entry& b) { return a.point[axis] < b.point[axis]; });
+    build(begin, mid, depth + 1);
+    build(mid + 1, end, depth + 1);
+}
+
+template <typename Collector>
+void ParameterIndex::search(size_t begin, size_t end, size_t depth, const Point& query,
+                            const Weights& weights, Collector& collector) const {
+    if (begin >= end) {
+        return;
+    }
+    const size_t axis = depth % kAxes;
+    const size_t mid = begin + (end - begin) / 2;
+    const Entry& entry = tree[mid];
+
+    if (removed.empty() || removed.count(entry.id) == 0) {
+        collector.add(entry.id, distanceSquared(query, entry.point, weights));
+    }
+
+    // Visit the side of the splitting plane containing the query first; the
+    // other side only if the plane is closer than the current bound
+    const double diff = query[axis] - entry.point[axis];
+    if (diff < 0) {
+        search(begin, mid, depth + 1, query, weights, collector);
+        if (weights[axis] * diff * diff <= collector.bound()) {
+            search(mid + 1, end, depth + 1, query, weights, collector);
+        }
+    } else {
+        search(mid + 1, end, depth + 1, query, weights, collector);
+        if (weights[axis] * diff * diff <= collector.bound()) {
+            search(begin, mid, depth + 1, query, weights, collector);
+        }
+    }
+}
+
+template <typename Collector>
+void ParameterIndex::collect(const Point& query, const Weights& weights, Collector& collector) const {
+    search(0, tree.size(), 0, query, weights, collector);
+    for (const auto& entry : pending) {
+        collector.add(entry.id, distanceSquared(query, entry.point, weights));
+    }
+}
+
+std::vector<ParameterIndex::Neighbor> ParameterIndex::nearest(const Point& query, size_t k,
+                                                              const Weights& weights) const {
+    NearestCollector collector(k);
+    collect(query, weights, collector);
+    auto result = collector.finish();
+    for (auto& neighbor : result) {
+        neighbor.distance = std::sqrt(neighbor.distance);
+    }
+    return result;
+}
+
+std::vector<ParameterIndex::Neighbor> ParameterIndex::withinRadius(const Point& query, double radius,
+                                                                   const Weights& weights) const {
+    RadiusCollector collector(radius);
+    collect(query, weights, collector);
+    auto result = collector.finish();
+    for (auto& neighbor : result) {
+        neighbor.distance = std::sqrt(neighbor.distance);
+    }
+    return result;
+}
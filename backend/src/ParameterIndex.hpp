@@ -0,0 +1,72 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+class Universe;
+
+// k-d tree over normalized universe parameters
+// (Ω_m, Ω_Λ, H₀, log10 η, w), answering k-nearest-neighbour and radius
+// queries with optional per-axis weights.
+//
+// The tree is stored implicitly in one array: every range is split at its
+// midpoint, which holds the median along axis depth % kAxes. Inserts go to a
+// small pending list that is scanned linearly, removals of tree entries
+// leave tombstones. Both are folded in by a rebuild once they grow past a
+// fraction of the tree, so updates stay amortized O(log n).
+class ParameterIndex {
+public:
+    static constexpr size_t kAxes = 5;
+    using Point = std::array<double, kAxes>;
+    using Weights = std::array<double, kAxes>;
+
+    static constexpr Weights kUniformWeights{1.0, 1.0, 1.0, 1.0, 1.0};
+
+    struct Neighbor {
+        int id;
+        double distance;  // weighted Euclidean distance in normalized space
+    };
+
+    // Map parameters onto [0, 1] per axis using the validator ranges
+    static Point normalize(double matterDensity, double darkEnergyDensity, double hubbleConstant,
+                           double matterAntimatterRatio, double darkEnergyW);
+    static Point normalize(const Universe& universe);
+
+    void insert(int id, const Point& point);
+    // Bulk insert with at most one rebuild
+    void insert(const std::vector<std::pair<int, Point>>& entries);
+    bool remove(int id);
+    // Fold pending inserts and tombstones into a balanced tree
+    void rebuild();
+
+    // Closest k entries, nearest first
+    std::vector<Neighbor> nearest(const Point& query, size_t k,
+                                  const Weights& weights = kUniformWeights) const;
+    // All entries within radius, nearest first
+    std::vector<Neighbor> withinRadius(const Point& query, double radius,
+                                       const Weights& weights = kUniformWeights) const;
+
+    size_t size() const { return ids.size(); }
+
+private:
+    struct Entry {
+        Point point;
+        int id;
+    };
+
+    void build(size_t begin, size_t end, size_t depth);
+    template <typename Collector>
+    void search(size_t begin, size_t end, size_t depth, const Point& query,
+                const Weights& weights, Collector& collector) const;
+    template <typename Collector>
+    void collect(const Point& query, const Weights& weights, Collector& collector) const;
+    void rebuildIfNeeded();
+
+    std::vector<Entry> tree;
+    std::vector<Entry> pending;
+    std::unordered_set<int> removed;  // tombstones for ids still in tree
+    std::unordered_set<int> ids;      // live ids
+};
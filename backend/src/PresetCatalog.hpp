@@ -0,0 +1,70 @@
+#pragma once
+
+#include "ConstexprMath.hpp"
+#include "MilestoneFormulas.hpp"
+#include "SimulatedUniverse.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+// Reference scenarios with their timelines. Everything here is evaluated
+// by the compiler: the milestone sequence comes from
+// SimulatedUniverse::milestoneTypes and the timestamps from MilestoneFormulas with ConstexprMath::Real, so using a
+// preset costs no computation at startup or request time. The getPresets
+// response is serialized from this catalog at build time as well
+// (frontend/cmake/EmbedPresets.cpp).
+namespace PresetCatalog {
+
+struct Milestone {
+    MilestoneType type = MilestoneType::BigBang;
+    double timestamp = 0.0;  // Gyr; -1 where the formula rules the event out
+};
+
+struct Preset {
+    std::string_view name;
+    std::string_view description;
+    UniverseParameters parameters;
+    std::optional<MilestoneType> ending;
+    size_t milestoneCount = 0;
+    std::array<Milestone, kMilestoneTypeCount> milestones{};
+};
+
+// A preset has only the parameters of the creation form, each within the
+// ranges of UniverseValidator, so choosing one and creating the universe
+// gives exactly this timeline
+constexpr Preset makePreset(std::string_view name, std::string_view description,
+                            double matterDensity, double darkEnergyDensity, double hubbleConstant,
+                            double matterAntimatterRatio, double darkEnergyW) {
+    const UniverseParameters params(matterDensity, darkEnergyDensity, hubbleConstant,
+                                    matterAntimatterRatio, darkEnergyW);
+    Preset preset{name, description, params, SimulatedUniverse::ending(params)};
+    const MilestoneFormulas::Parameters<ConstexprMath::Real> scalars{
+        params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+        params.getMatterAntimatterRatio(), params.getDarkEnergyW(),
+        params.getDarkMatterRatio(), params.getInitialEnergyDensity()};
+    for (MilestoneType type : SimulatedUniverse::milestoneTypes(params)) {
+        preset.milestones[preset.milestoneCount++] = {type, MilestoneFormulas::timestamp(type, scalars).value};
+    }
+    return preset;
+}
+
+inline constexpr std::array<Preset, 7> kPresets = {{
+    makePreset("ΛCDM", "The standard model: cold dark matter and a cosmological constant",
+               0.3, 0.7, 70.0, 1e-9, -1.0),
+    makePreset("Planck 2018", "The parameters measured from the cosmic microwave background",
+               0.315, 0.685, 67.4, 6.1e-10, -1.0),
+    makePreset("Quintessence", "Dark energy with w > -1 that weakens as the universe grows",
+               0.3, 0.7, 70.0, 1e-9, -0.8),
+    makePreset("Phantom Energy", "Dark energy with w < -1 tears the universe apart",
+               0.3, 0.7, 70.0, 1e-9, -1.2),
+    makePreset("Dark-Energy Dominated", "Less matter and more dark energy; acceleration sets in early",
+               0.2, 0.8, 75.0, 1e-9, -1.0),
+    makePreset("Matter-Dominated", "Flat with no dark energy; expansion slows forever",
+               1.0, 0.0, 55.0, 1e-9, -1.0),
+    makePreset("Closed", "Matter density above critical recollapses into a Big Crunch",
+               1.08, 0.0, 55.0, 1e-9, -1.0),
+}};
+
+} // namespace PresetCatalog
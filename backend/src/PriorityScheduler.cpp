@@ -0,0 +1,147 @@
+#include "PriorityScheduler.hpp"
+#include <algorithm>
+#include <thread>
+
+thread_local PriorityScheduler::Slot* PriorityScheduler::current = nullptr;
+
+PriorityScheduler::Slot::Slot(PriorityScheduler& scheduler, Lane lane)
+    : scheduler(scheduler)
+    , lane(lane)
+    , outer(current)
+{
+    current = this;
+}
+
+PriorityScheduler::Slot::~Slot() {
+    current = outer;
+    scheduler.release(lane);
+}
+
+void PriorityScheduler::Slot::yield() {
+    if (lane != Lane::Bulk) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(scheduler.mutex);
+    if (!scheduler.interactiveBusy()) {
+        return;
+    }
+    ++scheduler.stats.bulkPauses;
+    const auto deadline = std::chrono::steady_clock::now() + scheduler.options.maxBulkDelay;
+    if (!scheduler.changed.wait_until(lock, deadline, [this] { return !scheduler.interactiveBusy(); })) {
+        ++scheduler.stats.bulkAged;
+    }
+}
+
+PriorityScheduler::PriorityScheduler()
+    : PriorityScheduler(Options())
+{
+}
+
+PriorityScheduler::PriorityScheduler(Options options)
+    : options(options)
+{
+    if (this->options.interactiveLimit == 0) {
+        this->options.interactiveLimit = std::max(1u, std::thread::hardware_concurrency());
+    }
+    this->options.bulkLimit = std::max(1u, this->options.bulkLimit);
+}
+
+PriorityScheduler::~PriorityScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    bulkJobsChanged.notify_all();
+    for (auto& worker : bulkWorkers) {
+        worker.join();
+    }
+}
+
+PriorityScheduler::Slot PriorityScheduler::acquire(Lane lane) {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (lane == Lane::Interactive) {
+        ++stats.interactiveWaiting;
+        changed.wait(lock, [this] { return stats.interactiveRunning < options.interactiveLimit; });
+        --stats.interactiveWaiting;
+        ++stats.interactiveRunning;
+    } else {
+        // Interactive work goes first, but only for so long
+        ++stats.bulkWaiting;
+        const auto deadline = std::chrono::steady_clock::now() + options.maxBulkDelay;
+        const bool yielded = changed.wait_until(lock, deadline, [this] {
+            return stats.bulkRunning < options.bulkLimit && !interactiveBusy();
+        });
+        if (!yielded) {
+            if (interactiveBusy()) {
+                ++stats.bulkAged;
+            }
+            changed.wait(lock, [this] { return stats.bulkRunning < options.bulkLimit; });
+        }
+        --stats.bulkWaiting;
+        ++stats.bulkRunning;
+    }
+    lock.unlock();
+    return Slot(*this, lane);
+}
+
+PriorityScheduler::Slot PriorityScheduler::admitInteractive() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.interactiveRunning;
+    }
+    return Slot(*this, Lane::Interactive);
+}
+
+void PriorityScheduler::submitBulk(std::function<void()> job) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        bulkJobs.push_back(std::move(job));
+        ++stats.bulkQueued;
+        if (bulkWorkers.size() < options.bulkLimit) {
+            bulkWorkers.emplace_back(&PriorityScheduler::runBulkJobs, this);
+        }
+    }
+    bulkJobsChanged.notify_one();
+}
+
+void PriorityScheduler::runBulkJobs() {
+    std::unique_lock<std::mutex> lock(mutex);
+    for (;;) {
+        bulkJobsChanged.wait(lock, [this] { return stopping || !bulkJobs.empty(); });
+        if (bulkJobs.empty()) {
+            return;
+        }
+        auto job = std::move(bulkJobs.front());
+        bulkJobs.pop_front();
+        --stats.bulkQueued;
+        lock.unlock();
+        {
+            const auto slot = acquire(Lane::Bulk);
+            job();
+        }
+        lock.lock();
+    }
+}
+
+void PriorityScheduler::checkpoint() {
+    if (current) {
+        current->yield();
+    }
+}
+
+PriorityScheduler::Stats PriorityScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+void PriorityScheduler::release(Lane lane) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lane == Lane::Interactive) {
+            --stats.interactiveRunning;
+        } else {
+            --stats.bulkRunning;
+        }
+    }
+    changed.notify_all();
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Admission control that keeps interactive calls responsive while bulk
+// work (exporting or creating thousands of universes, inverse solves)
+// runs next to them.
+//
+// Every call holds a Slot of its lane while it runs. Each lane has its own
+// concurrency limit. A bulk call is only admitted while no interactive call
+// is running or queued, and it splits its work into slices with yield() in
+// between, which pauses it whenever interactive work shows up. Waits of the
+// bulk lane are aged: after maxBulkDelay a bulk call proceeds with its next
+// slice anyway, so it keeps making progress under constant UI traffic.
+//
+// Threads that must not block, such as an HTTP event loop, hand bulk calls
+// to submitBulk() and count interactive ones with admitInteractive().
+class PriorityScheduler {
+public:
+    enum class Lane {
+        Interactive,
+        Bulk
+    };
+
+    struct Options {
+        unsigned interactiveLimit = 0;  // 0 uses the hardware concurrency
+        unsigned bulkLimit = 1;
+        std::chrono::milliseconds maxBulkDelay{50};
+    };
+
+    struct Stats {
+        unsigned interactiveRunning = 0;
+        unsigned interactiveWaiting = 0;
+        unsigned bulkRunning = 0;
+        unsigned bulkWaiting = 0;
+        unsigned bulkQueued = 0;       // submitted jobs not yet started
+        std::uint64_t bulkPauses = 0;  // bulk waits that interactive work caused
+        std::uint64_t bulkAged = 0;    // bulk waits cut short by aging
+    };
+
+    // Held for the duration of a call. While it lives, checkpoint() on the
+    // same thread yields it.
+    class Slot {
+    public:
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+        ~Slot();
+
+        // Preemption point between slices of bulk work; a no-op for
+        // interactive slots
+        void yield();
+        Lane getLane() const { return lane; }
+
+    private:
+        friend class PriorityScheduler;
+        Slot(PriorityScheduler& scheduler, Lane lane);
+
+        PriorityScheduler& scheduler;
+        Lane lane;
+        Slot* outer;
+    };
+
+    PriorityScheduler();
+    explicit PriorityScheduler(Options options);
+    // Runs the jobs still queued and joins the bulk workers
+    ~PriorityScheduler();
+
+    static PriorityScheduler& instance() {
+        static PriorityScheduler instance;
+        return instance;
+    }
+
+    // Block until the lane admits another call
+    Slot acquire(Lane lane);
+    // Interactive slot without waiting for the limit, for threads whose own
+    // number bounds how many calls they run
+    Slot admitInteractive();
+    // Run job on one of bulkLimit worker threads, in submission order, each
+    // while holding a bulk slot. Workers start on first use. job must not
+    // throw.
+    void submitBulk(std::function<void()> job);
+    // Yield the innermost slot held by the calling thread, if any
+    static void checkpoint();
+
+    Stats getStats() const;
+
+private:
+    bool interactiveBusy() const { return stats.interactiveRunning + stats.interactiveWaiting > 0; }
+    void release(Lane lane);
+    void runBulkJobs();
+
+    Options options;
+    mutable std::mutex mutex;
+    std::condition_variable changed;
+    Stats stats;
+
+    std::deque<std::function<void()>> bulkJobs;
+    std::condition_variable bulkJobsChanged;
+    std::vector<std::thread> bulkWorkers;
+    bool stopping = false;
+
+    static thread_local Slot* current;
+};
@@ -0,0 +1,78 @@
+#include "PushChannel.hpp"
+#include <algorithm>
+
+std::mutex PushChannel::registryMutex;
+std::unordered_map<std::uint32_t, std::weak_ptr<PushChannel>> PushChannel::registry;
+std::uint32_t PushChannel::nextId = 1;
+
+PushChannel::PushChannel(std::uint32_t id, std::uint32_t window, std::chrono::milliseconds stallTimeout)
+    : id(id)
+    , window(std::max<std::uint32_t>(window, 1))
+    , stallTimeout(stallTimeout)
+{}
+
+std::optional<std::uint32_t> PushChannel::reserve() {
+    std::unique_lock<std::mutex> lock(mutex);
+    const bool ready = credit.wait_for(lock, stallTimeout, [this] {
+        return cancelled || sent - confirmed < window;
+    });
+    if (!ready || cancelled) {
+        // The page went away or stopped reading: give up on the stream
+        cancelled = true;
+        return std::nullopt;
+    }
+    return sent++;
+}
+
+void PushChannel::acknowledge(std::uint32_t sequence) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        // Cumulative; stale or out-of-range acknowledgements are ignored
+        if (sequence >= sent || sequence + 1 <= confirmed) {
+            return;
+        }
+        confirmed = sequence + 1;
+    }
+    credit.notify_all();
+}
+
+void PushChannel::cancel() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        cancelled = true;
+    }
+    credit.notify_all();
+}
+
+bool PushChannel::isCancelled() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return cancelled;
+}
+
+std::uint32_t PushChannel::getUnacknowledged() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sent - confirmed;
+}
+
+std::shared_ptr<PushChannel> PushChannel::open(std::uint32_t window, std::chrono::milliseconds stallTimeout) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    // Drop channels whose producers are gone
+    for (auto it = registry.begin(); it != registry.end();) {
+        it = it->second.expired() ? registry.erase(it) : std::next(it);
+    }
+    const std::uint32_t id = nextId++;
+    auto channel = std::make_shared<PushChannel>(id, window, stallTimeout);
+    registry[id] = channel;
+    return channel;
+}
+
+std::shared_ptr<PushChannel> PushChannel::find(std::uint32_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto it = registry.find(id);
+    return it == registry.end() ? nullptr : it->second.lock();
+}
+
+void PushChannel::close(std::uint32_t id) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    registry.erase(id);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// Flow control for a stream of batches pushed to the page.
+//
+// A producer calls reserve() before sending each batch: it returns the
+// batch's sequence number (0, 1, 2, ...) once fewer than `window` batches
+// are waiting for an acknowledgement, and blocks otherwise. The page
+// acknowledges cumulatively: acknowledge(n) confirms batches 0..n.
+// A stream that is cancelled, or whose page stops acknowledging for
+// stallTimeout, makes reserve() return nothing so the producer can stop.
+//
+// Channels are registered by id so the acknowledgement binding can find
+// the stream a worker is producing.
+class PushChannel {
+public:
+    static constexpr std::uint32_t kDefaultWindow = 4;
+    static constexpr std::chrono::seconds kDefaultStallTimeout{10};
+
+    PushChannel(std::uint32_t id, std::uint32_t window,
+                std::chrono::milliseconds stallTimeout = kDefaultStallTimeout);
+
+    std::optional<std::uint32_t> reserve();
+    void acknowledge(std::uint32_t sequence);
+    void cancel();
+
+    std::uint32_t getId() const { return id; }
+    bool isCancelled() const;
+    // Batches sent but not yet acknowledged
+    std::uint32_t getUnacknowledged() const;
+
+    // Create and register a channel with a fresh id
+    static std::shared_ptr<PushChannel> open(std::uint32_t window,
+                                             std::chrono::milliseconds stallTimeout = kDefaultStallTimeout);
+    static std::shared_ptr<PushChannel> find(std::uint32_t id);
+    // Unregister; producers still holding the channel are unaffected
+    static void close(std::uint32_t id);
+
+private:
+    const std::uint32_t id;
+    const std::uint32_t window;
+    const std::chrono::milliseconds stallTimeout;
+
+    mutable std::mutex mutex;
+    std::condition_variable credit;
+    std::uint32_t sent = 0;      // next sequence number
+    std::uint32_t confirmed = 0; // batches acknowledged
+    bool cancelled = false;
+
+    static std::mutex registryMutex;
+    static std::unordered_map<std::uint32_t, std::weak_ptr<PushChannel>> registry;
+    static std::uint32_t nextId;
+};
@@ -0,0 +1,67 @@
+#include "RequestArena.hpp"
+#include <algorithm>
+#include <vector>
+
+namespace {
+// Arenas kept per thread; nested requests beyond this just allocate a new one
+constexpr size_t kPoolSize = 4;
+
+thread_local std::vector<std::unique_ptr<RequestArena>> pool;
+}
+
+RequestArena::RequestArena(size_t capacity)
+    : capacity(capacity)
+    , buffer(new std::byte[capacity])
+{
+    monotonic.emplace(buffer.get(), capacity, &upstream);
+}
+
+void RequestArena::reset() {
+    const size_t needed = capacity + upstream.bytes;
+    monotonic.reset();
+
+    if (needed > capacity && capacity < kMaxCapacity) {
+        capacity = std::min(needed, kMaxCapacity);
+        buffer.reset(new std::byte[capacity]);
+    }
+    upstream.allocations = 0;
+    upstream.bytes = 0;
+    monotonic.emplace(buffer.get(), capacity, &upstream);
+}
+
+RequestArena::Lease::Lease(std::unique_ptr<RequestArena> arena)
+    : arena(std::move(arena))
+{}
+
+RequestArena::Lease::~Lease() {
+    if (!arena) {
+        return;  // moved from
+    }
+    arena->reset();
+    if (pool.size() < kPoolSize) {
+        pool.push_back(std::move(arena));
+    }
+}
+
+RequestArena::Lease RequestArena::acquire() {
+    if (pool.empty()) {
+        return Lease(std::make_unique<RequestArena>());
+    }
+    auto arena = std::move(pool.back());
+    pool.pop_back();
+    return Lease(std::move(arena));
+}
+
+void* RequestArena::CountingResource::do_allocate(size_t size, size_t alignment) {
+    ++allocations;
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void RequestArena::CountingResource::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+bool RequestArena::CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+// Monotonic arena for the allocations made while answering one request.
+//
+// Everything allocated from resource() is released in one shot by reset().
+// The arena keeps its initial buffer between requests; whenever a request
+// overflows into the upstream heap, the buffer is regrown on reset() so the
+// next request of the same size is served without touching the heap at all.
+class RequestArena {
+public:
+    static constexpr size_t kInitialCapacity = 64 * 1024;
+    // Buffers are not grown past this size; larger requests spill upstream
+    static constexpr size_t kMaxCapacity = 16 * 1024 * 1024;
+
+    explicit RequestArena(size_t capacity = kInitialCapacity);
+
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*monotonic; }
+
+    // Drop every allocation and resize the buffer to the last high-water mark
+    void reset();
+
+    size_t getCapacity() const { return capacity; }
+    // Heap allocations made since the last reset()
+    size_t getUpstreamAllocations() const { return upstream.allocations; }
+
+    // Arena checked out of the calling thread's pool; returned on destruction
+    class Lease {
+    public:
+        explicit Lease(std::unique_ptr<RequestArena> arena);
+        ~Lease();
+
+        Lease(Lease&&) = default;
+        Lease& operator=(Lease&&) = delete;
+
+        std::pmr::memory_resource* resource() { return arena->resource(); }
+        RequestArena& get() { return *arena; }
+
+    private:
+        std::unique_ptr<RequestArena> arena;
+    };
+
+    static Lease acquire();
+
+private:
+    // Forwards to the heap and counts what the monotonic arena asked for
+    class CountingResource : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0;
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+    };
+
+    size_t capacity;
+    std::unique_ptr<std::byte[]> buffer;
+    CountingResource upstream;
+    std::optional<std::pmr::monotonic_buffer_resource> monotonic;
+};
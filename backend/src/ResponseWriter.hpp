@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Object key known at compile time, stored together with its quotes so text
+// writers can copy it verbatim instead of escaping it on every call
+struct JsonKey {
+    std::string_view quoted;
+
+    constexpr std::string_view name() const {
+        return quoted.substr(1, quoted.size() - 2);
+    }
+};
+
+// Event-style interface for serializing response documents. Implementations
+// encode the same object model (objects, arrays, numbers, strings, booleans,
+// null) as
+// JSON text or as a binary format.
+class ResponseWriter {
+public:
+    virtual ~ResponseWriter() = default;
+
+    virtual void beginObject() = 0;
+    virtual void endObject() = 0;
+    virtual void beginArray() = 0;
+    virtual void endArray() = 0;
+
+    virtual void key(JsonKey key) = 0;
+    virtual void key(std::string_view key) = 0;
+
+    virtual void value(double number) = 0;
+    virtual void value(std::int64_t number) = 0;
+    // Exact match for int, which would be ambiguous between the two above
+    void value(int number) { value(static_cast<std::int64_t>(number)); }
+    virtual void value(std::string_view text) = 0;
+    void value(const char* text) { value(std::string_view(text)); }
+    // Named apart from value() so pointers and integers never convert to bool
+    virtual void boolean(bool flag) = 0;
+    virtual void null() = 0;
+};
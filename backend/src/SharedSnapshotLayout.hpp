@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Layout of the POSIX shared-memory segment UniverseDB publishes for
+// external readers (see SharedSnapshotWriter and SharedSnapshotReader).
+// Only fixed-size types and lock-free atomics live in the segment, so any
+// process built from this header can map it.
+//
+// The segment starts with a Header followed by column regions. The header
+// describes two buffers; the writer fills the one not currently published
+// and then bumps the generation, so readers normally never wait. Each
+// buffer also carries a seqlock sequence, odd while it is being written,
+// that lets a reader detect that the writer lapped it and retry.
+//
+// A region of capacity rows holds, one after the other: the five
+// parameters (Ω_m, Ω_Λ, H₀, η, w) as double columns, one double column of
+// timestamps per milestone type in MilestoneType order (NaN where the
+// universe's timeline lacks the milestone), the int32 universe ids and the
+// uint8 ending types (kNoEnding for none).
+namespace SharedSnapshotLayout {
+
+constexpr std::uint64_t kMagic = 0x5041'4e53'534f'4343;  // "CCOSSNAP"
+constexpr std::uint32_t kVersion = 1;
+constexpr size_t kParameterColumns = 5;
+constexpr size_t kMilestoneColumns = 12;
+constexpr std::uint8_t kNoEnding = 0xff;
+constexpr size_t kAlignment = 64;
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "the segment needs address-free 64-bit atomics");
+
+struct Buffer {
+    std::atomic<std::uint64_t> sequence;  // odd while the writer fills the buffer
+    std::atomic<std::uint64_t> offset;    // of the region from the segment start
+    std::atomic<std::uint64_t> capacity;  // rows the region has room for
+    std::atomic<std::uint64_t> count;     // rows published
+};
+
+struct Header {
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t headerSize;
+    std::atomic<std::uint64_t> generation;  // buffers[generation % 2] is current
+    std::atomic<std::uint64_t> size;        // bytes of the segment
+    Buffer buffers[2];
+};
+
+constexpr size_t alignUp(size_t bytes) {
+    return (bytes + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+constexpr size_t headerBytes() {
+    return alignUp(sizeof(Header));
+}
+
+// Byte offsets of the columns within a region of capacity rows
+constexpr size_t parameterOffset(size_t capacity, size_t parameter) {
+    return parameter * capacity * sizeof(double);
+}
+
+constexpr size_t milestoneOffset(size_t capacity, size_t type) {
+    return (kParameterColumns + type) * capacity * sizeof(double);
+}
+
+constexpr size_t idOffset(size_t capacity) {
+    return (kParameterColumns + kMilestoneColumns) * capacity * sizeof(double);
+}
+
+constexpr size_t endingOffset(size_t capacity) {
+    return idOffset(capacity) + capacity * sizeof(std::int32_t);
+}
+
+constexpr size_t regionBytes(size_t capacity) {
+    return alignUp(endingOffset(capacity) + capacity);
+}
+
+} // namespace SharedSnapshotLayout
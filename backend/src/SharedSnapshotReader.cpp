@@ -0,0 +1,111 @@
+#include "SharedSnapshotReader.hpp"
+#include <cerrno>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace SharedSnapshotLayout;
+
+static const void* mapSegment(int fd, size_t& size) {
+    struct stat status;
+    if (fstat(fd, &status) != 0) {
+        throw std::system_error(errno, std::generic_category(), "fstat");
+    }
+    size = static_cast<size_t>(status.st_size);
+    if (size < headerBytes()) {
+        throw std::runtime_error("Shared memory segment is too small for a snapshot");
+    }
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        throw std::system_error(errno, std::generic_category(), "mmap");
+    }
+    return base;
+}
+
+SharedSnapshotReader::SharedSnapshotReader(const std::string& name) {
+    fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "shm_open " + name);
+    }
+    try {
+        base = mapSegment(fd, mapped);
+    } catch (...) {
+        close(fd);
+        throw;
+    }
+
+    const bool valid = header().magic == kMagic;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (!valid || header().version != kVersion || header().headerSize != sizeof(Header)) {
+        munmap(const_cast<void*>(base), mapped);
+        close(fd);
+        throw std::runtime_error(name + " is not a compatible universe snapshot");
+    }
+}
+
+SharedSnapshotReader::~SharedSnapshotReader() {
+    munmap(const_cast<void*>(base), mapped);
+    close(fd);
+}
+
+std::uint64_t SharedSnapshotReader::getGeneration() const {
+    return header().generation.load(std::memory_order_acquire);
+}
+
+void SharedSnapshotReader::remap() {
+    size_t size = 0;
+    const void* remapped = mapSegment(fd, size);
+    munmap(const_cast<void*>(base), mapped);
+    base = remapped;
+    mapped = size;
+}
+
+bool SharedSnapshotReader::begin(View& view, std::uint64_t& sequence) {
+    view.generation = header().generation.load(std::memory_order_acquire);
+    view.buffer = view.generation % 2;
+    const Buffer& buffer = header().buffers[view.buffer];
+    sequence = buffer.sequence.load(std::memory_order_acquire);
+    // The writer may have lapped us between the two loads, leaving a newer
+    // generation in the buffer than the one we picked it for
+    if ((sequence & 1) || header().generation.load(std::memory_order_acquire) != view.generation) {
+        return false;
+    }
+
+    const size_t offset = buffer.offset.load(std::memory_order_relaxed);
+    const size_t capacity = buffer.capacity.load(std::memory_order_relaxed);
+    view.count = buffer.count.load(std::memory_order_relaxed);
+    if (view.generation == 0) {
+        // Nothing published yet
+        view = View{0, 0, 0, {}, {}, nullptr, nullptr};
+        return true;
+    }
+    if (offset + regionBytes(capacity) > mapped) {
+        if (header().size.load(std::memory_order_acquire) > mapped) {
+            remap();
+        }
+        return false;
+    }
+    // Torn values are caught by validate(), but must stay inside the region
+    if (view.count > capacity || offset < headerBytes()) {
+        return false;
+    }
+
+    const char* region = static_cast<const char*>(base) + offset;
+    for (size_t p = 0; p < kParameterColumns; ++p) {
+        view.parameters[p] = reinterpret_cast<const double*>(region + parameterOffset(capacity, p));
+    }
+    for (size_t m = 0; m < kMilestoneColumns; ++m) {
+        view.milestones[m] = reinterpret_cast<const double*>(region + milestoneOffset(capacity, m));
+    }
+    view.ids = reinterpret_cast<const std::int32_t*>(region + idOffset(capacity));
+    view.endings = reinterpret_cast<const std::uint8_t*>(region + endingOffset(capacity));
+    return true;
+}
+
+bool SharedSnapshotReader::validate(const View& view, std::uint64_t sequence) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return header().buffers[view.buffer].sequence.load(std::memory_order_relaxed) == sequence;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "SharedSnapshotLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+// Read-only client of a segment published by UniverseDB, for analysis
+// processes. Attaching maps the segment; reads go straight to the mapped
+// columns without copying or parsing. Depends on nothing but this header
+// and SharedSnapshotLayout.hpp (library target cosmic_snapshot_reader).
+//
+//   SharedSnapshotReader reader("/cosmic");
+//   double sum = reader.read([](const SharedSnapshotReader::View& view) {
+//       double total = 0;
+//       for (size_t row = 0; row < view.count; ++row) total += view.parameters[2][row];
+//       return total;
+//   });
+//
+// A reader is not thread-safe; use one per thread.
+class SharedSnapshotReader {
+public:
+    // Columns of one consistent generation, valid during read()
+    struct View {
+        std::uint64_t generation;
+        size_t buffer;  // which of the two header buffers holds it
+        size_t count;
+        const double* parameters[SharedSnapshotLayout::kParameterColumns];
+        const double* milestones[SharedSnapshotLayout::kMilestoneColumns];
+        const std::int32_t* ids;
+        const std::uint8_t* endings;
+    };
+
+    // Attach to the named segment; throws std::system_error when it does
+    // not exist and std::runtime_error when it is not a snapshot
+    explicit SharedSnapshotReader(const std::string& name);
+    ~SharedSnapshotReader();
+
+    SharedSnapshotReader(const SharedSnapshotReader&) = delete;
+    SharedSnapshotReader& operator=(const SharedSnapshotReader&) = delete;
+
+    // Call visit(view) on the current generation and return its result.
+    // When the writer overwrites the buffer meanwhile, visit is called
+    // again on the newer data, so it must not act on a view before it
+    // returns: only the result of the last call is kept.
+    template <typename Visit>
+    auto read(Visit&& visit) {
+        for (;;) {
+            View view;
+            std::uint64_t sequence;
+            if (!begin(view, sequence)) {
+                std::this_thread::yield();
+                continue;
+            }
+            if constexpr (std::is_void_v<decltype(visit(view))>) {
+                visit(view);
+                if (validate(view, sequence)) {
+                    return;
+                }
+            } else {
+                auto result = visit(view);
+                if (validate(view, sequence)) {
+                    return result;
+                }
+            }
+        }
+    }
+
+    // Generation published most recently; increases with every publish
+    std::uint64_t getGeneration() const;
+
+private:
+    const SharedSnapshotLayout::Header& header() const {
+        return *static_cast<const SharedSnapshotLayout::Header*>(base);
+    }
+    // Set up view on the current buffer; false when the reader must retry
+    bool begin(View& view, std::uint64_t& sequence);
+    // Whether the buffer behind view was left alone since begin()
+    bool validate(const View& view, std::uint64_t sequence) const;
+    // Follow the writer after it grew the segment
+    void remap();
+
+    int fd = -1;
+    const void* base = nullptr;
+    size_t mapped = 0;
+};
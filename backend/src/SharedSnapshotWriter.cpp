@@ -0,0 +1,118 @@
+#include "SharedSnapshotWriter.hpp"
+#include "Milestone.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <system_error>
+#include <unistd.h>
+
+using namespace SharedSnapshotLayout;
+
+static_assert(kMilestoneColumns == kMilestoneTypeCount, "one timestamp column per milestone type");
+
+static std::system_error systemError(const std::string& what) {
+    return std::system_error(errno, std::generic_category(), what);
+}
+
+SharedSnapshotWriter::SharedSnapshotWriter(std::string name)
+    : name(std::move(name))
+{
+    fd = shm_open(this->name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw systemError("shm_open " + this->name);
+    }
+    mapped = headerBytes();
+    if (ftruncate(fd, mapped) != 0) {
+        const auto error = systemError("ftruncate " + this->name);
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw error;
+    }
+    base = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        const auto error = systemError("mmap " + this->name);
+        close(fd);
+        shm_unlink(this->name.c_str());
+        throw error;
+    }
+
+    Header* created = new (base) Header{};
+    created->version = kVersion;
+    created->headerSize = static_cast<std::uint32_t>(sizeof(Header));
+    created->size.store(mapped, std::memory_order_relaxed);
+    // Readers refuse the segment until the magic shows up
+    std::atomic_thread_fence(std::memory_order_release);
+    created->magic = kMagic;
+}
+
+SharedSnapshotWriter::~SharedSnapshotWriter() {
+    munmap(base, mapped);
+    close(fd);
+    shm_unlink(name.c_str());
+}
+
+std::uint64_t SharedSnapshotWriter::getGeneration() const {
+    return header().generation.load(std::memory_order_relaxed);
+}
+
+size_t SharedSnapshotWriter::grow(size_t bytes) {
+    const size_t offset = mapped;
+    const size_t size = mapped + bytes;
+    if (ftruncate(fd, size) != 0) {
+        throw systemError("ftruncate " + name);
+    }
+    void* remapped = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (remapped == MAP_FAILED) {
+        throw systemError("mmap " + name);
+    }
+    munmap(base, mapped);
+    base = remapped;
+    mapped = size;
+    header().size.store(size, std::memory_order_release);
+    return offset;
+}
+
+void SharedSnapshotWriter::publish(size_t count, const std::function<void(const Columns&)>& fill) {
+    const std::uint64_t generation = header().generation.load(std::memory_order_relaxed);
+    const size_t spare = (generation + 1) % 2;
+
+    // The old region of the spare buffer is abandoned when it is too small;
+    // geometric growth keeps the holes below the live data in total
+    size_t offset = header().buffers[spare].offset.load(std::memory_order_relaxed);
+    size_t capacity = header().buffers[spare].capacity.load(std::memory_order_relaxed);
+    if (capacity < count) {
+        capacity = std::max<size_t>({count, 2 * capacity, 1024});
+        offset = grow(regionBytes(capacity));
+    }
+
+    Buffer& buffer = header().buffers[spare];
+    const std::uint64_t sequence = buffer.sequence.load(std::memory_order_relaxed);
+    buffer.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    buffer.offset.store(offset, std::memory_order_relaxed);
+    buffer.capacity.store(capacity, std::memory_order_relaxed);
+    buffer.count.store(count, std::memory_order_relaxed);
+
+    char* region = static_cast<char*>(base) + offset;
+    Columns columns;
+    for (size_t p = 0; p < kParameterColumns; ++p) {
+        columns.parameters[p] = reinterpret_cast<double*>(region + parameterOffset(capacity, p));
+    }
+    for (size_t m = 0; m < kMilestoneColumns; ++m) {
+        columns.milestones[m] = reinterpret_cast<double*>(region + milestoneOffset(capacity, m));
+    }
+    columns.ids = reinterpret_cast<std::int32_t*>(region + idOffset(capacity));
+    columns.endings = reinterpret_cast<std::uint8_t*>(region + endingOffset(capacity));
+    try {
+        fill(columns);
+    } catch (...) {
+        // Leave the buffer even again; it is not made current
+        buffer.sequence.store(sequence + 2, std::memory_order_release);
+        throw;
+    }
+
+    buffer.sequence.store(sequence + 2, std::memory_order_release);
+    header().generation.store(generation + 1, std::memory_order_release);
+}
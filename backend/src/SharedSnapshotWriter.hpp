@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SharedSnapshotLayout.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Owner of a shared-memory segment in the SharedSnapshotLayout format.
+// Creates (or takes over) the POSIX shm object on construction and unlinks
+// it on destruction. Only one writer may exist per name; publish() is not
+// thread-safe.
+class SharedSnapshotWriter {
+public:
+    // Column pointers into the buffer being filled
+    struct Columns {
+        double* parameters[SharedSnapshotLayout::kParameterColumns];
+        double* milestones[SharedSnapshotLayout::kMilestoneColumns];
+        std::int32_t* ids;
+        std::uint8_t* endings;
+    };
+
+    // name is a POSIX shm name such as "/cosmic"; throws std::system_error
+    explicit SharedSnapshotWriter(std::string name);
+    ~SharedSnapshotWriter();
+
+    SharedSnapshotWriter(const SharedSnapshotWriter&) = delete;
+    SharedSnapshotWriter& operator=(const SharedSnapshotWriter&) = delete;
+
+    // Fill the spare buffer with count rows, then make it current. Regions
+    // grow geometrically at the end of the segment when count outgrows them.
+    void publish(size_t count, const std::function<void(const Columns&)>& fill);
+
+    const std::string& getName() const { return name; }
+    std::uint64_t getGeneration() const;
+    size_t getSize() const { return mapped; }
+
+private:
+    SharedSnapshotLayout::Header& header() const {
+        return *static_cast<SharedSnapshotLayout::Header*>(base);
+    }
+    // Extend the segment by bytes and return the offset of the new space
+    size_t grow(size_t bytes);
+
+    std::string name;
+    int fd = -1;
+    void* base = nullptr;
+    size_t mapped = 0;
+};
@@ -1,5 +1,6 @@
 #include "SimulatedUniverse.hpp"
 #include "MilestoneTypes.hpp"
+#include "JsonWriter.hpp"
 #include <memory>
 #include <cmath>
 #include <sstream>
@@ -8,55 +9,87 @@ SimulatedUniverse::SimulatedUniverse(std::string name, double matterDensity, dou
                                    double hubbleConstant, double matterAntimatterRatio, double darkEnergyW)
     : Universe(matterDensity, darkEnergyDensity, hubbleConstant, 
               matterAntimatterRatio, darkEnergyW, std::move(name)) {
+    const ParameterKey key(matterDensity, darkEnergyDensity, hubbleConstant,
+                           matterAntimatterRatio, darkEnergyW);
+    computed = TimelineCache::instance().intern(key, [this] {
+        UniverseParameters params(this->matterDensity, this->darkEnergyDensity, this->hubbleConstant,
+                                  this->matterAntimatterRatio, this->darkEnergyW);
+        return std::make_shared<const ComputedTimeline>(params, milestoneTypes(), ending());
+    });
+}
+
+MilestoneFormulas::ParameterMask SimulatedUniverse::setParameters(const UniverseParameters& params) {
+    const MilestoneFormulas::ParameterMask changed = MilestoneFormulas::changedParameters(parameters(), params);
+    if (!changed) {
+        return 0;
+    }
+    matterDensity = params.getMatterDensity();
+    darkEnergyDensity = params.getDarkEnergyDensity();
+    hubbleConstant = params.getHubbleConstant();
+    matterAntimatterRatio = params.getMatterAntimatterRatio();
+    darkEnergyW = params.getDarkEnergyW();
+    curvatureParameter = 1.0 - (matterDensity + darkEnergyDensity);
+
+    const ParameterKey key(matterDensity, darkEnergyDensity, hubbleConstant,
+                           matterAntimatterRatio, darkEnergyW);
+    const std::shared_ptr<const ComputedTimeline> previous = computed;
+    computed = TimelineCache::instance().intern(key, [&] {
+        return std::make_shared<const ComputedTimeline>(params, milestoneTypes(params), ending(params),
+                                                        *previous, changed);
+    });
+    return changed;
 }
 
 std::unique_ptr<Timeline> SimulatedUniverse::generateTimeline() const {
-    auto timeline = std::make_unique<Timeline>();
+    return std::make_unique<Timeline>(buildTimeline(std::pmr::get_default_resource()));
+}
+
+Timeline SimulatedUniverse::buildTimeline(std::pmr::memory_resource* resource) const {
+    Timeline timeline(resource);
+    const MilestoneSequence types = milestoneTypes();
+    timeline.reserve(types.size());
     UniverseParameters params(matterDensity, darkEnergyDensity, hubbleConstant, 
                             matterAntimatterRatio, darkEnergyW);
-    
-    // Always add Big Bang at t=0
-    timeline->addMilestone(createMilestone(MilestoneType::BigBang, params));
-    
-    // Early universe events
-    timeline->addMilestone(createMilestone(MilestoneType::Inflation, params));
-    timeline->addMilestone(createMilestone(MilestoneType::ParticleEra, params));
-    timeline->addMilestone(createMilestone(MilestoneType::NucleosynthesisBBN, params));
-    
-    // Matter formation events
-    timeline->addMilestone(createMilestone(MilestoneType::Recombination, params));
-    timeline->addMilestone(createMilestone(MilestoneType::DarkAges, params));
-    
-    // Structure formation events (if conditions allow)
-    if (matterDensity >= 0.1) {  // Minimum matter density for star formation
-        timeline->addMilestone(createMilestone(MilestoneType::FirstStars, params));
-        timeline->addMilestone(createMilestone(MilestoneType::GalaxyFormation, params));
-    }
-    
-    // Future events based on universe parameters
-    if (willUndergoAcceleration()) {
-        timeline->addMilestone(createMilestone(MilestoneType::AcceleratedExpansion, params));
-        
-        if (willUndergoRip()) {
-            // Universe ends in Big Rip
-            double ripTime = calculateRipTime();
-            if (ripTime > 0) {
-                timeline->addMilestone(createMilestone(MilestoneType::BigRip, params));
-            }
-        } else {
-            // Universe expands forever and ends in Heat Death
-            timeline->addMilestone(createMilestone(MilestoneType::HeatDeath, params));
-        }
-    } else if (willUndergoCollapse()) {
-        // Universe ends in Big Crunch
-        timeline->addMilestone(createMilestone(MilestoneType::BigCrunch, params));
+    for (MilestoneType type : types) {
+        timeline.addMilestone(createMilestone(resource, type, params));
     }
-    
     return timeline;
 }
 
-std::unique_ptr<Milestone> SimulatedUniverse::createMilestone(MilestoneType type, const UniverseParameters& params) const {
-    return ::createMilestone(type, params);
+MilestoneSequence SimulatedUniverse::milestoneTypes() const {
+    return milestoneTypes(parameters());
+}
+
+LazyTimeline SimulatedUniverse::lazyTimeline() const {
+    UniverseParameters params(matterDensity, darkEnergyDensity, hubbleConstant,
+                            matterAntimatterRatio, darkEnergyW);
+    return LazyTimeline(params, milestoneTypes());
+}
+
+std::vector<MilestoneFormulas::TimestampGradient> SimulatedUniverse::timestampJacobian() const {
+    UniverseParameters params(matterDensity, darkEnergyDensity, hubbleConstant,
+                            matterAntimatterRatio, darkEnergyW);
+    const MilestoneSequence types = milestoneTypes();
+    std::vector<MilestoneFormulas::TimestampGradient> rows;
+    rows.reserve(types.size());
+    for (MilestoneType type : types) {
+        rows.push_back(MilestoneFormulas::timestampGradient(type, params));
+    }
+    return rows;
+}
+
+std::optional<MilestoneType> SimulatedUniverse::ending() const {
+    return ending(parameters());
+}
+
+UniverseParameters SimulatedUniverse::parameters() const {
+    return UniverseParameters(matterDensity, darkEnergyDensity, hubbleConstant,
+                              matterAntimatterRatio, darkEnergyW);
+}
+
+MilestonePtr SimulatedUniverse::createMilestone(std::pmr::memory_resource* resource, MilestoneType type,
+                                                const UniverseParameters& params) const {
+    return ::createMilestone(type, params, resource);
 }
 
 std::string SimulatedUniverse::selectAssetForMilestone(MilestoneType type) const {
@@ -91,20 +124,39 @@ std::string SimulatedUniverse::selectAssetForMilestone(MilestoneType type) const
 }
 
 std::string SimulatedUniverse::toJSON() const {
-    nlohmann::json j;
-    // Basic universe properties
-    j["name"] = getName();
-    j["matterDensity"] = getMatterDensity();
-    j["darkEnergyDensity"] = getDarkEnergyDensity();
-    j["hubbleConstant"] = getHubbleConstant();
-    j["matterAntimatterRatio"] = getMatterAntimatterRatio();
-    j["darkEnergyW"] = getDarkEnergyW();
-    
+    JsonWriter writer(4);
+    write(writer);
+    return std::string(writer.str());
+}
+
+void SimulatedUniverse::write(ResponseWriter& writer, std::pmr::memory_resource* resource) const {
+    static constexpr JsonKey kDarkEnergyDensity{"\"darkEnergyDensity\""};
+    static constexpr JsonKey kDarkEnergyW{"\"darkEnergyW\""};
+    static constexpr JsonKey kHubbleConstant{"\"hubbleConstant\""};
+    static constexpr JsonKey kMatterAntimatterRatio{"\"matterAntimatterRatio\""};
+    static constexpr JsonKey kMatterDensity{"\"matterDensity\""};
+    static constexpr JsonKey kName{"\"name\""};
+    static constexpr JsonKey kTimeline{"\"timeline\""};
+
+    // Keys are emitted in sorted order to match the nlohmann DOM output
+    writer.beginObject();
+    writer.key(kDarkEnergyDensity);
+    writer.value(darkEnergyDensity);
+    writer.key(kDarkEnergyW);
+    writer.value(darkEnergyW);
+    writer.key(kHubbleConstant);
+    writer.value(hubbleConstant);
+    writer.key(kMatterAntimatterRatio);
+    writer.value(matterAntimatterRatio);
+    writer.key(kMatterDensity);
+    writer.value(matterDensity);
+    writer.key(kName);
+    writer.value(name);
+
     // Generate and add timeline
-    auto timeline = generateTimeline();
-    j["timeline"] = timeline->toJson();
-    
-    return j.dump(4);
+    writer.key(kTimeline);
+    buildTimeline(resource).write(writer);
+    writer.endObject();
 }
 
 std::string SimulatedUniverse::toCSV() const {
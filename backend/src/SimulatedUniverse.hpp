@@ -3,9 +3,15 @@
 
 #include "Universe.hpp"
 #include "Timeline.hpp"
+#include "LazyTimeline.hpp"
+#include "MilestoneFormulas.hpp"
+#include "TimelineCache.hpp"
 #include "IExportable.hpp"
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
+#include <vector>
 
 class SimulatedUniverse : public Universe, public IExportable {
 public:
@@ -15,31 +21,116 @@ public:
     // Implementation of pure virtual method from Universe
     std::unique_ptr<Timeline> generateTimeline() const override;
 
+    // Build the timeline with all milestones allocated from the given resource
+    Timeline buildTimeline(std::pmr::memory_resource* resource) const;
+
+    // Milestone types the timeline consists of, in order
+    MilestoneSequence milestoneTypes() const;
+    // Timeline that evaluates milestone fields only when they are read
+    LazyTimeline lazyTimeline() const;
+    // Final milestone (BigRip, HeatDeath or BigCrunch), if the universe has one.
+    // Cheaper than building any timeline.
+    std::optional<MilestoneType> ending() const;
+    // Same as above for arbitrary parameters, without constructing a
+    // universe; usable in constant expressions
+    static constexpr MilestoneSequence milestoneTypes(const UniverseParameters& params);
+    static constexpr std::optional<MilestoneType> ending(const UniverseParameters& params);
+    // d(timestamp)/d(parameter) for every timeline milestone, one row each
+    std::vector<MilestoneFormulas::TimestampGradient> timestampJacobian() const;
+
+    // Replace the parameters. Timestamps that depend on none of the changed
+    // parameters are carried over instead of recomputed. Returns the mask of
+    // parameters that actually changed.
+    MilestoneFormulas::ParameterMask setParameters(const UniverseParameters& params);
+    UniverseParameters parameters() const;
+
+    // Timeline record shared with all universes of identical parameters
+    const ComputedTimeline& getComputedTimeline() const { return *computed; }
+
     // Implementation of IExportable interface
     std::string toJSON() const override;
     std::string toCSV() const override;
 
+    // Stream the toJSON() document into a writer, e.g. as an array element
+    void write(ResponseWriter& writer,
+               std::pmr::memory_resource* resource = std::pmr::get_default_resource()) const;
+
 private:
+    std::shared_ptr<const ComputedTimeline> computed;
+
     // Helper methods for milestone creation
-    std::unique_ptr<Milestone> createMilestone(MilestoneType type, const UniverseParameters& params) const;
+    MilestonePtr createMilestone(std::pmr::memory_resource* resource, MilestoneType type,
+                                 const UniverseParameters& params) const;
     std::string selectAssetForMilestone(MilestoneType type) const;
 
-    bool willUndergoAcceleration() const {
-        return darkEnergyDensity > 0;
+    static constexpr bool willUndergoAcceleration(const UniverseParameters& params) {
+        return params.getDarkEnergyDensity() > 0;
     }
     
-    bool willUndergoRip() const {
-        return darkEnergyW < -1;
+    static constexpr bool willUndergoRip(const UniverseParameters& params) {
+        return params.getDarkEnergyW() < -1;
     }
     
-    bool willUndergoCollapse() const {
-        return matterDensity > 1.0 && darkEnergyDensity < 0.7;
+    static constexpr bool willUndergoCollapse(const UniverseParameters& params) {
+        return params.getMatterDensity() > 1.0 && params.getDarkEnergyDensity() < 0.7;
     }
     
-    double calculateRipTime() const {
-        if (!willUndergoRip()) return -1;
-        return 2.0 / (3.0 * std::abs(1.0 + darkEnergyW) * hubbleConstant);
+    static constexpr double calculateRipTime(const UniverseParameters& params) {
+        if (!willUndergoRip(params)) return -1;
+        // |1 + w| for w < -1
+        return 2.0 / (3.0 * -(1.0 + params.getDarkEnergyW()) * params.getHubbleConstant());
     }
 };
 
+constexpr MilestoneSequence SimulatedUniverse::milestoneTypes(const UniverseParameters& params) {
+    MilestoneSequence types;
+
+    // Always add Big Bang at t=0
+    types.push_back(MilestoneType::BigBang);
+    
+    // Early universe events
+    types.push_back(MilestoneType::Inflation);
+    types.push_back(MilestoneType::ParticleEra);
+    types.push_back(MilestoneType::NucleosynthesisBBN);
+    
+    // Matter formation events
+    types.push_back(MilestoneType::Recombination);
+    types.push_back(MilestoneType::DarkAges);
+    
+    // Structure formation events (if conditions allow)
+    if (params.getMatterDensity() >= 0.1) {  // Minimum matter density for star formation
+        types.push_back(MilestoneType::FirstStars);
+        types.push_back(MilestoneType::GalaxyFormation);
+    }
+    
+    // Future events based on universe parameters
+    if (willUndergoAcceleration(params)) {
+        types.push_back(MilestoneType::AcceleratedExpansion);
+    }
+    if (auto end = ending(params)) {
+        types.push_back(*end);
+    }
+    
+    return types;
+}
+
+constexpr std::optional<MilestoneType> SimulatedUniverse::ending(const UniverseParameters& params) {
+    if (willUndergoAcceleration(params)) {
+        if (willUndergoRip(params)) {
+            // Universe ends in Big Rip
+            if (calculateRipTime(params) > 0) {
+                return MilestoneType::BigRip;
+            }
+            return std::nullopt;
+        }
+        // Universe expands forever and ends in Heat Death
+        return MilestoneType::HeatDeath;
+    }
+    if (willUndergoCollapse(params)) {
+        // Universe ends in Big Crunch
+        return MilestoneType::BigCrunch;
+    }
+    return std::nullopt;
+}
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,34 @@
+#include "StringArena.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+StringArena::Ref StringArena::append(std::string_view text) {
+    if (text.size() > kMaxLength) {
+        throw std::length_error("String of " + std::to_string(text.size()) + " bytes exceeds the arena limit");
+    }
+    if (text.empty()) {
+        return {};
+    }
+    if (used + text.size() > kChunkSize) {
+        if (chunks.size() == kMaxChunks) {
+            throw std::length_error("String arena is full");
+        }
+        chunks.emplace_back(new char[kChunkSize]);
+        used = 0;
+    }
+
+    Ref ref;
+    ref.offset = static_cast<std::uint32_t>((chunks.size() - 1) * kChunkSize + used);
+    ref.length = static_cast<std::uint16_t>(text.size());
+    std::memcpy(chunks.back().get() + used, text.data(), text.size());
+    used += text.size();
+    size += text.size();
+    return ref;
+}
+
+StringArena::View StringArena::view() const {
+    View view;
+    view.chunks.assign(chunks.begin(), chunks.end());
+    return view;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+// Append-only storage for many short strings, referenced by a 32-bit offset
+// and a 16-bit length instead of one heap block per string.
+//
+// Strings are copied into fixed-size chunks and never move or get freed
+// individually, so views returned by get() stay valid for the lifetime of
+// the arena. A string never straddles two chunks; the tail of a chunk that
+// is too short for the next string is skipped. A View shares the chunks
+// written so far and stays readable while the arena keeps growing.
+class StringArena {
+public:
+    static constexpr size_t kChunkSize = 1 << 20;
+    static constexpr size_t kMaxLength = UINT16_MAX;
+    // Offsets are 32 bits wide
+    static constexpr size_t kMaxChunks = (size_t{1} << 32) / kChunkSize;
+
+    struct Ref {
+        std::uint32_t offset = 0;
+        std::uint16_t length = 0;
+    };
+
+    class View {
+    public:
+        // For refs the arena handed out before view() was taken
+        std::string_view get(Ref ref) const { return read(chunks, ref); }
+
+    private:
+        friend class StringArena;
+        std::vector<std::shared_ptr<const char[]>> chunks;
+    };
+
+    StringArena() = default;
+    StringArena(const StringArena&) = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&&) = default;
+    StringArena& operator=(StringArena&&) = default;
+
+    // Copy text into the arena; throws std::length_error when the text is
+    // longer than kMaxLength or the arena is full
+    Ref append(std::string_view text);
+
+    std::string_view get(Ref ref) const { return read(chunks, ref); }
+    View view() const;
+
+    // Bytes of string data stored, and bytes reserved for it
+    size_t getSize() const { return size; }
+    size_t getCapacity() const { return chunks.size() * kChunkSize; }
+
+private:
+    template <typename Chunks>
+    static std::string_view read(const Chunks& chunks, Ref ref) {
+        if (ref.length == 0) {
+            return {};
+        }
+        return {chunks[ref.offset / kChunkSize].get() + ref.offset % kChunkSize, ref.length};
+    }
+
+    std::vector<std::shared_ptr<char[]>> chunks;
+    size_t used = kChunkSize;  // bytes used in the last chunk
+    size_t size = 0;
+};
@@ -1,15 +1,24 @@
 #include "Timeline.hpp"
+#include "JsonWriter.hpp"
 #include <fstream>
 
-void Timeline::addMilestone(std::unique_ptr<Milestone> milestone) {
+Timeline::Timeline(std::pmr::memory_resource* resource)
+    : milestones(resource)
+{}
+
+void Timeline::addMilestone(MilestonePtr milestone) {
     milestones.push_back(std::move(milestone));
 }
 
+void Timeline::reserve(size_t count) {
+    milestones.reserve(count);
+}
+
 void Timeline::clear() {
     milestones.clear();
 }
 
-const std::vector<std::unique_ptr<Milestone>>& Timeline::getMilestones() const {
+const std::pmr::vector<MilestonePtr>& Timeline::getMilestones() const {
     return milestones;
 }
 
@@ -22,13 +31,28 @@ nlohmann::json Timeline::toJson() const {
     return j;
 }
 
+void Timeline::write(ResponseWriter& writer) const {
+    static constexpr JsonKey kMilestones{"\"milestones\""};
+
+    writer.beginObject();
+    writer.key(kMilestones);
+    writer.beginArray();
+    for (const auto& milestone : milestones) {
+        milestone->write(writer);
+    }
+    writer.endArray();
+    writer.endObject();
+}
+
 bool Timeline::saveToFile(const std::string& filename) const {
     try {
         std::ofstream file(filename);
         if (!file.is_open()) {
             return false;
         }
-        file << toJson().dump(4);
+        JsonWriter writer(4);
+        write(writer);
+        file << writer.str();
         return true;
     } catch (...) {
         return false;
@@ -2,24 +2,32 @@
 
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include "Milestone.hpp"
 
 class Timeline {
 public:
     Timeline() = default;
+
+    // Keep the milestone list in memory from the given resource
+    explicit Timeline(std::pmr::memory_resource* resource);
     
-    void addMilestone(std::unique_ptr<Milestone> milestone);
+    void addMilestone(MilestonePtr milestone);
+    void reserve(size_t count);
     void clear();
     
     // Get milestones
-    const std::vector<std::unique_ptr<Milestone>>& getMilestones() const;
+    const std::pmr::vector<MilestonePtr>& getMilestones() const;
     
     // Export timeline to JSON
     nlohmann::json toJson() const;
+
+    // Stream the same document as toJson() into a writer
+    void write(ResponseWriter& writer) const;
     
     // Save timeline to file
     bool saveToFile(const std::string& filename) const;
 
 private:
-    std::vector<std::unique_ptr<Milestone>> milestones;
+    std::pmr::vector<MilestonePtr> milestones;
 }; 
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "TimelineCache.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+std::uint64_t canonicalBits(double value) {
+    if (value == 0.0) {
+        value = 0.0;  // -0.0 and 0.0 describe the same universe
+    }
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+}
+
+ParameterKey::ParameterKey(double matterDensity, double darkEnergyDensity, double hubbleConstant,
+                           double matterAntimatterRatio, double darkEnergyW)
+    : bits{canonicalBits(matterDensity), canonicalBits(darkEnergyDensity), canonicalBits(hubbleConstant),
+           canonicalBits(matterAntimatterRatio), canonicalBits(darkEnergyW)}
+{}
+
+size_t ParameterKeyHash::operator()(const ParameterKey& key) const {
+    // splitmix64 finalizer over each word, combined like boost::hash_combine
+    size_t seed = 0;
+    for (std::uint64_t word : key.bits) {
+        word ^= word >> 30;
+        word *= 0xbf58476d1ce4e5b9ULL;
+        word ^= word >> 27;
+        word *= 0x94d049bb133111ebULL;
+        word ^= word >> 31;
+        seed ^= static_cast<size_t>(word) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+    return seed;
+}
+
+std::atomic<size_t> ComputedTimeline::live{0};
+
+ComputedTimeline::ComputedTimeline(const UniverseParameters& params, const MilestoneSequence& types,
+                                   std::optional<MilestoneType> ending)
+    : lazy(params, types)
+    , ending(ending)
+{
+    live.fetch_add(1, std::memory_order_relaxed);
+}
+
+ComputedTimeline::ComputedTimeline(const UniverseParameters& params, const MilestoneSequence& types,
+                                   std::optional<MilestoneType> ending, const ComputedTimeline& previous,
+                                   MilestoneFormulas::ParameterMask changed)
+    : lazy(previous.evaluatedTimeline() ? LazyTimeline(params, types, previous.lazy, changed)
+                                        : LazyTimeline(params, types))
+    , ending(ending)
+{
+    live.fetch_add(1, std::memory_order_relaxed);
+}
+
+ComputedTimeline::~ComputedTimeline() {
+    live.fetch_sub(1, std::memory_order_relaxed);
+}
+
+const LazyTimeline& ComputedTimeline::timeline() const {
+    // Fill the timestamp cache once so later reads never write to it
+    std::call_once(evaluated, [this] {
+        for (size_t i = 0; i < lazy.size(); ++i) {
+            lazy.timestampAt(i);
+        }
+        ready.store(true, std::memory_order_release);
+    });
+    return lazy;
+}
+
+const LazyTimeline* ComputedTimeline::evaluatedTimeline() const {
+    return ready.load(std::memory_order_acquire) ? &lazy : nullptr;
+}
+
+TimelineCache::Stats TimelineCache::getStats() const {
+    return {lookups.load(std::memory_order_relaxed), hits.load(std::memory_order_relaxed),
+            ComputedTimeline::liveCount()};
+}
+
+void TimelineCache::sweepIfNeeded() {
+    if (records.size() < sweepThreshold) {
+        return;
+    }
+    for (auto it = records.begin(); it != records.end();) {
+        if (it->second.expired()) {
+            it = records.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    sweepThreshold = std::max<size_t>(1024, records.size() * 2);
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "LazyTimeline.hpp"
+#include "UniverseParameters.hpp"
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// Canonical form of the five parameters a timeline depends on. Doubles are
+// compared bit for bit after folding -0.0 into 0.0.
+struct ParameterKey {
+    std::array<std::uint64_t, 5> bits;
+
+    ParameterKey(double matterDensity, double darkEnergyDensity, double hubbleConstant,
+                 double matterAntimatterRatio, double darkEnergyW);
+
+    bool operator==(const ParameterKey& other) const { return bits == other.bits; }
+};
+
+struct ParameterKeyHash {
+    size_t operator()(const ParameterKey& key) const;
+};
+
+// Immutable timeline shared by every universe with the same parameters.
+// Milestones are evaluated once, on first use, and then only read.
+class ComputedTimeline {
+public:
+    ComputedTimeline(const UniverseParameters& params, const MilestoneSequence& types,
+                     std::optional<MilestoneType> ending);
+    // Record for edited parameters reusing the timestamps of previous that
+    // do not depend on the changed parameters
+    ComputedTimeline(const UniverseParameters& params, const MilestoneSequence& types,
+                     std::optional<MilestoneType> ending, const ComputedTimeline& previous,
+                     MilestoneFormulas::ParameterMask changed);
+    ~ComputedTimeline();
+
+    ComputedTimeline(const ComputedTimeline&) = delete;
+    ComputedTimeline& operator=(const ComputedTimeline&) = delete;
+
+    // Fully evaluated timeline; safe to read from any thread
+    const LazyTimeline& timeline() const;
+    std::optional<MilestoneType> getEnding() const { return ending; }
+    // The timeline if it has been evaluated already, otherwise nullptr
+    const LazyTimeline* evaluatedTimeline() const;
+
+    // Records currently alive, i.e. distinct parameter sets in use
+    static size_t liveCount() { return live.load(std::memory_order_relaxed); }
+
+private:
+    LazyTimeline lazy;
+    std::optional<MilestoneType> ending;
+    mutable std::once_flag evaluated;
+    mutable std::atomic<bool> ready{false};
+
+    static std::atomic<size_t> live;
+};
+
+// Hash-consing table from parameter keys to shared timeline records.
+// Entries hold weak references, so a record lives exactly as long as some
+// universe uses it; expired entries are swept as the table grows.
+class TimelineCache {
+public:
+    struct Stats {
+        size_t lookups;
+        size_t hits;
+        size_t distinct;
+    };
+
+    static TimelineCache& instance() {
+        static TimelineCache instance;
+        return instance;
+    }
+
+    TimelineCache(const TimelineCache&) = delete;
+    TimelineCache& operator=(const TimelineCache&) = delete;
+
+    // Return the shared record for key, creating it with make() on a miss
+    template <typename Make>
+    std::shared_ptr<const ComputedTimeline> intern(const ParameterKey& key, Make&& make) {
+        lookups.fetch_add(1, std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = records[key];
+        if (auto existing = entry.lock()) {
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return existing;
+        }
+        std::shared_ptr<const ComputedTimeline> created = make();
+        entry = created;
+        sweepIfNeeded();
+        return created;
+    }
+
+    Stats getStats() const;
+
+private:
+    TimelineCache() = default;
+
+    void sweepIfNeeded();
+
+    mutable std::mutex mutex;
+    std::unordered_map<ParameterKey, std::weak_ptr<const ComputedTimeline>, ParameterKeyHash> records;
+    size_t sweepThreshold = 1024;
+    std::atomic<size_t> lookups{0};
+    std::atomic<size_t> hits{0};
+};
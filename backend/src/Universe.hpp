@@ -28,7 +28,7 @@ public:
     double getMatterAntimatterRatio() const { return matterAntimatterRatio; }
     double getDarkEnergyW() const { return darkEnergyW; }
     double getCurvatureParameter() const { return curvatureParameter; }
-    std::string getName() const { return name; }
+    const std::string& getName() const { return name; }
 
     // Setter method for name
     void setName(const std::string& newName) { name = newName; }
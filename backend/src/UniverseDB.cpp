@@ -1,86 +1,346 @@
 #include "UniverseDB.hpp"
+#include "NameMatch.hpp"
 #include <algorithm>
-#include <cctype>
-
-// Helper function for case-insensitive string comparison
-static bool containsIgnoreCase(const std::string& str, std::string_view term) {
-    auto it = std::search(
-        str.begin(), str.end(),
-        term.begin(), term.end(),
-        [](char ch1, char ch2) {
-            return std::tolower(ch1) == std::tolower(ch2);
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+void UniverseDB::setStorage(Storage mode) {
+    std::lock_guard<std::mutex> lock(universes_mutex);
+    if (next_id != 0) {
+        throw std::logic_error("The storage of a database holding universes cannot change");
+    }
+    storage = mode;
+}
+
+size_t UniverseDB::storedBound() const {
+    return storage == Storage::Compact ? records.size() : universes.size();
+}
+
+UniverseDB::UniversePtr UniverseDB::stored(size_t id) const {
+    if (storage == Storage::Objects) {
+        return universes[id];
+    }
+    const CompactUniverseStore::Record* record = records[id];
+    return record ? CompactUniverseStore::materialize(*record, records.name(*record)) : nullptr;
+}
+
+void UniverseDB::store(size_t id, UniversePtr universe) {
+    if (storage == Storage::Objects) {
+        if (id == universes.size()) {
+            universes.push_back(std::move(universe));
+        } else {
+            universes.set(id, std::move(universe));
         }
-    );
-    return it != str.end();
+    } else if (id == records.size()) {
+        records.push_back(*universe);
+    } else {
+        records.set(id, universe.get());
+    }
 }
 
-int UniverseDB::addUniverse(std::unique_ptr<SimulatedUniverse> universe) {
+int UniverseDB::addUniverse(UniversePtr universe) {
     std::lock_guard<std::mutex> lock(universes_mutex);
-    int id = next_id++;
-    universes.push_back(std::move(universe));
+    int id = next_id;
+    store(id, universe);
+    ++next_id;
+    index.insert(id, ParameterIndex::normalize(*universe));
+    statistics.add(id, EnsembleStatistics::Sample::of(*universe));
+    events.insert(id, *universe);
+    names.insert(id, universe->getName());
+    ++revision;
     return id;
 }
 
-std::optional<std::reference_wrapper<SimulatedUniverse>> UniverseDB::getUniverse(int id) {
+int UniverseDB::addUniverses(std::vector<std::unique_ptr<SimulatedUniverse>> batch) {
     std::lock_guard<std::mutex> lock(universes_mutex);
-    if (id >= 0 && id < static_cast<int>(universes.size()) && universes[id]) {
-        return std::ref(*universes[id]);
+    if (storage == Storage::Compact) {
+        // Reject the batch before any of it is stored
+        for (const auto& universe : batch) {
+            if (universe->getName().size() > StringArena::kMaxLength) {
+                throw std::length_error("Universe name exceeds " + std::to_string(StringArena::kMaxLength) +
+                                        " bytes");
+            }
+        }
     }
-    return std::nullopt;
+    int firstId = next_id;
+    std::vector<std::pair<int, ParameterIndex::Point>> points;
+    points.reserve(batch.size());
+    int id = firstId;
+    for (auto& universe : batch) {
+        points.emplace_back(id, ParameterIndex::normalize(*universe));
+        statistics.add(id, EnsembleStatistics::Sample::of(*universe));
+        names.insert(id, universe->getName());
+        events.insert(id, *universe);
+        store(id++, std::move(universe));
+        ++next_id;
+    }
+    index.insert(points);
+    ++revision;
+    return firstId;
 }
 
-std::vector<std::reference_wrapper<SimulatedUniverse>> UniverseDB::getAllUniverses() {
+UniverseDB::UniversePtr UniverseDB::getUniverse(int id) const {
     std::lock_guard<std::mutex> lock(universes_mutex);
-    std::vector<std::reference_wrapper<SimulatedUniverse>> result;
-    result.reserve(universes.size());
+    if (id >= 0 && id < static_cast<int>(storedBound())) {
+        return stored(id);
+    }
+    return nullptr;
+}
+
+std::optional<UniverseView> UniverseDB::View::get(int id) const {
+    if (id < 0 || static_cast<size_t>(id) >= size()) {
+        return std::nullopt;
+    }
+    if (storage == Storage::Compact) {
+        const CompactUniverseStore::Record* record = records[id];
+        if (!record) {
+            return std::nullopt;
+        }
+        return UniverseView(*record, records.name(*record));
+    }
+    const UniversePtr& universe = objects[id];
+    if (!universe) {
+        return std::nullopt;
+    }
+    return UniverseView(universe);
+}
+
+UniverseDB::View UniverseDB::view() const {
+    std::lock_guard<std::mutex> lock(universes_mutex);
+    return viewLocked();
+}
+
+UniverseDB::View UniverseDB::viewLocked() const {
+    View view;
+    view.storage = storage;
+    if (storage == Storage::Compact) {
+        view.records = records.view();
+    } else {
+        view.objects = universes.view();
+    }
+    return view;
+}
+
+std::vector<UniverseDB::Entry> UniverseDB::getAllUniverses() const {
+    const View view = this->view();
+    std::vector<Entry> result;
+    result.reserve(view.count());
     
-    for (const auto& universe : universes) {
-        if (universe) {  // Check if the universe pointer is valid
-            result.push_back(std::ref(*universe));
+    for (size_t id = 0; id < view.size(); ++id) {
+        if (auto universe = view.get(static_cast<int>(id))) {  // Skip removed universes
+            result.push_back({static_cast<int>(id), universe->universe()});
         }
     }
     return result;
 }
 
-std::vector<std::reference_wrapper<SimulatedUniverse>> UniverseDB::searchUniverses(std::string_view term) {
-    std::lock_guard<std::mutex> lock(universes_mutex);
-    std::vector<std::reference_wrapper<SimulatedUniverse>> result;
+std::vector<UniverseDB::Entry> UniverseDB::searchUniverses(std::string_view term) const {
+    const View view = this->view();
+    std::vector<Entry> result;
     
-    for (const auto& universe : universes) {
-        if (universe && containsIgnoreCase(universe->getName(), term)) {
-            result.push_back(std::ref(*universe));
+    for (size_t id = 0; id < view.size(); ++id) {
+        auto universe = view.get(static_cast<int>(id));
+        if (universe && nameMatches(universe->getName(), term)) {
+            result.push_back({static_cast<int>(id), universe->universe()});
         }
     }
     return result;
 }
 
+std::vector<FuzzyNameIndex::Match> UniverseDB::fuzzySearch(std::string_view term, int maxDistance,
+                                                           size_t limit) const {
+    // The index has its own reader lock, so a search does not hold up writers
+    return names.search(term, maxDistance, limit);
+}
+
 bool UniverseDB::removeUniverse(int id) {
     std::lock_guard<std::mutex> lock(universes_mutex);
-    if (id >= 0 && id < static_cast<int>(universes.size())) {
-        universes[id].reset();  // Clear the unique_ptr
+    if (id >= 0 && id < static_cast<int>(storedBound())) {
+        if (const UniversePtr universe = stored(id)) {
+            removeStatistics(id, EnsembleStatistics::Sample::of(*universe));
+            events.remove(id, *universe);
+            names.remove(id);
+        }
+        store(id, nullptr);
+        index.remove(id);
+        ++revision;
         return true;
     }
     return false;
 }
 
+std::optional<UniverseDB::UpdateResult> UniverseDB::updateUniverse(int id, const UniverseUpdate& update,
+                                                                  const UpdateCheck& check) {
+    std::lock_guard<std::mutex> lock(universes_mutex);
+    const UniversePtr held = id >= 0 && id < static_cast<int>(storedBound()) ? stored(id) : nullptr;
+    if (!held) {
+        return std::nullopt;
+    }
+    const SimulatedUniverse& current = *held;
+    const UniverseParameters params(update.matterDensity.value_or(current.getMatterDensity()),
+                                    update.darkEnergyDensity.value_or(current.getDarkEnergyDensity()),
+                                    update.hubbleConstant.value_or(current.getHubbleConstant()),
+                                    update.matterAntimatterRatio.value_or(current.getMatterAntimatterRatio()),
+                                    update.darkEnergyW.value_or(current.getDarkEnergyW()));
+    if (check) {
+        check(params);
+    }
+
+    // Readers may still hold the current universe: edit a copy and swap it in
+    auto edited = std::make_shared<SimulatedUniverse>(current);
+    if (update.name) {
+        edited->setName(*update.name);
+    }
+    const MilestoneFormulas::ParameterMask changed = edited->setParameters(params);
+    if (changed) {
+        index.insert(id, ParameterIndex::normalize(*edited));  // replaces the old point
+        removeStatistics(id, EnsembleStatistics::Sample::of(current));
+        statistics.add(id, EnsembleStatistics::Sample::of(*edited));
+        events.update(id, MilestoneTimeIndex::contributionOf(current), *edited);
+        ++revision;
+    }
+    if (update.name) {
+        names.insert(id, *update.name);
+    }
+    store(id, edited);
+    return UpdateResult{changed, std::move(edited)};
+}
+
+void UniverseDB::removeStatistics(int id, const EnsembleStatistics::Sample& sample) {
+    if (statistics.remove(id, sample)) {
+        return;
+    }
+    // The sample held a min or max of its shard: recompute the shard from
+    // the other universes in it
+    const size_t shard = EnsembleStatistics::shardOf(id);
+    std::vector<EnsembleStatistics::Sample> samples;
+    for (size_t other = shard; other < storedBound(); other += EnsembleStatistics::kShards) {
+        if (static_cast<int>(other) == id) {
+            continue;
+        }
+        if (const UniversePtr universe = stored(other)) {
+            samples.push_back(EnsembleStatistics::Sample::of(*universe));
+        }
+    }
+    statistics.rebuildShard(shard, samples);
+}
+
 size_t UniverseDB::getUniverseCount() const {
     std::lock_guard<std::mutex> lock(universes_mutex);
-    return std::count_if(universes.begin(), universes.end(), 
-                        [](const auto& u) { return u != nullptr; });
+    return storage == Storage::Compact ? records.count() : universes.count();
 }
 
-std::optional<std::string> UniverseDB::exportToJSON(int id) const {
+std::vector<MilestoneTimeIndex::Event> UniverseDB::findEvents(
+    const std::vector<MilestoneType>& types, double from, double to, size_t limit) const {
     std::lock_guard<std::mutex> lock(universes_mutex);
-    if (id >= 0 && id < static_cast<int>(universes.size()) && universes[id]) {
-        return universes[id]->toJSON();
+    return events.query(types, from, to, limit);
+}
+
+std::vector<ParameterIndex::Neighbor> UniverseDB::findNearest(
+    const ParameterIndex::Point& point, size_t k, const ParameterIndex::Weights& weights) const {
+    std::lock_guard<std::mutex> lock(universes_mutex);
+    return index.nearest(point, k, weights);
+}
+
+std::vector<ParameterIndex::Neighbor> UniverseDB::findWithinRadius(
+    const ParameterIndex::Point& point, double radius, const ParameterIndex::Weights& weights) const {
+    std::lock_guard<std::mutex> lock(universes_mutex);
+    return index.withinRadius(point, radius, weights);
+}
+
+std::optional<std::string> UniverseDB::exportToJSON(int id) const {
+    if (const UniversePtr universe = getUniverse(id)) {
+        return universe->toJSON();
     }
     return std::nullopt;
 }
 
 std::optional<std::string> UniverseDB::exportToCSV(int id) const {
-    std::lock_guard<std::mutex> lock(universes_mutex);
-    if (id >= 0 && id < static_cast<int>(universes.size()) && universes[id]) {
-        return universes[id]->toCSV();
+    if (const UniversePtr universe = getUniverse(id)) {
+        return universe->toCSV();
     }
     return std::nullopt;
-} 
\ No newline at end of file
+} 
+UniverseDB::~UniverseDB() {
+    stopSnapshots();
+}
+
+void UniverseDB::publishSnapshots(const std::string& name, std::chrono::milliseconds interval) {
+    stopSnapshots();
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        snapshot = std::make_unique<SharedSnapshotWriter>(name);
+        stopPublishing = false;
+    }
+    publishSnapshotNow();
+    publisher = std::thread(&UniverseDB::publishLoop, this, interval);
+}
+
+void UniverseDB::stopSnapshots() {
+    {
+        std::lock_guard<std::mutex> lock(snapshot_mutex);
+        stopPublishing = true;
+    }
+    snapshot_changed.notify_all();
+    if (publisher.joinable()) {
+        publisher.join();
+    }
+    std::lock_guard<std::mutex> lock(snapshot_mutex);
+    snapshot.reset();
+}
+
+void UniverseDB::publishLoop(std::chrono::milliseconds interval) {
+    std::unique_lock<std::mutex> lock(snapshot_mutex);
+    while (!snapshot_changed.wait_for(lock, interval, [this] { return stopPublishing; })) {
+        if (revision.load() != publishedRevision) {
+            lock.unlock();
+            publishSnapshotNow();
+            lock.lock();
+        }
+    }
+}
+
+bool UniverseDB::publishSnapshotNow() {
+    std::lock_guard<std::mutex> snapshotLock(snapshot_mutex);
+    if (!snapshot) {
+        return false;
+    }
+    // Columns are filled from a snapshot, outside the database lock
+    View view;
+    std::uint64_t published;
+    {
+        std::lock_guard<std::mutex> lock(universes_mutex);
+        view = viewLocked();
+        published = revision.load();
+    }
+
+    snapshot->publish(view.count(), [&](const SharedSnapshotWriter::Columns& columns) {
+        size_t row = 0;
+        for (size_t id = 0; id < view.size(); ++id) {
+            const auto universe = view.get(static_cast<int>(id));
+            if (!universe) {
+                continue;
+            }
+            columns.ids[row] = static_cast<std::int32_t>(id);
+            columns.parameters[0][row] = universe->getMatterDensity();
+            columns.parameters[1][row] = universe->getDarkEnergyDensity();
+            columns.parameters[2][row] = universe->getHubbleConstant();
+            columns.parameters[3][row] = universe->getMatterAntimatterRatio();
+            columns.parameters[4][row] = universe->getDarkEnergyW();
+            const auto ending = universe->ending();
+            columns.endings[row] = ending ? static_cast<std::uint8_t>(*ending) : SharedSnapshotLayout::kNoEnding;
+
+            for (double* column : columns.milestones) {
+                column[row] = std::numeric_limits<double>::quiet_NaN();
+            }
+            const LazyTimeline& timeline = universe->getComputedTimeline().timeline();
+            for (size_t i = 0; i < timeline.size(); ++i) {
+                columns.milestones[static_cast<size_t>(timeline.typeAt(i))][row] = timeline.timestampAt(i);
+            }
+            ++row;
+        }
+    });
+    publishedRevision = published;
+    return true;
+}
@@ -1,6 +1,19 @@
 #pragma once
 
 #include "SimulatedUniverse.hpp"
+#include "ParameterIndex.hpp"
+#include "EnsembleStatistics.hpp"
+#include "MilestoneTimeIndex.hpp"
+#include "FuzzyNameIndex.hpp"
+#include "SharedSnapshotWriter.hpp"
+#include "UniverseTable.hpp"
+#include "CompactUniverseStore.hpp"
+#include "UniverseView.hpp"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <mutex>
@@ -21,23 +34,149 @@ public:
     UniverseDB& operator=(const UniverseDB&) = delete;
     UniverseDB(UniverseDB&&) = delete;
     UniverseDB& operator=(UniverseDB&&) = delete;
+    ~UniverseDB();
+
+    // Stored universes are immutable: an update stores an edited copy, so a
+    // reader holding a UniversePtr keeps a consistent universe without a lock
+    using UniversePtr = UniverseTable::UniversePtr;
+
+    // How universes are held. Objects keeps each SimulatedUniverse as it was
+    // added. Compact keeps a 48-byte record per universe and its name in an
+    // arena (CompactUniverseStore); getUniverse() and the lists of Entry
+    // then build a new SimulatedUniverse per call, while a View reads
+    // the records in place.
+    enum class Storage {
+        Objects,
+        Compact
+    };
+    // Only while nothing has been added; throws std::logic_error otherwise
+    void setStorage(Storage mode);
+    Storage getStorage() const { return storage; }
+
+    // The stored universes as of one moment, taken in O(N / chunk size) and
+    // readable from any thread without the database lock
+    class View {
+    public:
+        // One past the largest id, and the universes that are not removed
+        size_t size() const { return storage == Storage::Compact ? records.size() : objects.size(); }
+        size_t count() const { return storage == Storage::Compact ? records.count() : objects.count(); }
+        // nullopt for a removed or unknown id; valid while this view lives
+        std::optional<UniverseView> get(int id) const;
+
+    private:
+        friend class UniverseDB;
+        Storage storage = Storage::Objects;
+        UniverseTable::View objects;
+        CompactUniverseStore::View records;
+    };
+    View view() const;
+
+    // Fields of updateUniverse; omitted ones keep their current value
+    struct UniverseUpdate {
+        std::optional<std::string> name;
+        std::optional<double> matterDensity;
+        std::optional<double> darkEnergyDensity;
+        std::optional<double> hubbleConstant;
+        std::optional<double> matterAntimatterRatio;
+        std::optional<double> darkEnergyW;
+    };
+    struct UpdateResult {
+        MilestoneFormulas::ParameterMask changed;
+        UniversePtr universe;  // the stored copy
+    };
+    // A stored universe with its id
+    struct Entry {
+        int id;
+        UniversePtr universe;
+    };
+    // Sees the merged parameters before anything changes; throws to reject them
+    using UpdateCheck = std::function<void(const UniverseParameters&)>;
 
     // Core operations
-    int addUniverse(std::unique_ptr<SimulatedUniverse> universe);
-    std::optional<std::reference_wrapper<SimulatedUniverse>> getUniverse(int id);
-    std::vector<std::reference_wrapper<SimulatedUniverse>> getAllUniverses();
-    std::vector<std::reference_wrapper<SimulatedUniverse>> searchUniverses(std::string_view term);
+    int addUniverse(UniversePtr universe);
+    // Insert a batch under a single lock. Ids are consecutive; returns the first.
+    int addUniverses(std::vector<std::unique_ptr<SimulatedUniverse>> batch);
+    // nullptr for an unknown id
+    UniversePtr getUniverse(int id) const;
+    // In id order
+    std::vector<Entry> getAllUniverses() const;
+    // Names containing term, ignoring case (nameMatches)
+    std::vector<Entry> searchUniverses(std::string_view term) const;
     bool removeUniverse(int id);
+    // Merge update into the stored universe under the lock and replace it by
+    // the edited copy. Only the milestones, index entries and statistics
+    // that depend on the changed parameters are recomputed. Returns nullopt
+    // for an unknown id; exceptions from check leave the universe unchanged.
+    std::optional<UpdateResult> updateUniverse(int id, const UniverseUpdate& update,
+                                               const UpdateCheck& check = {});
     size_t getUniverseCount() const;
+    // One past the largest id handed out; lower ids may have been removed
+    int getIdBound() const { return next_id; }
+    // Names containing term with at most maxDistance typos, ignoring case,
+    // closest first (FuzzyNameIndex)
+    std::vector<FuzzyNameIndex::Match> fuzzySearch(std::string_view term, int maxDistance,
+                                                   size_t limit) const;
+
+    // Similarity search in normalized parameter space, nearest first
+    std::vector<ParameterIndex::Neighbor> findNearest(
+        const ParameterIndex::Point& point, size_t k,
+        const ParameterIndex::Weights& weights = ParameterIndex::kUniformWeights) const;
+    std::vector<ParameterIndex::Neighbor> findWithinRadius(
+        const ParameterIndex::Point& point, double radius,
+        const ParameterIndex::Weights& weights = ParameterIndex::kUniformWeights) const;
+
+    // Milestones of the given types with from <= timestamp <= to, earliest
+    // first, at most limit of them
+    std::vector<MilestoneTimeIndex::Event> findEvents(
+        const std::vector<MilestoneType>& types, double from, double to, size_t limit) const;
+
+    // Aggregates over all universes, in O(bins) without taking the database lock
+    EnsembleStatistics::Snapshot getStatistics() const { return statistics.snapshot(); }
 
     // Export methods
     std::optional<std::string> exportToJSON(int id) const;
     std::optional<std::string> exportToCSV(int id) const;
 
+    // Publish a read-only columnar copy (SharedSnapshotLayout) to the POSIX
+    // shared-memory segment name, e.g. "/cosmic", for SharedSnapshotReader
+    // clients. A background thread republishes at most every interval
+    // while the database changes. Throws std::system_error.
+    void publishSnapshots(const std::string& name,
+                          std::chrono::milliseconds interval = std::chrono::milliseconds(100));
+    // Stop publishing and unlink the segment
+    void stopSnapshots();
+    // Publish the current contents right away; false when not publishing
+    bool publishSnapshotNow();
+
 private:
     UniverseDB() = default;  // Private constructor for singleton
 
-    std::vector<std::unique_ptr<SimulatedUniverse>> universes;
+    // Take id's sample out of the statistics; callers hold universes_mutex
+    void removeStatistics(int id, const EnsembleStatistics::Sample& sample);
+
+    // Storage-independent access for the callers holding universes_mutex
+    size_t storedBound() const;
+    UniversePtr stored(size_t id) const;  // nullptr for a removed universe
+    void store(size_t id, UniversePtr universe);  // id == storedBound() appends
+    View viewLocked() const;
+
+    Storage storage = Storage::Objects;
+    UniverseTable universes;
+    CompactUniverseStore records;
+    ParameterIndex index;
+    EnsembleStatistics statistics;
+    MilestoneTimeIndex events;
+    FuzzyNameIndex names;
     mutable std::mutex universes_mutex;
     std::atomic<int> next_id{0};
+
+    // Shared-memory snapshots; snapshot_mutex is taken before universes_mutex
+    void publishLoop(std::chrono::milliseconds interval);
+    std::atomic<std::uint64_t> revision{0};  // bumped by every change
+    std::uint64_t publishedRevision = 0;
+    std::unique_ptr<SharedSnapshotWriter> snapshot;
+    std::thread publisher;
+    bool stopPublishing = false;
+    std::mutex snapshot_mutex;
+    std::condition_variable snapshot_changed;
 }; 
\ No newline at end of file
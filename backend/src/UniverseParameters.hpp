@@ -3,7 +3,7 @@
 class UniverseParameters {
 public:
     // Default constructor with reasonable default values
-    UniverseParameters()
+    constexpr UniverseParameters()
         : matterDensity(0.3)
         , darkEnergyDensity(0.7)
         , hubbleConstant(70.0)
@@ -14,11 +14,11 @@ public:
     {}
 
     // Existing constructor
-    UniverseParameters(double matterDensity,      // Ω_m
-                      double darkEnergyDensity,   // Ω_Λ
-                      double hubbleConstant,      // H_0
-                      double matterAntimatterRatio,
-                      double darkEnergyW)         // w
+    constexpr UniverseParameters(double matterDensity,      // Ω_m
+                                double darkEnergyDensity,   // Ω_Λ
+                                double hubbleConstant,      // H_0
+                                double matterAntimatterRatio,
+                                double darkEnergyW)         // w
         : matterDensity(matterDensity)
         , darkEnergyDensity(darkEnergyDensity)
         , hubbleConstant(hubbleConstant)
@@ -29,22 +29,22 @@ public:
     {}
 
     // Getters
-    double getMatterDensity() const { return matterDensity; }
-    double getDarkEnergyDensity() const { return darkEnergyDensity; }
-    double getHubbleConstant() const { return hubbleConstant; }
-    double getMatterAntimatterRatio() const { return matterAntimatterRatio; }
-    double getDarkEnergyW() const { return darkEnergyW; }
-    double getDarkMatterRatio() const { return darkMatterRatio; }
-    double getInitialEnergyDensity() const { return initialEnergyDensity; }
+    constexpr double getMatterDensity() const { return matterDensity; }
+    constexpr double getDarkEnergyDensity() const { return darkEnergyDensity; }
+    constexpr double getHubbleConstant() const { return hubbleConstant; }
+    constexpr double getMatterAntimatterRatio() const { return matterAntimatterRatio; }
+    constexpr double getDarkEnergyW() const { return darkEnergyW; }
+    constexpr double getDarkMatterRatio() const { return darkMatterRatio; }
+    constexpr double getInitialEnergyDensity() const { return initialEnergyDensity; }
 
     // Setters
-    void setMatterDensity(double value) { matterDensity = value; }
-    void setDarkEnergyDensity(double value) { darkEnergyDensity = value; }
-    void setHubbleConstant(double value) { hubbleConstant = value; }
-    void setMatterAntimatterRatio(double value) { matterAntimatterRatio = value; }
-    void setDarkEnergyW(double value) { darkEnergyW = value; }
-    void setDarkMatterRatio(double value) { darkMatterRatio = value; }
-    void setInitialEnergyDensity(double value) { initialEnergyDensity = value; }
+    constexpr void setMatterDensity(double value) { matterDensity = value; }
+    constexpr void setDarkEnergyDensity(double value) { darkEnergyDensity = value; }
+    constexpr void setHubbleConstant(double value) { hubbleConstant = value; }
+    constexpr void setMatterAntimatterRatio(double value) { matterAntimatterRatio = value; }
+    constexpr void setDarkEnergyW(double value) { darkEnergyW = value; }
+    constexpr void setDarkMatterRatio(double value) { darkMatterRatio = value; }
+    constexpr void setInitialEnergyDensity(double value) { initialEnergyDensity = value; }
 
 private:
     double matterDensity;        // Ω_m - density parameter for matter
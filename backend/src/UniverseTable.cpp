@@ -0,0 +1,37 @@
+#include "UniverseTable.hpp"
+#include <atomic>
+
+void UniverseTable::push_back(UniversePtr universe) {
+    if (bound % kChunkSize == 0) {
+        chunks.push_back(std::make_shared<Chunk>());
+    }
+    live += universe != nullptr;
+    writable(bound / kChunkSize)[bound % kChunkSize] = std::move(universe);
+    ++bound;
+}
+
+void UniverseTable::set(size_t id, UniversePtr universe) {
+    UniversePtr& slot = writable(id / kChunkSize)[id % kChunkSize];
+    live += (universe != nullptr) - (slot != nullptr);
+    slot = std::move(universe);
+}
+
+UniverseTable::View UniverseTable::view() const {
+    View view;
+    view.chunks.assign(chunks.begin(), chunks.end());
+    view.bound = bound;
+    view.live = live;
+    return view;
+}
+
+UniverseTable::Chunk& UniverseTable::writable(size_t chunk) {
+    std::shared_ptr<Chunk>& shared = chunks[chunk];
+    if (shared.use_count() > 1) {
+        shared = std::make_shared<Chunk>(*shared);
+    } else {
+        // Views are released without the table's lock: order their last
+        // reads of the chunk before the write that follows
+        std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return *shared;
+}
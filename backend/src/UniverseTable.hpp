@@ -0,0 +1,58 @@
+#pragma once
+
+#include "SimulatedUniverse.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Stored universes indexed by id, with O(N / kChunkSize) snapshots.
+//
+// Slots live in fixed-size chunks held by shared_ptr. view() copies only the
+// chunk pointers, and a view never changes afterwards: writing to a chunk
+// that a view still shares clones the chunk first. The table itself is not
+// synchronized (UniverseDB guards it with its lock); views are immutable and
+// can be read from any thread.
+class UniverseTable {
+public:
+    using UniversePtr = std::shared_ptr<const SimulatedUniverse>;
+    static constexpr size_t kChunkSize = 1024;
+
+private:
+    using Chunk = std::array<UniversePtr, kChunkSize>;
+
+public:
+    class View {
+    public:
+        // One past the largest id
+        size_t size() const { return bound; }
+        // Universes that are not removed
+        size_t count() const { return live; }
+        // nullptr for a removed universe
+        const UniversePtr& operator[](size_t id) const { return (*chunks[id / kChunkSize])[id % kChunkSize]; }
+
+    private:
+        friend class UniverseTable;
+        std::vector<std::shared_ptr<const Chunk>> chunks;
+        size_t bound = 0;
+        size_t live = 0;
+    };
+
+    size_t size() const { return bound; }
+    size_t count() const { return live; }
+    const UniversePtr& operator[](size_t id) const { return (*chunks[id / kChunkSize])[id % kChunkSize]; }
+
+    void push_back(UniversePtr universe);
+    // Replace the universe of an id below size(); nullptr removes it
+    void set(size_t id, UniversePtr universe);
+
+    View view() const;
+
+private:
+    // Chunk about to be written, cloned if a view shares it
+    Chunk& writable(size_t chunk);
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    size_t bound = 0;
+    size_t live = 0;
+};
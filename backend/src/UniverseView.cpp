@@ -0,0 +1,29 @@
+#include "UniverseView.hpp"
+
+std::optional<MilestoneType> UniverseView::ending() const {
+    return record ? CompactUniverseStore::ending(*record) : (*object)->ending();
+}
+
+UniverseParameters UniverseView::parameters() const {
+    return record ? CompactUniverseStore::parameters(*record) : (*object)->parameters();
+}
+
+const ComputedTimeline& UniverseView::getComputedTimeline() const {
+    if (!record) {
+        return (*object)->getComputedTimeline();
+    }
+    if (!computed) {
+        const UniverseParameters params = parameters();
+        const ParameterKey key(record->matterDensity, record->darkEnergyDensity, record->hubbleConstant,
+                               record->matterAntimatterRatio, record->darkEnergyW);
+        computed = TimelineCache::instance().intern(key, [&] {
+            return std::make_shared<const ComputedTimeline>(params, SimulatedUniverse::milestoneTypes(params),
+                                                            SimulatedUniverse::ending(params));
+        });
+    }
+    return *computed;
+}
+
+UniverseView::UniversePtr UniverseView::universe() const {
+    return record ? CompactUniverseStore::materialize(*record, name) : *object;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "CompactUniverseStore.hpp"
+#include "SimulatedUniverse.hpp"
+#include <memory>
+#include <optional>
+#include <string_view>
+
+// A stored universe as a UniverseDB::View hands it out, whichever
+// storage the database uses. The getters read the record or the object
+// directly; getComputedTimeline() and universe() build only what a compact
+// record lacks. Valid while the view it came from lives.
+class UniverseView {
+public:
+    using UniversePtr = std::shared_ptr<const SimulatedUniverse>;
+
+    explicit UniverseView(const UniversePtr& universe) : object(&universe) {}
+    UniverseView(const CompactUniverseStore::Record& record, std::string_view name)
+        : record(&record), name(name) {}
+
+    std::string_view getName() const { return record ? name : std::string_view((*object)->getName()); }
+    double getMatterDensity() const { return record ? record->matterDensity : (*object)->getMatterDensity(); }
+    double getDarkEnergyDensity() const {
+        return record ? record->darkEnergyDensity : (*object)->getDarkEnergyDensity();
+    }
+    double getHubbleConstant() const { return record ? record->hubbleConstant : (*object)->getHubbleConstant(); }
+    double getMatterAntimatterRatio() const {
+        return record ? record->matterAntimatterRatio : (*object)->getMatterAntimatterRatio();
+    }
+    double getDarkEnergyW() const { return record ? record->darkEnergyW : (*object)->getDarkEnergyW(); }
+    std::optional<MilestoneType> ending() const;
+    UniverseParameters parameters() const;
+
+    // Timeline record shared with all universes of identical parameters;
+    // looked up in TimelineCache for a compact record
+    const ComputedTimeline& getComputedTimeline() const;
+    // The universe object, built from the record in compact storage
+    UniversePtr universe() const;
+
+private:
+    const UniversePtr* object = nullptr;
+    const CompactUniverseStore::Record* record = nullptr;
+    std::string_view name;
+    mutable std::shared_ptr<const ComputedTimeline> computed;  // of a record, once looked up
+};
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "../src/BatchSweep.hpp"
+#include "../src/SimulatedUniverse.hpp"
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+static SweepSpec smallSpec() {
+    SweepSpec spec;
+    spec.axes[0].steps = 4;
+    spec.axes[1].steps = 4;
+    spec.axes[2].steps = 3;
+    spec.axes[3].steps = 3;
+    spec.axes[4].steps = 4;
+    spec.chunkSize = 16;
+    return spec;
+}
+
+static std::string checkpointPath(const char* name) {
+    const std::string path = testing::TempDir() + "batch_sweep_" + name + ".ckpt";
+    std::remove(path.c_str());
+    return path;
+}
+
+TEST(BatchSweepTest, SpecEnumeratesTheGrid) {
+    const SweepSpec spec = smallSpec();
+    EXPECT_EQ(spec.size(), 576u);
+    EXPECT_EQ(spec.chunkCount(), 36u);
+    EXPECT_EQ(spec.at(0).getMatterDensity(), 0.1);
+    EXPECT_EQ(spec.at(575).getDarkEnergyW(), -0.5);
+    EXPECT_DOUBLE_EQ(spec.at(575).getMatterAntimatterRatio(), 1e-7);
+    EXPECT_DOUBLE_EQ(spec.at(4).getMatterAntimatterRatio(), 1e-9);  // middle of three log steps
+    EXPECT_EQ(SweepSpec::fromJson(spec.toJson()).toJson(), spec.toJson());
+}
+
+TEST(BatchSweepTest, ResumedRunsMatchAnUninterruptedRun) {
+    const SweepSpec spec = smallSpec();
+    const auto reference = BatchSweep(spec, {}).run();
+    ASSERT_TRUE(reference.complete);
+    EXPECT_EQ(reference.aggregate.universes, spec.size());
+
+    // Stop twice, at different points and thread counts, then finish
+    BatchSweep::Options options;
+    options.checkpointPath = checkpointPath("resume");
+    options.checkpointInterval = std::chrono::milliseconds(0);
+    size_t resumed = 0;
+    for (size_t stopAfter : {size_t{7}, size_t{20}, size_t{0}}) {
+        BatchSweep* current = nullptr;
+        BatchSweep::Options stopping = options;
+        stopping.threads = stopAfter ? 3 : 1;
+        stopping.progress = [&current, stopAfter](size_t done, size_t) {
+            if (stopAfter && done >= stopAfter) {
+                current->stop();
+            }
+        };
+        BatchSweep run(spec, stopping);
+        current = &run;
+        const auto result = run.run();
+        EXPECT_EQ(result.chunksResumed, resumed);
+        resumed = result.chunksResumed + result.chunksRun;
+        if (stopAfter) {
+            EXPECT_FALSE(result.complete);
+            EXPECT_GE(resumed, stopAfter);
+        } else {
+            ASSERT_TRUE(result.complete);
+            EXPECT_EQ(result.aggregate.toJson().dump(), reference.aggregate.toJson().dump());
+        }
+    }
+
+    // The final checkpoint makes a rerun free
+    const auto rerun = BatchSweep(spec, options).run();
+    EXPECT_EQ(rerun.chunksRun, 0u);
+    EXPECT_EQ(rerun.aggregate.toJson().dump(), reference.aggregate.toJson().dump());
+    std::remove(options.checkpointPath.c_str());
+}
+
+TEST(BatchSweepTest, CheckpointOfAnotherSweepIsRejected) {
+    BatchSweep::Options options;
+    options.checkpointPath = checkpointPath("mismatch");
+    options.precision = MilestoneFormulas::Precision::Exact;
+    SweepSpec spec = smallSpec();
+    BatchSweep(spec, options).run();
+
+    spec.chunkSize = 32;
+    EXPECT_THROW(BatchSweep(spec, options).run(), std::runtime_error);
+
+    spec.chunkSize = 16;
+    options.precision = MilestoneFormulas::Precision::Fast;
+    EXPECT_THROW(BatchSweep(spec, options).run(), std::runtime_error);
+    std::remove(options.checkpointPath.c_str());
+}
+
+TEST(BatchSweepTest, AggregatesTheUniversesTimelines) {
+    // One chunk, so the sums are added in the same order
+    SweepSpec spec = smallSpec();
+    spec.chunkSize = spec.size();
+    SweepAggregate expected;
+    for (size_t index = 0; index < spec.size(); ++index) {
+        const UniverseParameters params = spec.at(index);
+        const SimulatedUniverse universe("Sweep", params.getMatterDensity(), params.getDarkEnergyDensity(),
+                                         params.getHubbleConstant(), params.getMatterAntimatterRatio(),
+                                         params.getDarkEnergyW());
+        const auto ending = universe.getComputedTimeline().getEnding();
+        ++expected.universes;
+        ++expected.endings[ending ? static_cast<size_t>(*ending) : kMilestoneTypeCount];
+        const auto timeline = universe.generateTimeline();
+        for (const auto& milestone : timeline->getMilestones()) {
+            expected.add(milestone->getType(), milestone->calculateTimestamp());
+        }
+    }
+
+    BatchSweep::Options options;
+    options.precision = MilestoneFormulas::Precision::Exact;
+    const auto exact = BatchSweep(spec, options).run();
+    EXPECT_EQ(exact.aggregate.toJson().dump(), expected.toJson().dump());
+
+    // Fast differs from exact in the last digits only
+    options.precision = MilestoneFormulas::Precision::Fast;
+    const auto fast = BatchSweep(spec, options).run();
+    EXPECT_EQ(fast.aggregate.endings, exact.aggregate.endings);
+    for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+        const auto& a = fast.aggregate.timestamps[t];
+        const auto& b = exact.aggregate.timestamps[t];
+        EXPECT_EQ(a.count, b.count);
+        EXPECT_NEAR(a.sum, b.sum, std::abs(b.sum) * 1e-9);
+        EXPECT_NEAR(a.min, b.min, std::abs(b.min) * 1e-9);
+        EXPECT_NEAR(a.max, b.max, std::abs(b.max) * 1e-9);
+    }
+}
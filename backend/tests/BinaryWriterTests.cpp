@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+#include "../src/BinaryWriter.hpp"
+#include "../src/SimulatedUniverse.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+
+static nlohmann::json decode(const BinaryWriter& writer) {
+    const auto& bytes = writer.bytes();
+    if (writer.getFormat() == BinaryWriter::Format::Cbor) {
+        return nlohmann::json::from_cbor(bytes.begin(), bytes.end());
+    }
+    return nlohmann::json::from_msgpack(bytes.begin(), bytes.end());
+}
+
+class BinaryWriterTest : public ::testing::TestWithParam<BinaryWriter::Format> {};
+
+TEST_P(BinaryWriterTest, UniverseRoundTripsThroughNlohmann) {
+    SimulatedUniverse universe("Binary \"Universe\"", 0.27, 0.73, 69.5, 2e-10, -1.3);
+
+    BinaryWriter writer(GetParam());
+    universe.write(writer);
+
+    EXPECT_EQ(decode(writer), nlohmann::json::parse(universe.toJSON()));
+}
+
+TEST_P(BinaryWriterTest, ScalarsRoundTripThroughNlohmann) {
+    const std::string longText(70000, 'x');
+
+    BinaryWriter writer(GetParam());
+    writer.beginArray();
+    for (int number : {0, 23, 24, 127, 128, 255, 256, 65535, 65536, -1, -24, -25, -32, -33, -129, -40000}) {
+        writer.value(number);
+    }
+    for (double number : {0.5, 0.1, -2.25, 1e-49, 1e100}) {
+        writer.value(number);
+    }
+    for (std::int64_t number : {std::int64_t{5000000000}, std::int64_t{-5000000000}, INT64_MAX, INT64_MIN}) {
+        writer.value(number);
+    }
+    writer.value("");
+    writer.value(std::string(31, 'a'));
+    writer.value(std::string(300, 'b'));
+    writer.value(longText);
+    writer.boolean(true);
+    writer.boolean(false);
+    writer.null();
+    writer.beginObject();
+    writer.endObject();
+    writer.endArray();
+
+    nlohmann::json expected = {0, 23, 24, 127, 128, 255, 256, 65535, 65536, -1, -24, -25, -32, -33, -129, -40000,
+                               0.5, 0.1, -2.25, 1e-49, 1e100,
+                               5000000000, -5000000000, INT64_MAX, INT64_MIN,
+                               "", std::string(31, 'a'), std::string(300, 'b'), longText,
+                               true, false, nullptr, nlohmann::json::object()};
+    EXPECT_EQ(decode(writer), expected);
+}
+
+TEST_P(BinaryWriterTest, SmallerThanJsonForTimelines) {
+    SimulatedUniverse universe("Size", 0.3, 0.7, 70.0, 1e-9, -1.0);
+
+    BinaryWriter writer(GetParam());
+    universe.write(writer);
+
+    EXPECT_LT(writer.bytes().size(), nlohmann::json::parse(universe.toJSON()).dump().size());
+}
+
+INSTANTIATE_TEST_SUITE_P(Formats, BinaryWriterTest,
+                         ::testing::Values(BinaryWriter::Format::Cbor, BinaryWriter::Format::MessagePack));
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "../src/CompactUniverseStore.hpp"
+#include "../src/SimulatedUniverse.hpp"
+#include "../src/UniverseDB.hpp"
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Every test of this file runs against a database in compact storage
+static UniverseDB& compactDatabase() {
+    static const bool compact = (UniverseDB::instance().setStorage(UniverseDB::Storage::Compact), true);
+    (void)compact;
+    return UniverseDB::instance();
+}
+
+TEST(CompactUniverseStoreTest, RecordsMatchSimulatedUniverse) {
+    const std::vector<SimulatedUniverse> universes = {
+        {"Standard", 0.3, 0.7, 70.0, 1e-9, -1.0},
+        {"Phantom", 0.25, 0.75, 68.2, 3e-10, -1.4},
+        {"Closed", 1.5, 0.2, 55.0, 1e-8, -0.6},
+        {"", 0.05, 0.0, 80.0, 1e-11, -0.5},
+    };
+
+    CompactUniverseStore store;
+    for (const auto& universe : universes) {
+        store.push_back(universe);
+    }
+    ASSERT_EQ(store.count(), universes.size());
+    for (size_t i = 0; i < universes.size(); ++i) {
+        const auto& universe = universes[i];
+        SCOPED_TRACE(universe.getName());
+        const CompactUniverseStore::Record* record = store[i];
+        ASSERT_TRUE(record);
+        EXPECT_EQ(store.name(*record), universe.getName());
+        EXPECT_EQ(record->matterDensity, universe.getMatterDensity());
+        EXPECT_EQ(record->darkEnergyW, universe.getDarkEnergyW());
+        EXPECT_EQ(CompactUniverseStore::ending(*record), universe.ending());
+
+        const UniverseView view(*record, store.name(*record));
+        EXPECT_EQ(view.getHubbleConstant(), universe.getHubbleConstant());
+        EXPECT_EQ(view.getMatterAntimatterRatio(), universe.getMatterAntimatterRatio());
+        EXPECT_EQ(&view.getComputedTimeline(), &universe.getComputedTimeline());
+        EXPECT_EQ(view.universe()->toJSON(), universe.toJSON());
+    }
+}
+
+TEST(CompactUniverseStoreTest, ViewsKeepTheirRecordsAcrossWrites) {
+    CompactUniverseStore store;
+    store.push_back(SimulatedUniverse("Andromeda", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    store.push_back(SimulatedUniverse("Milky Way", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    const auto before = store.view();
+
+    const SimulatedUniverse renamed("Andromeda II", 0.4, 0.6, 70.0, 1e-9, -1.0);
+    store.set(0, &renamed);
+    store.set(1, nullptr);
+    EXPECT_EQ(store.name(*store[0]), "Andromeda II");
+    EXPECT_EQ(store[0]->matterDensity, 0.4);
+    EXPECT_FALSE(store[1]);
+    EXPECT_EQ(store.count(), 1u);
+    EXPECT_EQ(store.size(), 2u);
+
+    ASSERT_TRUE(before[0] && before[1]);
+    EXPECT_EQ(before.name(*before[0]), "Andromeda");
+    EXPECT_EQ(before[0]->matterDensity, 0.3);
+    EXPECT_EQ(before.name(*before[1]), "Milky Way");
+    EXPECT_EQ(before.count(), 2u);
+
+    // An unchanged name is not copied into the arena again
+    const std::uint32_t nameOffset = store[0]->nameOffset;
+    const SimulatedUniverse edited("Andromeda II", 0.5, 0.5, 70.0, 1e-9, -1.0);
+    store.set(0, &edited);
+    EXPECT_EQ(store[0]->nameOffset, nameOffset);
+    EXPECT_EQ(store[0]->matterDensity, 0.5);
+}
+
+TEST(CompactUniverseStoreTest, MillionUniversesFitInTensOfMegabytes) {
+    constexpr size_t kCount = 1'000'000;
+    CompactUniverseStore store;
+    char name[32];
+    for (size_t i = 0; i < kCount; ++i) {
+        std::snprintf(name, sizeof(name), "Universe %07zu", i);
+        store.push_back(SimulatedUniverse(name, 0.3, 0.7, 70.0, 1e-9, -1.0));
+    }
+
+    // 48 bytes per record plus the 16-byte names
+    EXPECT_LT(store.getMemoryUsage(),
+              kCount * (sizeof(CompactUniverseStore::Record) + 16) + 2 * StringArena::kChunkSize +
+                  2 * CompactUniverseStore::kChunkSize * sizeof(CompactUniverseStore::Record));
+    EXPECT_EQ(store.name(*store[123456]), "Universe 0123456");
+}
+
+TEST(UniverseDBCompactTest, ViewsReadRecordsAndUniversesAreBuiltOnDemand) {
+    auto& db = compactDatabase();
+    ASSERT_EQ(db.getStorage(), UniverseDB::Storage::Compact);
+    const SimulatedUniverse reference("Compact andromeda", 0.25, 0.75, 68.2, 3e-10, -1.4);
+    const int first = db.addUniverse(std::make_shared<const SimulatedUniverse>(reference));
+    std::vector<std::unique_ptr<SimulatedUniverse>> batch;
+    batch.push_back(std::make_unique<SimulatedUniverse>("Compact milky way", 1.5, 0.2, 55.0, 1e-8, -0.6));
+    batch.push_back(std::make_unique<SimulatedUniverse>("Compact andromeda II", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    const int second = db.addUniverses(std::move(batch));
+
+    const auto universe = db.getUniverse(first);
+    ASSERT_TRUE(universe);
+    EXPECT_EQ(universe->toJSON(), reference.toJSON());
+
+    const UniverseDB::View view = db.view();
+    const auto stored = view.get(first);
+    ASSERT_TRUE(stored);
+    EXPECT_EQ(stored->getName(), "Compact andromeda");
+    EXPECT_EQ(stored->getDarkEnergyW(), -1.4);
+    EXPECT_EQ(stored->ending(), reference.ending());
+    EXPECT_EQ(stored->getComputedTimeline().timeline().size(),
+              reference.getComputedTimeline().timeline().size());
+
+    UniverseDB::UniverseUpdate update;
+    update.name = "Compact renamed";
+    update.darkEnergyW = -1.0;
+    ASSERT_TRUE(db.updateUniverse(first, update));
+    EXPECT_TRUE(db.removeUniverse(second));
+
+    // The view taken before still sees the old records
+    EXPECT_EQ(view.get(first)->getName(), "Compact andromeda");
+    EXPECT_TRUE(view.get(second));
+    EXPECT_EQ(db.getUniverse(first)->getName(), "Compact renamed");
+    EXPECT_EQ(db.getUniverse(first)->getDarkEnergyW(), -1.0);
+    EXPECT_FALSE(db.getUniverse(second));
+
+    const auto found = db.searchUniverses("COMPACT andromeda");
+    ASSERT_EQ(found.size(), 1u);
+    EXPECT_EQ(found[0].id, second + 1);
+    EXPECT_EQ(db.getUniverseCount(), 2u);
+    EXPECT_EQ(db.getStatistics().total, 2u);
+    EXPECT_THROW(db.setStorage(UniverseDB::Storage::Objects), std::logic_error);
+}
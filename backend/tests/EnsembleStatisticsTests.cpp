@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include "../src/EnsembleStatistics.hpp"
+#include "../src/UniverseDB.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+static std::unique_ptr<SimulatedUniverse> randomUniverse(std::mt19937_64& random, int n) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    return std::make_unique<SimulatedUniverse>(
+        "U" + std::to_string(n), 0.1 + 1.9 * unit(random), unit(random), 50.0 + 30.0 * unit(random),
+        std::pow(10.0, -11.0 + 4.0 * unit(random)), -2.0 + 1.5 * unit(random));
+}
+
+// Recompute a snapshot from scratch
+static EnsembleStatistics::Snapshot bruteForce(const std::vector<EnsembleStatistics::Sample>& samples) {
+    EnsembleStatistics statistics;
+    statistics.rebuildShard(0, samples);
+    return statistics.snapshot();
+}
+
+static void expectSameStatistics(const EnsembleStatistics::Snapshot& actual,
+                                 const EnsembleStatistics::Snapshot& expected) {
+    EXPECT_EQ(actual.total, expected.total);
+    EXPECT_EQ(actual.endings, expected.endings);
+    for (size_t q = 0; q < EnsembleStatistics::kQuantities; ++q) {
+        SCOPED_TRACE(q);
+        const auto& a = actual.quantities[q];
+        const auto& e = expected.quantities[q];
+        EXPECT_EQ(a.count, e.count);
+        EXPECT_EQ(a.min, e.min);
+        EXPECT_EQ(a.max, e.max);
+        EXPECT_EQ(a.minCount, e.minCount);
+        EXPECT_EQ(a.maxCount, e.maxCount);
+        EXPECT_NEAR(a.mean(), e.mean(), 1e-9 * std::max(1.0, std::abs(e.mean())));
+        EXPECT_EQ(a.linear, e.linear);
+        EXPECT_EQ(a.log, e.log);
+        EXPECT_EQ(a.logUnderflow, e.logUnderflow);
+    }
+}
+
+TEST(EnsembleStatisticsTest, ShardsMergeToSameResultAsOneAccumulator) {
+    std::mt19937_64 random(3);
+    EnsembleStatistics statistics;
+    std::vector<EnsembleStatistics::Sample> samples;
+    for (int id = 0; id < 500; ++id) {
+        samples.push_back(EnsembleStatistics::Sample::of(*randomUniverse(random, id)));
+        statistics.add(id, samples.back());
+    }
+    expectSameStatistics(statistics.snapshot(), bruteForce(samples));
+
+    // Histograms account for every present value
+    const auto snapshot = statistics.snapshot();
+    const auto& hubble = snapshot.quantities[2];
+    std::uint64_t binned = hubble.linearUnderflow + hubble.linearOverflow;
+    for (auto count : hubble.linear) binned += count;
+    EXPECT_EQ(binned, 500u);
+    EXPECT_EQ(snapshot.quantities[EnsembleStatistics::kParameterCount].count, 500u);  // Big Bang
+}
+
+TEST(EnsembleStatisticsTest, DatabaseKeepsStatisticsOnAddAndRemove) {
+    std::mt19937_64 random(11);
+    auto& db = UniverseDB::instance();
+    std::vector<std::unique_ptr<SimulatedUniverse>> batch;
+    for (int i = 0; i < 300; ++i) {
+        batch.push_back(randomUniverse(random, i));
+    }
+    const int first = db.addUniverses(std::move(batch));
+    for (int i = 300; i < 400; ++i) {
+        db.addUniverse(randomUniverse(random, i));
+    }
+
+    // Remove every third universe, and the extremes of matter density
+    std::vector<int> removed;
+    for (int id = first; id < first + 400; id += 3) {
+        removed.push_back(id);
+    }
+    const auto before = db.getStatistics();
+    for (int id = first; id < first + 400; ++id) {
+        const double matter = db.getUniverse(id)->getMatterDensity();
+        if (matter == before.quantities[0].min || matter == before.quantities[0].max) {
+            removed.push_back(id);
+        }
+    }
+    for (int id : removed) {
+        db.removeUniverse(id);
+    }
+
+    std::vector<EnsembleStatistics::Sample> remaining;
+    for (const auto& entry : db.getAllUniverses()) {
+        remaining.push_back(EnsembleStatistics::Sample::of(*entry.universe));
+    }
+    expectSameStatistics(db.getStatistics(), bruteForce(remaining));
+}
+
+TEST(EnsembleStatisticsTest, RemovingAValueHeldByOthersNeedsNoRebuild) {
+    // One shard: ids that are multiples of kShards
+    const auto id = [](int n) { return n * static_cast<int>(EnsembleStatistics::kShards); };
+    std::vector<EnsembleStatistics::Sample> samples;
+    for (double hubble : {60.0, 65.0, 70.0, 70.0}) {
+        samples.push_back(EnsembleStatistics::Sample::of(SimulatedUniverse("H", 0.3, 0.7, hubble, 1e-9, -1.0)));
+    }
+    EnsembleStatistics statistics;
+    for (int n = 0; n < 4; ++n) {
+        statistics.add(id(n), samples[n]);
+    }
+
+    // The middle universe holds no extreme alone: constant quantities such as
+    // the Big Bang time are shared with the others
+    EXPECT_TRUE(statistics.remove(id(1), samples[1]));
+    expectSameStatistics(statistics.snapshot(), bruteForce({samples[0], samples[2], samples[3]}));
+    // Two universes share the maximum Hubble constant
+    EXPECT_TRUE(statistics.remove(id(3), samples[3]));
+    expectSameStatistics(statistics.snapshot(), bruteForce({samples[0], samples[2]}));
+    // The last one at the maximum makes it unknown
+    EXPECT_FALSE(statistics.remove(id(2), samples[2]));
+}
@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+#include "../src/ExpansionHistory.hpp"
+#include <algorithm>
+
+TEST(ExpansionHistoryTest, MatterOnlyAgeMatchesAnalyticResult) {
+    // Einstein-de Sitter: a = 1 at t = 2 / (3 H₀)
+    const UniverseParameters params(1.0, 0.0, 70.0, 1e-9, -1.0);
+    const ExpansionHistory history(params);
+    const double age = 2.0 / (3.0 * 70.0 * 1.0227e-3);
+
+    EXPECT_NEAR(history.sampleAt(age).scaleFactor, 1.0, 1e-3);
+    EXPECT_NEAR(history.sampleAt(age).hubble, 70.0, 0.1);
+}
+
+TEST(ExpansionHistoryTest, LambdaCdmEvolvesFromRadiationToDarkEnergy) {
+    const UniverseParameters params(0.3, 0.7, 70.0, 1e-9, -1.0);
+    const ExpansionHistory history(params);
+
+    // Age of a flat ΛCDM universe with these parameters is about 13.47 Gyr
+    EXPECT_NEAR(history.sampleAt(13.47).scaleFactor, 1.0, 0.01);
+
+    const auto early = history.sampleAt(history.startTime());
+    EXPECT_GT(early.radiationFraction, 0.99);
+    EXPECT_NEAR(early.temperature * early.scaleFactor, ExpansionHistory::kTemperatureToday, 1e-9);
+
+    const auto late = history.sampleAt(history.endTime());
+    EXPECT_GT(late.darkEnergyFraction, 0.99);
+}
+
+TEST(ExpansionHistoryTest, SamplerRefinesUntilToleranceOrBudget) {
+    const UniverseParameters params(0.3, 0.7, 70.0, 1e-9, -1.0);
+    ExpansionSampler sampler(params, 5000, 1e-3);
+
+    auto samples = sampler.coarse(32);
+    ASSERT_EQ(samples.size(), 32u);
+    while (!sampler.done()) {
+        auto chunk = sampler.refine(256);
+        ASSERT_FALSE(chunk.empty());
+        samples.insert(samples.end(), chunk.begin(), chunk.end());
+    }
+
+    EXPECT_EQ(samples.size(), sampler.sampleCount());
+    EXPECT_LE(samples.size(), 5000u);
+    EXPECT_GT(samples.size(), 32u);
+
+    std::sort(samples.begin(), samples.end(),
+              [](const auto& a, const auto& b) { return a.time < b.time; });
+    for (size_t i = 1; i < samples.size(); ++i) {
+        EXPECT_LT(samples[i - 1].time, samples[i].time);
+        EXPECT_LE(samples[i - 1].scaleFactor, samples[i].scaleFactor);
+    }
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+#include "../src/FastMath.hpp"
+#include "../src/MilestoneFormulas.hpp"
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <random>
+
+// The exponents the milestone formulas use
+static constexpr double kExponents[] = {0.25, -0.3, -0.2, 0.15, 0.1, -0.5};
+
+// Every binade of the normal numbers, every table interval in each, four
+// points per interval including both of its ends, against std::pow (the
+// exact mode). The maximum errors are printed for the record.
+TEST(FastMathTest, ErrorIsBoundedOverAllNormalNumbers) {
+    for (double p : kExponents) {
+        double maxError = 0.0;
+        double worst = 0.0;
+        for (int e = -1022; e <= 1023; ++e) {
+            for (int i = 0; i < 64; ++i) {
+                for (double offset : {0.0, 0.3, 0.7, 1.0}) {
+                    const double m = std::nextafter(1.0 + (i + offset) / 64.0, 1.0);
+                    const double x = std::ldexp(m, e);
+                    const double exact = std::pow(x, p);
+                    const double error = std::abs(FastMath::pow(x, p) - exact) / exact;
+                    if (error > maxError) {
+                        maxError = error;
+                        worst = x;
+                    }
+                }
+            }
+        }
+        std::printf("x^%g: max relative error %.3g at x = %.17g\n", p, maxError, worst);
+        EXPECT_LT(maxError, 1e-10) << "x^" << p << " at " << worst;
+    }
+}
+
+TEST(FastMathTest, OtherArgumentsTakeStdPow) {
+    const double inf = std::numeric_limits<double>::infinity();
+    for (double p : kExponents) {
+        for (double x : {0.0, -0.0, inf, DBL_MIN / 4}) {
+            EXPECT_EQ(FastMath::pow(x, p), std::pow(x, p)) << x << "^" << p;
+        }
+        EXPECT_TRUE(std::isnan(FastMath::pow(-2.0, p)));
+        EXPECT_TRUE(std::isnan(FastMath::pow(std::nan(""), p)));
+    }
+    EXPECT_EQ(FastMath::pow(2.0, 3.0), 8.0);  // |p| too large for the fast path
+    EXPECT_EQ(FastMath::pow(16.0, 0.25), 2.0);
+    EXPECT_EQ(FastMath::pow(4.0, -0.5), 0.5);
+}
+
+TEST(FastMathTest, FastTimestampsMatchExactOnes) {
+    std::mt19937_64 random(9);
+    std::uniform_real_distribution<double> matter(0.0, 2.0);
+    std::uniform_real_distribution<double> darkEnergy(0.0, 1.0);
+    std::uniform_real_distribution<double> hubble(50.0, 80.0);
+    std::uniform_real_distribution<double> logRatio(-20.0, -7.0);
+    std::uniform_real_distribution<double> w(-2.0, -0.3);
+    for (int i = 0; i < 20000; ++i) {
+        const UniverseParameters params(matter(random), darkEnergy(random), hubble(random),
+                                        std::pow(10.0, logRatio(random)), w(random));
+        for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+            const auto type = static_cast<MilestoneType>(t);
+            const double exact = MilestoneFormulas::timestamp(type, params, MilestoneFormulas::Precision::Exact);
+            const double fast = MilestoneFormulas::timestamp(type, params, MilestoneFormulas::Precision::Fast);
+            if (exact <= 0.0) {
+                EXPECT_EQ(fast, exact);  // sentinels and the Big Bang are exact
+            } else {
+                EXPECT_LE(std::abs(fast - exact), exact * 1e-10) << kMilestoneTypeNames[t];
+            }
+        }
+    }
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+#include "../src/FuzzyNameIndex.hpp"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+// Sellers' recurrence, written out plainly as the reference
+static int referenceDistance(const std::string& pattern, const std::string& text) {
+    std::vector<int> column(pattern.size() + 1);
+    for (size_t i = 0; i <= pattern.size(); ++i) {
+        column[i] = static_cast<int>(i);
+    }
+    int best = column.back();
+    for (char c : text) {
+        std::vector<int> next(pattern.size() + 1, 0);
+        for (size_t i = 1; i <= pattern.size(); ++i) {
+            next[i] = std::min({column[i] + 1, next[i - 1] + 1, column[i - 1] + (pattern[i - 1] != c)});
+        }
+        column = next;
+        best = std::min(best, column.back());
+    }
+    return best;
+}
+
+static std::string randomText(std::mt19937& random, size_t length, const char* alphabet) {
+    const size_t letters = std::char_traits<char>::length(alphabet);
+    std::string text;
+    for (size_t i = 0; i < length; ++i) {
+        text += alphabet[random() % letters];
+    }
+    return text;
+}
+
+static std::string lower(std::string text) {
+    for (char& c : text) {
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    }
+    return text;
+}
+
+TEST(FuzzyNameIndexTest, DistanceMatchesDynamicProgram) {
+    std::mt19937 random(7);
+    for (int trial = 0; trial < 5000; ++trial) {
+        // Patterns up to 70 bytes cover both the one-word path and the fallback
+        const std::string pattern = randomText(random, 1 + random() % (trial % 10 == 0 ? 70 : 12), "abc");
+        const std::string text = randomText(random, random() % 30, "abcd");
+        const int expected = referenceDistance(pattern, text);
+        for (int k : {0, 1, 2, 4, 100}) {
+            EXPECT_EQ(FuzzyNameIndex::distance(pattern, text, k), std::min(expected, k + 1))
+                << pattern << " in " << text << " with k=" << k;
+        }
+    }
+    EXPECT_EQ(FuzzyNameIndex::distance("", "anything", 2), 0);
+    EXPECT_EQ(FuzzyNameIndex::distance("phantm", "phantom rip", 2), 1);
+}
+
+TEST(FuzzyNameIndexTest, FiltersNeverLoseAMatch) {
+    // A small alphabet makes the term's posting lists long, so the search
+    // scans; a large one takes the posting lists
+    for (const char* alphabet : {"aAbBcde ", "abcdefghijklmnopqrstuvwxyzABCDE"}) {
+        SCOPED_TRACE(alphabet);
+        std::mt19937 random(11);
+        std::vector<std::string> names;
+        FuzzyNameIndex index;
+        for (int id = 0; id < 3000; ++id) {
+            names.push_back(randomText(random, 3 + random() % 15, alphabet));
+            index.insert(id, names.back());
+        }
+        // Renamed names leave stale postings behind
+        for (int id = 0; id < 3000; id += 7) {
+            names[id] = randomText(random, 3 + random() % 15, alphabet);
+            index.insert(id, names[id]);
+        }
+        for (int trial = 0; trial < 200; ++trial) {
+            const std::string term = randomText(random, 1 + random() % 8, alphabet);
+            for (int k = 0; k <= 3; ++k) {
+                std::vector<FuzzyNameIndex::Match> expected;
+                for (int id = 0; id < static_cast<int>(names.size()); ++id) {
+                    const int distance = referenceDistance(lower(term), lower(names[id]));
+                    if (distance <= k) {
+                        expected.push_back({id, distance});
+                    }
+                }
+                std::sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) {
+                    return a.distance != b.distance ? a.distance < b.distance : a.id < b.id;
+                });
+
+                // Everything, and the best few
+                for (size_t limit : {names.size(), size_t{5}}) {
+                    const auto found = index.search(term, k, limit);
+                    ASSERT_EQ(found.size(), std::min(limit, expected.size())) << term << " with k=" << k;
+                    for (size_t i = 0; i < found.size(); ++i) {
+                        EXPECT_EQ(found[i].id, expected[i].id);
+                        EXPECT_EQ(found[i].distance, expected[i].distance);
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(FuzzyNameIndexTest, ForgivesTyposAndRanksClosestFirst) {
+    FuzzyNameIndex index;
+    index.insert(0, "Phantom Rip");
+    index.insert(1, "Phantasm");
+    index.insert(2, "Standard Model");
+    index.insert(3, "PHANTOM");
+    index.insert(4, "Closed Crunch");
+
+    // "Phantasm" holds "phanta", one substitution away
+    auto matches = index.search("Phantm", 1, 10);
+    ASSERT_EQ(matches.size(), 3u);
+    EXPECT_EQ(matches[0].id, 0);
+    EXPECT_EQ(matches[1].id, 1);
+    EXPECT_EQ(matches[2].id, 3);
+    EXPECT_EQ(matches[0].distance, 1);
+
+    matches = index.search("phantom", 2, 10);
+    ASSERT_EQ(matches.size(), 3u);  // Phantasm two substitutions away
+    EXPECT_EQ(matches[0].distance, 0);
+    EXPECT_EQ(matches[1].distance, 0);
+    EXPECT_EQ(matches[2].id, 1);
+
+    EXPECT_EQ(index.search("phantom", 2, 1).size(), 1u);
+    EXPECT_TRUE(index.search("xyzzy", 1, 10).empty());
+}
+
+TEST(FuzzyNameIndexTest, FollowsRenamesAndRemovals) {
+    FuzzyNameIndex index;
+    index.insert(0, "Andromeda");
+    index.insert(1, "Milky Way");
+    EXPECT_EQ(index.size(), 2u);
+
+    index.insert(0, "Triangulum");  // rename
+    EXPECT_TRUE(index.search("andromeda", 1, 10).empty());
+    ASSERT_EQ(index.search("triangulm", 1, 10).size(), 1u);
+
+    index.remove(1);
+    index.remove(1);
+    index.remove(42);
+    EXPECT_EQ(index.size(), 1u);
+    EXPECT_TRUE(index.search("milky", 0, 10).empty());
+}
+
+TEST(FuzzyNameIndexTest, SearchesManyNamesInteractively) {
+    std::mt19937 random(3);
+    FuzzyNameIndex index;
+    for (int id = 0; id < 200000; ++id) {
+        index.insert(id, "Universe " + randomText(random, 6 + random() % 10, "abcdefghijklmnopqrstuvwxyz"));
+    }
+    index.insert(200000, "Phantom Rip");
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto matches = index.search("phantm", 1, 100);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    ASSERT_FALSE(matches.empty());
+    EXPECT_TRUE(std::any_of(matches.begin(), matches.end(), [](const auto& m) { return m.id == 200000; }));
+    // Generous for unoptimized builds; -O2 takes a few ms
+    EXPECT_LT(seconds, 1.0);
+}
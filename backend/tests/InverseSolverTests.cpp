@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "../src/InverseSolver.hpp"
+#include "../src/SimulatedUniverse.hpp"
+#include "../src/UniverseValidator.hpp"
+#include <random>
+
+static bool isValid(const UniverseParameters& p) {
+    return UniverseValidator::validateParameters(p.getMatterDensity(), p.getDarkEnergyDensity(),
+                                                 p.getHubbleConstant(), p.getMatterAntimatterRatio(),
+                                                 p.getDarkEnergyW()).isValid;
+}
+
+TEST(InverseSolverTest, EveryPointMapsToValidParameters) {
+    std::mt19937_64 random(7);
+    std::uniform_real_distribution<double> u(-0.2, 1.2);
+    for (int i = 0; i < 10000; ++i) {
+        const InverseSolver::Point point{u(random), u(random), u(random), u(random), u(random)};
+        ASSERT_TRUE(isValid(InverseSolver::toParameters(point)));
+    }
+}
+
+TEST(InverseSolverTest, RecoversReachableTargets) {
+    // First stars at 0.15 Gyr, accelerated expansion at 4 Gyr, Big Rip
+    InverseSolver::Problem problem;
+    problem.targets = {{MilestoneType::FirstStars, 0.15}, {MilestoneType::AcceleratedExpansion, 4.0}};
+    problem.ending = MilestoneType::BigRip;
+
+    InverseSolver::Options options;
+    options.budget = std::chrono::milliseconds(2000);
+    const auto result = InverseSolver(problem).solve(options);
+
+    EXPECT_TRUE(result.converged);
+    ASSERT_FALSE(result.candidates.empty());
+    for (const auto& candidate : result.candidates) {
+        EXPECT_TRUE(isValid(candidate.parameters));
+    }
+    const auto& best = result.candidates.front();
+    ASSERT_EQ(best.errors.size(), 3u);
+    EXPECT_LT(best.errors[0], 1e-3);
+    EXPECT_LT(best.errors[1], 1e-3);
+    EXPECT_EQ(SimulatedUniverse::ending(best.parameters), MilestoneType::BigRip);
+}
+
+TEST(InverseSolverTest, ConflictingTargetsKeepParetoFront) {
+    // Recombination and first stars both depend on matter density only, in
+    // opposite directions, so no point hits both
+    InverseSolver::Problem problem;
+    problem.targets = {{MilestoneType::Recombination, 0.0002}, {MilestoneType::FirstStars, 0.1}};
+
+    InverseSolver::Options options;
+    options.budget = std::chrono::milliseconds(2000);
+    const auto result = InverseSolver(problem).solve(options);
+
+    EXPECT_FALSE(result.converged);
+    ASSERT_FALSE(result.candidates.empty());
+    for (size_t i = 1; i < result.candidates.size(); ++i) {
+        EXPECT_LE(result.candidates[i - 1].cost, result.candidates[i].cost);
+    }
+}
+
+TEST(InverseSolverTest, ZeroBudgetRunsNoStarts) {
+    InverseSolver::Problem problem;
+    problem.targets = {{MilestoneType::FirstStars, 0.2}};
+    InverseSolver::Options options;
+    options.budget = std::chrono::milliseconds(0);
+
+    const auto result = InverseSolver(problem).solve(options);
+    EXPECT_TRUE(result.timedOut);
+    EXPECT_EQ(result.startsRun, 0u);
+    EXPECT_TRUE(result.candidates.empty());
+}
@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include "../src/JsonWriter.hpp"
+#include "../src/SimulatedUniverse.hpp"
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+// DOM-based serialization that SimulatedUniverse::toJSON used to perform
+static std::string domUniverseJson(const SimulatedUniverse& universe) {
+    nlohmann::json j;
+    j["name"] = universe.getName();
+    j["matterDensity"] = universe.getMatterDensity();
+    j["darkEnergyDensity"] = universe.getDarkEnergyDensity();
+    j["hubbleConstant"] = universe.getHubbleConstant();
+    j["matterAntimatterRatio"] = universe.getMatterAntimatterRatio();
+    j["darkEnergyW"] = universe.getDarkEnergyW();
+    j["timeline"] = universe.generateTimeline()->toJson();
+    return j.dump(4);
+}
+
+TEST(JsonWriterTest, UniverseMatchesDomOutput) {
+    std::vector<SimulatedUniverse> universes = {
+        {"Standard", 0.3, 0.7, 70.0, 1e-9, -1.0},
+        {"Phantom \"Rip\"", 0.25, 0.75, 68.2, 3e-10, -1.4},
+        {"Closed\tCrunch", 1.5, 0.2, 55.0, 1e-8, -0.6},
+        {"Low matter", 0.05, 0.0, 80.0, 1e-11, -0.5},
+    };
+
+    for (const auto& universe : universes) {
+        SCOPED_TRACE(universe.getName());
+        EXPECT_EQ(universe.toJSON(), domUniverseJson(universe));
+    }
+}
+
+TEST(JsonWriterTest, TimelineMatchesDomOutput) {
+    SimulatedUniverse universe("Timeline", 0.31, 0.69, 67.4, 6e-10, -1.1);
+    auto timeline = universe.generateTimeline();
+
+    for (int indent : {-1, 0, 2, 4}) {
+        JsonWriter writer(indent);
+        timeline->write(writer);
+        EXPECT_EQ(writer.str(), timeline->toJson().dump(indent));
+    }
+}
+
+TEST(JsonWriterTest, NumbersMatchDomOutput) {
+    const std::vector<double> values = {
+        0.0, -0.0, 1.0, -1.0, 0.3, 1e-49, 1.5e-13, 3.168808781402895e-23,
+        1e-4, 1e-5, 123456789012345.0, 1e15, 1e16, 1e100, 20.0 / 3.0,
+    };
+
+    for (double value : values) {
+        std::pmr::string text;
+        JsonWriter::appendDouble(text, value);
+        EXPECT_EQ(std::string_view(text), nlohmann::json(value).dump());
+    }
+}
+
+TEST(JsonWriterTest, IntegersKeepAllSixtyFourBits) {
+    const std::vector<std::int64_t> values = {0, -1, 2147483648, 5000000000, INT64_MAX, INT64_MIN};
+
+    JsonWriter writer(-1);
+    writer.beginArray();
+    for (std::int64_t value : values) {
+        writer.value(value);
+    }
+    writer.value(42);
+    writer.endArray();
+    EXPECT_EQ(writer.str(), "[0,-1,2147483648,5000000000,9223372036854775807,-9223372036854775808,42]");
+}
+
+TEST(JsonWriterTest, StringsAndContainersMatchDomOutput) {
+    nlohmann::json dom;
+    dom["empty_array"] = nlohmann::json::array();
+    dom["empty_object"] = nlohmann::json::object();
+    dom["escaped"] = std::string("quote\" backslash\\ \b\f\n\r\t \x01 \x1f \x7f / \xc3\xa9");
+    dom["flags"] = {true, false};
+    dom["nothing"] = nullptr;
+
+    for (int indent : {-1, 4}) {
+        JsonWriter writer(indent);
+        writer.beginObject();
+        writer.key("empty_array");
+        writer.beginArray();
+        writer.endArray();
+        writer.key("empty_object");
+        writer.beginObject();
+        writer.endObject();
+        writer.key("escaped");
+        writer.value(dom["escaped"].get<std::string>());
+        writer.key("flags");
+        writer.beginArray();
+        writer.boolean(true);
+        writer.boolean(false);
+        writer.endArray();
+        writer.key("nothing");
+        writer.null();
+        writer.endObject();
+
+        EXPECT_EQ(writer.str(), dom.dump(indent));
+    }
+}
+
+TEST(JsonWriterTest, PiecesConcatenateToTheWholeDocument) {
+    const std::vector<SimulatedUniverse> universes = {
+        {"Standard", 0.3, 0.7, 70.0, 1e-9, -1.0},
+        {"Phantom", 0.25, 0.75, 68.2, 3e-10, -1.4},
+        {"Closed", 1.5, 0.2, 55.0, 1e-8, -0.6},
+    };
+
+    JsonWriter whole(4);
+    whole.beginArray();
+    for (const auto& universe : universes) {
+        universe.write(whole);
+    }
+    whole.endArray();
+
+    // One piece per universe, cleared after each
+    JsonWriter pieces(4);
+    std::string joined;
+    pieces.beginArray();
+    for (const auto& universe : universes) {
+        universe.write(pieces);
+        joined += pieces.str();
+        pieces.clear();
+    }
+    pieces.endArray();
+    joined += pieces.str();
+    EXPECT_EQ(joined, whole.str());
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "../src/LatencyHistogram.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST(LatencyHistogramTest, BucketsCoverValuesWithBoundedError) {
+    std::mt19937_64 random(1);
+    for (int i = 0; i < 100000; ++i) {
+        const std::uint64_t value = random() >> (random() % 64);
+        const std::size_t bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_LT(bucket, LatencyHistogram::kBuckets);
+        const std::uint64_t high = LatencyHistogram::highestEquivalent(bucket);
+        ASSERT_GE(high, value);
+        ASSERT_LE(high - value, value / 64) << value;
+        if (bucket > 0) {
+            ASSERT_LT(LatencyHistogram::highestEquivalent(bucket - 1), value);
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::bucketOf(UINT64_MAX), LatencyHistogram::kBuckets - 1);
+}
+
+TEST(LatencyHistogramTest, PercentilesMatchSortedSamples) {
+    std::mt19937_64 random(2);
+    std::lognormal_distribution<double> latency(11.0, 1.5);  // around 60us, long tail
+    std::vector<std::uint64_t> samples;
+    LatencyHistogram first;
+    LatencyHistogram second;
+    for (int i = 0; i < 200000; ++i) {
+        const auto value = static_cast<std::uint64_t>(latency(random));
+        samples.push_back(value);
+        (i % 2 ? first : second).record(value);
+    }
+    first.merge(second);
+    std::sort(samples.begin(), samples.end());
+
+    EXPECT_EQ(first.getCount(), samples.size());
+    EXPECT_EQ(first.getMax(), samples.back());
+    for (double q : {0.0, 0.5, 0.9, 0.99, 0.999, 1.0}) {
+        const std::uint64_t exact = samples[std::max<size_t>(1, std::ceil(q * samples.size())) - 1];
+        const std::uint64_t reported = first.percentile(q);
+        EXPECT_GE(reported, exact) << q;
+        EXPECT_LE(reported - exact, exact / 64) << q;
+    }
+}
@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+#include "../src/LatestWinsQueue.hpp"
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(LatestWinsQueueTest, BurstRunsOnlyRunningAndNewestJob) {
+    LatestWinsQueue queue;
+    std::mutex mutex;
+    std::vector<std::uint64_t> ran;
+    std::atomic<bool> release{false};
+
+    for (int i = 0; i < 100; ++i) {
+        queue.submit(1, [&](std::uint64_t sequence) {
+            while (!release) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            ran.push_back(sequence);
+        });
+    }
+    release = true;
+    queue.drain();
+
+    // The first job may or may not have started before the others arrived
+    ASSERT_GE(ran.size(), 1u);
+    ASSERT_LE(ran.size(), 2u);
+    EXPECT_EQ(ran.back(), 100u);
+    const auto stats = queue.getStats();
+    EXPECT_EQ(stats.submitted, 100u);
+    EXPECT_EQ(stats.started + stats.superseded, 100u);
+}
+
+TEST(LatestWinsQueueTest, RunningJobSeesWhenSuperseded) {
+    LatestWinsQueue queue;
+    std::atomic<bool> started{false};
+    std::atomic<bool> current{true};
+    std::atomic<bool> release{false};
+
+    queue.submit(7, [&](std::uint64_t sequence) {
+        started = true;
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        current = queue.isCurrent(7, sequence);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(queue.submit(7, [](std::uint64_t) {}), 2u);
+    release = true;
+    queue.drain();
+    EXPECT_FALSE(current);
+}
+
+TEST(LatestWinsQueueTest, ClientsDoNotSupersedeEachOther) {
+    LatestWinsQueue queue;
+    std::atomic<int> ran{0};
+    for (std::size_t client = 0; client < 8; ++client) {
+        EXPECT_EQ(queue.submit(client, [&](std::uint64_t) { ++ran; }), 1u);
+    }
+    queue.drain();
+    EXPECT_EQ(ran, 8);
+    EXPECT_TRUE(queue.isCurrent(3, 1));
+}
+
+TEST(LatestWinsQueueTest, ClientsShareAtMostMaxWorkers) {
+    LatestWinsQueue queue(2);
+    std::atomic<int> running{0};
+    std::atomic<int> peak{0};
+    std::atomic<int> finished{0};
+
+    for (std::size_t client = 0; client < 8; ++client) {
+        queue.submit(client, [&](std::uint64_t) {
+            const int now = ++running;
+            int seen = peak;
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            --running;
+            ++finished;
+        });
+    }
+    queue.drain();
+
+    // Waiting clients are not dropped, only delayed
+    EXPECT_EQ(finished, 8);
+    EXPECT_LE(peak, 2);
+    EXPECT_EQ(queue.getStats().started, 8u);
+}
+
+TEST(LatestWinsQueueTest, ReleaseDropsQueuedJobAndForgetsClient) {
+    LatestWinsQueue queue;
+    std::atomic<bool> started{false};
+    std::atomic<bool> current{true};
+    std::atomic<bool> release{false};
+    std::atomic<bool> queuedRan{false};
+
+    queue.submit(7, [&](std::uint64_t sequence) {
+        started = true;
+        while (!release) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        current = queue.isCurrent(7, sequence);
+    });
+    while (!started) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    queue.submit(7, [&](std::uint64_t) { queuedRan = true; });
+    queue.release(7);
+    release = true;
+    queue.drain();
+
+    EXPECT_FALSE(current);
+    EXPECT_FALSE(queuedRan);
+    // The entry went with the running job, so sequences start over
+    EXPECT_EQ(queue.submit(7, [](std::uint64_t) {}), 1u);
+    queue.drain();
+    queue.release(7);
+    EXPECT_FALSE(queue.isCurrent(7, 1));
+}
@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+#include "../src/SimulatedUniverse.hpp"
+#include <vector>
+
+static std::vector<SimulatedUniverse> sampleUniverses() {
+    return {
+        {"Heat death", 0.3, 0.7, 70.0, 1e-9, -1.0},
+        {"Big rip", 0.25, 0.75, 68.2, 3e-10, -1.4},
+        {"Big crunch", 1.5, 0.0, 55.0, 1e-8, -0.6},
+        {"No stars", 0.05, 0.0, 80.0, 1e-11, -0.5},
+    };
+}
+
+TEST(LazyTimelineTest, MatchesGeneratedTimeline) {
+    for (const auto& universe : sampleUniverses()) {
+        SCOPED_TRACE(universe.getName());
+        auto timeline = universe.generateTimeline();
+        const auto& milestones = timeline->getMilestones();
+        const LazyTimeline lazy = universe.lazyTimeline();
+
+        ASSERT_EQ(lazy.size(), milestones.size());
+        for (size_t i = 0; i < lazy.size(); ++i) {
+            EXPECT_EQ(lazy.typeAt(i), milestones[i]->getType());
+            EXPECT_EQ(lazy.timestampAt(i), milestones[i]->calculateTimestamp());
+            EXPECT_EQ(lazy.timestampAt(i), milestones[i]->calculateTimestamp());  // cached
+            EXPECT_EQ(lazy.descriptionAt(i), milestones[i]->getDescription());
+            EXPECT_EQ(lazy.assetIdAt(i), milestones[i]->getAssetId());
+        }
+    }
+}
+
+TEST(LazyTimelineTest, EndingMatchesLastMilestone) {
+    const std::vector<std::optional<MilestoneType>> expected = {
+        MilestoneType::HeatDeath, MilestoneType::BigRip, MilestoneType::BigCrunch, std::nullopt,
+    };
+    const auto universes = sampleUniverses();
+
+    for (size_t i = 0; i < universes.size(); ++i) {
+        SCOPED_TRACE(universes[i].getName());
+        EXPECT_EQ(universes[i].ending(), expected[i]);
+        if (expected[i]) {
+            EXPECT_EQ(universes[i].generateTimeline()->getMilestones().back()->getType(), *expected[i]);
+        }
+    }
+}
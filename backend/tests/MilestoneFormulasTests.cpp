@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include "../src/MilestoneFormulas.hpp"
+#include "../src/SimulatedUniverse.hpp"
+#include <cmath>
+#include <vector>
+
+namespace {
+double& component(MilestoneFormulas::Parameters<double>& params, size_t index) {
+    double* fields[] = {&params.matterDensity, &params.darkEnergyDensity, &params.hubbleConstant,
+                        &params.matterAntimatterRatio, &params.darkEnergyW};
+    return *fields[index];
+}
+}
+
+TEST(MilestoneFormulasTest, DualValueMatchesDoubleEvaluation) {
+    SimulatedUniverse universe("Phantom", 0.25, 0.75, 68.2, 3e-10, -1.4);
+    auto timeline = universe.generateTimeline();
+    const auto rows = universe.timestampJacobian();
+    const auto& milestones = timeline->getMilestones();
+
+    ASSERT_EQ(rows.size(), milestones.size());
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(rows[i].type, milestones[i]->getType());
+        EXPECT_EQ(rows[i].timestamp, milestones[i]->calculateTimestamp());
+    }
+}
+
+TEST(MilestoneFormulasTest, GradientMatchesCentralDifferences) {
+    const std::vector<UniverseParameters> cases = {
+        {0.3, 0.7, 70.0, 1e-9, -0.9},  // off the w = -1 branch point
+        {0.25, 0.75, 68.2, 3e-10, -1.4},
+        {0.5, 0.9, 60.0, 1e-8, -0.2},  // closed with w above -1/3: Big Crunch formula
+    };
+
+    for (const auto& params : cases) {
+        for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+            const auto type = static_cast<MilestoneType>(t);
+            SCOPED_TRACE(t);
+            const auto row = MilestoneFormulas::timestampGradient(type, params);
+
+            for (size_t p = 0; p < MilestoneFormulas::kParameterCount; ++p) {
+                auto plus = MilestoneFormulas::fromUniverseParameters(params);
+                auto minus = plus;
+                const double h = 1e-6 * std::max(std::abs(component(plus, p)), 1e-9);
+                component(plus, p) += h;
+                component(minus, p) -= h;
+                const double numeric = (MilestoneFormulas::timestamp(type, plus) -
+                                        MilestoneFormulas::timestamp(type, minus)) / (2.0 * h);
+                EXPECT_NEAR(row.gradient[p], numeric, 1e-6 * std::max(std::abs(numeric), 1e-12))
+                    << MilestoneFormulas::kParameterNames[p];
+            }
+        }
+    }
+}
+
+TEST(MilestoneFormulasTest, KnownDerivatives) {
+    // t_rip = 20 * (-w / 1.2)^-0.5, so dt/dw = -0.5 * t / w
+    const UniverseParameters params(0.3, 0.7, 70.0, 1e-9, -1.5);
+    const auto row = MilestoneFormulas::timestampGradient(MilestoneType::BigRip, params);
+    EXPECT_NEAR(row.gradient[4], -0.5 * row.timestamp / -1.5, 1e-12);
+    EXPECT_EQ(row.gradient[0], 0.0);
+
+    // Sentinel timestamps carry no gradient
+    const auto none = MilestoneFormulas::timestampGradient(
+        MilestoneType::BigRip, UniverseParameters(0.3, 0.7, 70.0, 1e-9, -0.9));
+    EXPECT_EQ(none.timestamp, -1.0);
+    for (double d : none.gradient) EXPECT_EQ(d, 0.0);
+}
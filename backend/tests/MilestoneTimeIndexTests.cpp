@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "../src/MilestoneTimeIndex.hpp"
+#include "../src/UniverseDB.hpp"
+#include <algorithm>
+#include <random>
+#include <string>
+
+static std::vector<std::unique_ptr<SimulatedUniverse>> randomUniverses(size_t count, unsigned seed) {
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    std::vector<std::unique_ptr<SimulatedUniverse>> universes;
+    for (size_t i = 0; i < count; ++i) {
+        universes.push_back(std::make_unique<SimulatedUniverse>(
+            "U" + std::to_string(i), 0.1 + 1.9 * unit(random), unit(random), 50.0 + 30.0 * unit(random),
+            1e-9, -2.0 + 1.5 * unit(random)));
+    }
+    return universes;
+}
+
+// Linear scan over every timeline
+static std::vector<std::pair<double, int>> scan(const std::vector<std::unique_ptr<SimulatedUniverse>>& universes,
+                                                MilestoneType type, double from, double to) {
+    std::vector<std::pair<double, int>> matches;
+    for (size_t id = 0; id < universes.size(); ++id) {
+        if (!universes[id]) continue;
+        const auto& timeline = universes[id]->getComputedTimeline().timeline();
+        for (size_t i = 0; i < timeline.size(); ++i) {
+            const double t = timeline.timestampAt(i);
+            if (timeline.typeAt(i) == type && t >= from && t <= to) {
+                matches.emplace_back(t, static_cast<int>(id));
+            }
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    return matches;
+}
+
+TEST(MilestoneTimeIndexTest, QueriesMatchLinearScan) {
+    auto universes = randomUniverses(400, 5);
+    MilestoneTimeIndex index;
+    for (size_t id = 0; id < universes.size(); ++id) {
+        index.insert(static_cast<int>(id), *universes[id]);
+    }
+    for (size_t id = 0; id < universes.size(); id += 4) {
+        index.remove(static_cast<int>(id), *universes[id]);
+        universes[id].reset();
+    }
+
+    struct Window { MilestoneType type; double from, to; };
+    for (const Window& window : {Window{MilestoneType::GalaxyFormation, 0.0, 0.2},
+                                 Window{MilestoneType::BigRip, 20.0, 40.0},
+                                 Window{MilestoneType::BigCrunch, 0.0, 1e9}}) {
+        const auto expected = scan(universes, window.type, window.from, window.to);
+        const auto events = index.query(window.type, window.from, window.to, SIZE_MAX);
+        ASSERT_EQ(events.size(), expected.size());
+        for (size_t i = 0; i < events.size(); ++i) {
+            EXPECT_EQ(events[i].timestamp, expected[i].first);
+            EXPECT_EQ(events[i].id, expected[i].second);
+            EXPECT_EQ(events[i].type, window.type);
+        }
+        // A limit keeps the earliest events
+        const auto limited = index.query(window.type, window.from, window.to, 5);
+        EXPECT_EQ(limited.size(), std::min<size_t>(5, expected.size()));
+    }
+}
+
+TEST(MilestoneTimeIndexTest, MultipleTypesMergeByTime) {
+    auto universes = randomUniverses(200, 9);
+    auto& db = UniverseDB::instance();
+    const int first = db.addUniverses(std::move(universes));
+
+    const auto events = db.findEvents({MilestoneType::FirstStars, MilestoneType::GalaxyFormation}, 0.0, 0.5, 50);
+    ASSERT_EQ(events.size(), 50u);
+    EXPECT_TRUE(std::is_sorted(events.begin(), events.end(),
+                               [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; }));
+
+    // Removed universes drop out of the index
+    const int removed = events.front().id;
+    db.removeUniverse(removed);
+    for (const auto& event : db.findEvents({MilestoneType::FirstStars, MilestoneType::GalaxyFormation}, 0.0, 0.5, 400)) {
+        EXPECT_NE(event.id, removed);
+        EXPECT_GE(event.id, first);
+    }
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+#include "../src/ParameterIndex.hpp"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+
+namespace {
+std::vector<ParameterIndex::Neighbor> bruteForce(const std::map<int, ParameterIndex::Point>& points,
+                                                 const ParameterIndex::Point& query,
+                                                 const ParameterIndex::Weights& weights) {
+    std::vector<ParameterIndex::Neighbor> all;
+    for (const auto& [id, point] : points) {
+        double sum = 0.0;
+        for (size_t axis = 0; axis < ParameterIndex::kAxes; ++axis) {
+            sum += weights[axis] * (query[axis] - point[axis]) * (query[axis] - point[axis]);
+        }
+        all.push_back({id, std::sqrt(sum)});
+    }
+    std::sort(all.begin(), all.end(), [](const auto& a, const auto& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+    });
+    return all;
+}
+
+void expectSameIds(const std::vector<ParameterIndex::Neighbor>& actual,
+                   const std::vector<ParameterIndex::Neighbor>& expected) {
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        EXPECT_EQ(actual[i].id, expected[i].id);
+        EXPECT_DOUBLE_EQ(actual[i].distance, expected[i].distance);
+    }
+}
+}
+
+TEST(ParameterIndexTest, MatchesBruteForceAcrossInsertsAndRemovals) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto randomPoint = [&] {
+        ParameterIndex::Point point;
+        for (auto& value : point) {
+            value = unit(rng);
+        }
+        return point;
+    };
+
+    ParameterIndex index;
+    std::map<int, ParameterIndex::Point> points;
+    for (int id = 0; id < 3000; ++id) {
+        points[id] = randomPoint();
+        index.insert(id, points[id]);
+        // Leave tombstones and pending entries around for the queries
+        if (id % 7 == 3) {
+            index.remove(id - 2);
+            points.erase(id - 2);
+        }
+    }
+    ASSERT_EQ(index.size(), points.size());
+
+    const std::vector<ParameterIndex::Weights> weightSets = {
+        ParameterIndex::kUniformWeights,
+        {4.0, 1.0, 0.0, 0.5, 2.0},
+    };
+    for (const auto& weights : weightSets) {
+        for (int query = 0; query < 20; ++query) {
+            const auto point = randomPoint();
+            const auto expected = bruteForce(points, point, weights);
+
+            expectSameIds(index.nearest(point, 20, weights),
+                          std::vector<ParameterIndex::Neighbor>(expected.begin(), expected.begin() + 20));
+
+            const double radius = 0.3;
+            auto inside = expected;
+            inside.erase(std::find_if(inside.begin(), inside.end(),
+                                      [&](const auto& n) { return n.distance > radius; }),
+                         inside.end());
+            expectSameIds(index.withinRadius(point, radius, weights), inside);
+        }
+    }
+}
+
+TEST(ParameterIndexTest, NormalizesValidatorRangesToUnitInterval) {
+    const auto low = ParameterIndex::normalize(0.1, 0.0, 50.0, 1e-11, -2.0);
+    const auto high = ParameterIndex::normalize(2.0, 1.0, 80.0, 1e-7, -0.5);
+    for (size_t axis = 0; axis < ParameterIndex::kAxes; ++axis) {
+        EXPECT_NEAR(low[axis], 0.0, 1e-12);
+        EXPECT_NEAR(high[axis], 1.0, 1e-12);
+    }
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "../src/ConstexprMath.hpp"
+#include "../src/LazyTimeline.hpp"
+#include "../src/PresetCatalog.hpp"
+#include "../src/UniverseValidator.hpp"
+#include <cmath>
+#include <random>
+
+// Evaluated by the compiler, or this file would not build
+static_assert(ConstexprMath::sqrt(2.25) == 1.5);
+static_assert(ConstexprMath::pow(16.0, 0.25) > 1.9999999999999 && ConstexprMath::pow(16.0, 0.25) < 2.0000000000001);
+static_assert(PresetCatalog::kPresets[0].ending == MilestoneType::HeatDeath);
+static_assert(PresetCatalog::kPresets[0].milestones[4].type == MilestoneType::Recombination);
+static_assert(PresetCatalog::kPresets[0].milestones[4].timestamp > 0.00037999999 &&
+              PresetCatalog::kPresets[0].milestones[4].timestamp < 0.00038000001);
+
+static double ulps(double actual, double expected) {
+    return std::abs(actual - expected) / (std::abs(expected) * std::numeric_limits<double>::epsilon());
+}
+
+TEST(ConstexprMathTest, AgreesWithCmath) {
+    std::mt19937_64 random(5);
+    std::uniform_real_distribution<double> exponent(-30.0, 30.0);
+    for (int i = 0; i < 100000; ++i) {
+        const double x = std::exp2(exponent(random));
+        EXPECT_LE(ulps(ConstexprMath::sqrt(x), std::sqrt(x)), 1.0) << x;
+        EXPECT_LE(ulps(ConstexprMath::log(x), std::log(x)), 4.0) << x;
+        const double y = exponent(random) / 30.0;
+        EXPECT_LE(ulps(ConstexprMath::exp(y * 20.0), std::exp(y * 20.0)), 4.0) << y;
+        // The exponents the milestone formulas use
+        for (double p : {0.25, -0.3, -0.2, 0.15, 0.1, -0.5}) {
+            EXPECT_LE(ulps(ConstexprMath::pow(x, p), std::pow(x, p)), 4.0) << x << "^" << p;
+        }
+    }
+    EXPECT_EQ(ConstexprMath::pow(0.0, 0.5), 0.0);
+    EXPECT_EQ(ConstexprMath::pow(5.0, 0.0), 1.0);
+    EXPECT_TRUE(std::isnan(ConstexprMath::pow(-1.0, 0.5)));
+    EXPECT_TRUE(std::isnan(ConstexprMath::sqrt(-1.0)));
+    EXPECT_EQ(ConstexprMath::exp(1000.0), std::numeric_limits<double>::infinity());
+}
+
+// The compiler's timelines match what a universe with the same parameters
+// computes at run time
+TEST(PresetCatalogTest, TimelinesMatchRuntimeEvaluation) {
+    for (const auto& preset : PresetCatalog::kPresets) {
+        SCOPED_TRACE(std::string(preset.name));
+        const UniverseParameters& params = preset.parameters;
+        const MilestoneSequence types = SimulatedUniverse::milestoneTypes(params);
+        ASSERT_EQ(preset.milestoneCount, types.size());
+        EXPECT_EQ(preset.ending, SimulatedUniverse::ending(params));
+
+        const LazyTimeline timeline(params, types);
+        for (size_t i = 0; i < types.size(); ++i) {
+            EXPECT_EQ(preset.milestones[i].type, types[i]);
+            const double expected = timeline.timestampAt(i);
+            if (expected == 0.0) {
+                EXPECT_EQ(preset.milestones[i].timestamp, 0.0);
+            } else {
+                EXPECT_LE(ulps(preset.milestones[i].timestamp, expected), 8.0)
+                    << kMilestoneTypeNames[static_cast<size_t>(types[i])];
+            }
+        }
+    }
+}
+
+TEST(PresetCatalogTest, CoversEveryEnding) {
+    std::vector<std::optional<MilestoneType>> endings;
+    for (const auto& preset : PresetCatalog::kPresets) {
+        endings.push_back(preset.ending);
+    }
+    for (std::optional<MilestoneType> ending : {std::optional<MilestoneType>(MilestoneType::HeatDeath),
+                                                std::optional<MilestoneType>(MilestoneType::BigRip),
+                                                std::optional<MilestoneType>(MilestoneType::BigCrunch),
+                                                std::optional<MilestoneType>()}) {
+        EXPECT_NE(std::find(endings.begin(), endings.end(), ending), endings.end())
+            << (ending ? kMilestoneTypeNames[static_cast<size_t>(*ending)] : "no ending");
+    }
+}
+
+// What the page does with a preset: fill the form and create the universe
+TEST(PresetCatalogTest, CreatingAPresetFromTheFormReproducesIt) {
+    for (const auto& preset : PresetCatalog::kPresets) {
+        SCOPED_TRACE(std::string(preset.name));
+        const UniverseParameters& params = preset.parameters;
+        const auto validation = UniverseValidator::validateParameters(
+            params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+            params.getMatterAntimatterRatio(), params.getDarkEnergyW());
+        EXPECT_TRUE(validation.isValid) << validation.message;
+
+        const SimulatedUniverse universe(std::string(preset.name), params.getMatterDensity(),
+                                         params.getDarkEnergyDensity(), params.getHubbleConstant(),
+                                         params.getMatterAntimatterRatio(), params.getDarkEnergyW());
+        const UniverseParameters created = universe.parameters();
+        EXPECT_EQ(created.getDarkMatterRatio(), params.getDarkMatterRatio());
+        EXPECT_EQ(created.getInitialEnergyDensity(), params.getInitialEnergyDensity());
+
+        const auto timeline = universe.generateTimeline();
+        const auto& milestones = timeline->getMilestones();
+        ASSERT_EQ(milestones.size(), preset.milestoneCount);
+        for (size_t i = 0; i < milestones.size(); ++i) {
+            EXPECT_EQ(milestones[i]->getType(), preset.milestones[i].type);
+            const double timestamp = milestones[i]->calculateTimestamp();
+            if (timestamp == 0.0) {
+                EXPECT_EQ(preset.milestones[i].timestamp, 0.0);
+            } else {
+                EXPECT_LE(ulps(preset.milestones[i].timestamp, timestamp), 8.0)
+                    << kMilestoneTypeNames[static_cast<size_t>(milestones[i]->getType())];
+            }
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#include <gtest/gtest.h>
+#include "../src/PriorityScheduler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using Lane = PriorityScheduler::Lane;
+using namespace std::chrono_literals;
+
+// Poll until the condition holds; the scheduler has no hooks for tests
+template <typename Condition>
+static void waitFor(Condition condition) {
+    while (!condition()) {
+        std::this_thread::sleep_for(1ms);
+    }
+}
+
+// Hold an interactive slot on another thread until release is set
+static std::thread holdInteractive(PriorityScheduler& scheduler, std::atomic<bool>& release) {
+    std::thread holder([&] {
+        const auto slot = scheduler.acquire(Lane::Interactive);
+        waitFor([&] { return release.load(); });
+    });
+    waitFor([&] { return scheduler.getStats().interactiveRunning == 1; });
+    return holder;
+}
+
+TEST(PrioritySchedulerTest, BulkSlicePausesWhileInteractiveRuns) {
+    PriorityScheduler scheduler({4, 1, 10s});
+    std::atomic<bool> release{false};
+    std::atomic<int> slices{0};
+
+    std::atomic<bool> admitted{false};
+    std::thread bulk([&] {
+        const auto slot = scheduler.acquire(Lane::Bulk);
+        admitted = true;
+        for (int i = 0; i < 3; ++i) {
+            waitFor([&] { return i == 0 || release.load() || scheduler.getStats().interactiveRunning == 1; });
+            PriorityScheduler::checkpoint();
+            ++slices;
+        }
+    });
+    waitFor([&] { return admitted.load(); });
+
+    std::thread holder = holdInteractive(scheduler, release);
+    std::this_thread::sleep_for(50ms);
+    EXPECT_EQ(slices, 1);  // the second slice waits for the interactive call
+    EXPECT_EQ(scheduler.getStats().bulkPauses, 1u);
+
+    release = true;
+    holder.join();
+    bulk.join();
+    EXPECT_EQ(slices, 3);
+    EXPECT_EQ(scheduler.getStats().bulkAged, 0u);
+}
+
+TEST(PrioritySchedulerTest, BulkWaitsAgeUnderConstantInteractiveLoad) {
+    PriorityScheduler scheduler({4, 1, 20ms});
+    std::atomic<bool> release{false};
+    std::thread holder = holdInteractive(scheduler, release);
+
+    const auto start = std::chrono::steady_clock::now();
+    {
+        const auto slot = scheduler.acquire(Lane::Bulk);
+        PriorityScheduler::checkpoint();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    release = true;
+    holder.join();
+
+    EXPECT_GE(elapsed, 40ms);
+    EXPECT_LT(elapsed, 5s);
+    EXPECT_EQ(scheduler.getStats().bulkAged, 2u);
+}
+
+TEST(PrioritySchedulerTest, CheckpointOutsideASlotIsANoOp) {
+    PriorityScheduler scheduler({4, 1, 10s});
+    std::atomic<bool> release{false};
+    std::thread holder = holdInteractive(scheduler, release);
+    PriorityScheduler::checkpoint();
+    {
+        // Interactive slots never yield
+        const auto slot = scheduler.acquire(Lane::Interactive);
+        PriorityScheduler::checkpoint();
+    }
+    release = true;
+    holder.join();
+    EXPECT_EQ(scheduler.getStats().bulkPauses, 0u);
+}
+
+TEST(PrioritySchedulerTest, LanesBoundTheirConcurrency) {
+    PriorityScheduler scheduler({2, 1, 1ms});
+    for (Lane lane : {Lane::Interactive, Lane::Bulk}) {
+        std::atomic<int> running{0};
+        std::atomic<int> peak{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 6; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 20; ++i) {
+                    const auto slot = scheduler.acquire(lane);
+                    const int now = ++running;
+                    int seen = peak;
+                    while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                    }
+                    std::this_thread::sleep_for(100us);
+                    --running;
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        EXPECT_EQ(peak, lane == Lane::Interactive ? 2 : 1);
+    }
+    const auto stats = scheduler.getStats();
+    EXPECT_EQ(stats.interactiveRunning + stats.interactiveWaiting + stats.bulkRunning + stats.bulkWaiting, 0u);
+}
+
+TEST(PrioritySchedulerTest, SubmittedBulkJobsRunInOrderOnWorkers) {
+    std::vector<int> order;
+    std::atomic<bool> offCaller{true};
+    const auto caller = std::this_thread::get_id();
+    {
+        PriorityScheduler scheduler({2, 1, 1ms});
+        std::atomic<bool> release{false};
+        std::thread holder = holdInteractive(scheduler, release);
+
+        // Queued behind the interactive call without blocking the submitter
+        for (int i = 0; i < 5; ++i) {
+            scheduler.submitBulk([&, i] {
+                offCaller = offCaller && std::this_thread::get_id() != caller;
+                EXPECT_EQ(scheduler.getStats().bulkRunning, 1u);
+                order.push_back(i);
+            });
+        }
+        EXPECT_GE(scheduler.getStats().bulkQueued + scheduler.getStats().bulkWaiting, 4u);
+        release = true;
+        holder.join();
+    }  // waits for the queue
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_TRUE(offCaller);
+}
+
+TEST(PrioritySchedulerTest, AdmittedInteractiveCallsDoNotWait) {
+    PriorityScheduler scheduler({1, 1, 1ms});
+    const auto held = scheduler.acquire(Lane::Interactive);
+    {
+        const auto admitted = scheduler.admitInteractive();
+        EXPECT_EQ(scheduler.getStats().interactiveRunning, 2u);
+    }
+    EXPECT_EQ(scheduler.getStats().interactiveRunning, 1u);
+}
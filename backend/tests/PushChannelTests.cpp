@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+#include "../src/PushChannel.hpp"
+#include <atomic>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+TEST(PushChannelTest, WindowLimitsUnacknowledgedBatches) {
+    PushChannel channel(1, 2, 50ms);
+    EXPECT_EQ(channel.reserve(), 0u);
+    EXPECT_EQ(channel.reserve(), 1u);
+    EXPECT_EQ(channel.getUnacknowledged(), 2u);
+
+    // Window full: the next reserve waits for an acknowledgement
+    std::atomic<bool> reserved{false};
+    std::thread producer([&] {
+        EXPECT_EQ(channel.reserve(), 2u);
+        reserved = true;
+    });
+    std::this_thread::sleep_for(10ms);
+    EXPECT_FALSE(reserved);
+    channel.acknowledge(0);
+    producer.join();
+    EXPECT_TRUE(reserved);
+
+    // Acknowledgements are cumulative; stale and future ones are ignored
+    channel.acknowledge(2);
+    EXPECT_EQ(channel.getUnacknowledged(), 0u);
+    channel.acknowledge(1);
+    channel.acknowledge(7);
+    EXPECT_EQ(channel.getUnacknowledged(), 0u);
+}
+
+TEST(PushChannelTest, StalledPageEndsStream) {
+    PushChannel channel(1, 1, 20ms);
+    EXPECT_EQ(channel.reserve(), 0u);
+    EXPECT_EQ(channel.reserve(), std::nullopt);
+    EXPECT_TRUE(channel.isCancelled());
+}
+
+TEST(PushChannelTest, CancelWakesProducer) {
+    PushChannel channel(1, 1, 10s);
+    EXPECT_EQ(channel.reserve(), 0u);
+    std::thread producer([&] { EXPECT_EQ(channel.reserve(), std::nullopt); });
+    std::this_thread::sleep_for(10ms);
+    channel.cancel();
+    producer.join();
+}
+
+TEST(PushChannelTest, RegistryFindsOpenChannels) {
+    auto channel = PushChannel::open(4);
+    EXPECT_EQ(PushChannel::find(channel->getId()), channel);
+    PushChannel::close(channel->getId());
+    EXPECT_EQ(PushChannel::find(channel->getId()), nullptr);
+
+    const std::uint32_t id = PushChannel::open(4)->getId();
+    // Released by its last owner
+    EXPECT_EQ(PushChannel::find(id), nullptr);
+}
@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+#include "../src/RequestArena.hpp"
+#include "../src/JsonWriter.hpp"
+#include "../src/SimulatedUniverse.hpp"
+
+TEST(RequestArenaTest, WarmArenaServesRequestWithoutHeapAllocations) {
+    SimulatedUniverse universe("Arena", 0.3, 0.7, 70.0, 1e-9, -1.0);
+    RequestArena arena(256);
+
+    for (int round = 0; round < 3; ++round) {
+        {
+            JsonWriter writer(4, arena.resource());
+            universe.write(writer, arena.resource());
+            EXPECT_EQ(writer.str(), universe.toJSON());
+        }
+        if (round == 0) {
+            EXPECT_GT(arena.getUpstreamAllocations(), 0u);
+        } else {
+            EXPECT_EQ(arena.getUpstreamAllocations(), 0u);
+        }
+        arena.reset();
+    }
+    EXPECT_GT(arena.getCapacity(), 256u);
+}
+
+TEST(RequestArenaTest, LeasesAreReusedPerThread) {
+    RequestArena* first = nullptr;
+    {
+        auto lease = RequestArena::acquire();
+        first = &lease.get();
+        // Nested requests get their own arena
+        auto nested = RequestArena::acquire();
+        EXPECT_NE(&nested.get(), first);
+    }
+
+    auto lease = RequestArena::acquire();
+    auto other = RequestArena::acquire();
+    EXPECT_TRUE(&lease.get() == first || &other.get() == first);
+}
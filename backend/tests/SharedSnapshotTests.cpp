@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "../src/SharedSnapshotReader.hpp"
+#include "../src/SharedSnapshotWriter.hpp"
+#include "../src/UniverseDB.hpp"
+#include <atomic>
+#include <cmath>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <unistd.h>
+
+using namespace SharedSnapshotLayout;
+
+static std::string segmentName(const char* test) {
+    return "/cosmic_test_" + std::string(test) + "_" + std::to_string(getpid());
+}
+
+// Write value into every cell of count rows
+static void fillWith(const SharedSnapshotWriter::Columns& columns, size_t count, double value) {
+    for (size_t row = 0; row < count; ++row) {
+        for (double* column : columns.parameters) column[row] = value;
+        for (double* column : columns.milestones) column[row] = value;
+        columns.ids[row] = static_cast<std::int32_t>(value);
+        columns.endings[row] = static_cast<std::uint8_t>(value);
+    }
+}
+
+TEST(SharedSnapshotTest, ReaderSeesPublishedColumns) {
+    SharedSnapshotWriter writer(segmentName("columns"));
+    SharedSnapshotReader reader(writer.getName());
+    EXPECT_EQ(reader.read([](const SharedSnapshotReader::View& view) { return view.count; }), 0u);
+
+    writer.publish(3, [](const SharedSnapshotWriter::Columns& columns) {
+        for (size_t row = 0; row < 3; ++row) {
+            columns.ids[row] = static_cast<std::int32_t>(10 + row);
+            columns.parameters[2][row] = 60.0 + row;
+            columns.milestones[0][row] = 0.0;
+            columns.endings[row] = kNoEnding;
+        }
+    });
+    EXPECT_EQ(reader.getGeneration(), 1u);
+    reader.read([](const SharedSnapshotReader::View& view) {
+        ASSERT_EQ(view.count, 3u);
+        EXPECT_EQ(view.generation, 1u);
+        EXPECT_EQ(view.ids[2], 12);
+        EXPECT_EQ(view.parameters[2][1], 61.0);
+        EXPECT_EQ(view.endings[0], kNoEnding);
+    });
+
+    EXPECT_THROW(SharedSnapshotReader(segmentName("missing")), std::system_error);
+}
+
+TEST(SharedSnapshotTest, ReadersNeverSeeTornGenerations) {
+    SharedSnapshotWriter writer(segmentName("torn"));
+    constexpr int kGenerations = 400;
+    std::atomic<bool> done{false};
+
+    std::thread publisher([&] {
+        for (int generation = 1; generation <= kGenerations; ++generation) {
+            // Counts grow, so regions move while readers are attached
+            const size_t count = 100 + 50 * static_cast<size_t>(generation);
+            writer.publish(count, [&](const SharedSnapshotWriter::Columns& columns) {
+                fillWith(columns, count, generation);
+            });
+        }
+        done = true;
+    });
+
+    SharedSnapshotReader reader(writer.getName());
+    size_t reads = 0;
+    bool uniform = true;
+    while (uniform && (!done || reads == 0)) {
+        uniform = reader.read([](const SharedSnapshotReader::View& view) {
+            const double value = static_cast<double>(view.generation);
+            for (size_t row = 0; row < view.count; ++row) {
+                if (view.parameters[4][row] != value || view.milestones[11][row] != value ||
+                    view.ids[row] != static_cast<std::int32_t>(value)) {
+                    return false;
+                }
+            }
+            return view.count == (view.generation ? 100 + 50 * view.generation : 0);
+        });
+        ++reads;
+    }
+    // Join before asserting: returning with the publisher running would
+    // destroy a joinable thread
+    publisher.join();
+    ASSERT_TRUE(uniform) << "torn read after " << reads << " reads";
+    EXPECT_EQ(reader.getGeneration(), static_cast<std::uint64_t>(kGenerations));
+}
+
+TEST(SharedSnapshotTest, DatabasePublishesItsUniverses) {
+    auto& db = UniverseDB::instance();
+    const int standard = db.addUniverse(std::make_unique<SimulatedUniverse>("Standard", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    const int phantom = db.addUniverse(std::make_unique<SimulatedUniverse>("Phantom", 0.25, 0.75, 68.2, 3e-10, -1.4));
+    db.removeUniverse(standard);
+
+    const std::string name = segmentName("database");
+    db.publishSnapshots(name, std::chrono::milliseconds(5));
+    SharedSnapshotReader reader(name);
+
+    const int closed = db.addUniverse(std::make_unique<SimulatedUniverse>("Closed", 1.5, 0.2, 55.0, 1e-8, -0.6));
+    while (reader.read([&](const SharedSnapshotReader::View& view) { return view.count; }) != db.getUniverseCount()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    for (int id : {phantom, closed}) {
+        const auto stored = db.getUniverse(id);
+        const SimulatedUniverse& universe = *stored;
+        reader.read([&](const SharedSnapshotReader::View& view) {
+            size_t row = 0;
+            while (row < view.count && view.ids[row] != id) ++row;
+            ASSERT_LT(row, view.count);
+            EXPECT_EQ(view.parameters[0][row], universe.getMatterDensity());
+            EXPECT_EQ(view.parameters[4][row], universe.getDarkEnergyW());
+            const auto ending = universe.ending();
+            EXPECT_EQ(view.endings[row], ending ? static_cast<std::uint8_t>(*ending) : kNoEnding);
+
+            const LazyTimeline& timeline = universe.getComputedTimeline().timeline();
+            size_t present = 0;
+            for (size_t type = 0; type < kMilestoneColumns; ++type) {
+                present += !std::isnan(view.milestones[type][row]);
+            }
+            EXPECT_EQ(present, timeline.size());
+            for (size_t i = 0; i < timeline.size(); ++i) {
+                EXPECT_EQ(view.milestones[static_cast<size_t>(timeline.typeAt(i))][row], timeline.timestampAt(i));
+            }
+        });
+    }
+    reader.read([&](const SharedSnapshotReader::View& view) {
+        for (size_t row = 0; row < view.count; ++row) {
+            EXPECT_NE(view.ids[row], standard);
+        }
+    });
+
+    db.stopSnapshots();
+    EXPECT_FALSE(db.publishSnapshotNow());
+    EXPECT_THROW(SharedSnapshotReader{name}, std::system_error);
+}
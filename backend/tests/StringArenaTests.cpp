@@ -0,0 +1,22 @@
+#include <gtest/gtest.h>
+#include "../src/StringArena.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(StringArenaTest, StringsSurviveChunkBoundaries) {
+    StringArena arena;
+    std::vector<std::string> texts;
+    std::vector<StringArena::Ref> refs;
+    for (int i = 0; texts.size() < 3000; ++i) {
+        texts.push_back(std::string(1000 + i % 7, static_cast<char>('a' + i % 26)) + std::to_string(i));
+        refs.push_back(arena.append(texts.back()));
+    }
+    EXPECT_GT(arena.getCapacity(), StringArena::kChunkSize);
+    for (size_t i = 0; i < texts.size(); ++i) {
+        EXPECT_EQ(arena.get(refs[i]), texts[i]);
+    }
+
+    EXPECT_EQ(arena.get(arena.append("")), "");
+    EXPECT_THROW(arena.append(std::string(StringArena::kMaxLength + 1, 'x')), std::length_error);
+}
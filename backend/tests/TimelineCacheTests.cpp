@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+#include "../src/SimulatedUniverse.hpp"
+#include "../src/TimelineCache.hpp"
+
+TEST(TimelineCacheTest, IdenticalParametersShareOneRecord) {
+    const auto before = TimelineCache::instance().getStats();
+    {
+        SimulatedUniverse first("First", 0.31, 0.69, 67.7, 6.1e-10, -1.0);
+        SimulatedUniverse second("Second", 0.31, 0.69, 67.7, 6.1e-10, -1.0);
+        SimulatedUniverse other("Other", 0.32, 0.68, 67.7, 6.1e-10, -1.0);
+
+        EXPECT_EQ(&first.getComputedTimeline(), &second.getComputedTimeline());
+        EXPECT_NE(&first.getComputedTimeline(), &other.getComputedTimeline());
+
+        const auto during = TimelineCache::instance().getStats();
+        EXPECT_EQ(during.lookups - before.lookups, 3u);
+        EXPECT_EQ(during.hits - before.hits, 1u);
+        EXPECT_EQ(during.distinct - before.distinct, 2u);
+    }
+    // Records are released with the last universe that uses them
+    EXPECT_EQ(TimelineCache::instance().getStats().distinct, before.distinct);
+}
+
+TEST(TimelineCacheTest, SharedRecordMatchesGeneratedTimeline) {
+    SimulatedUniverse universe("Shared", 0.25, 0.75, 68.2, 3e-10, -1.4);
+    const auto& record = universe.getComputedTimeline();
+    auto timeline = universe.generateTimeline();
+    const auto& milestones = timeline->getMilestones();
+
+    ASSERT_EQ(record.timeline().size(), milestones.size());
+    for (size_t i = 0; i < milestones.size(); ++i) {
+        EXPECT_EQ(record.timeline().typeAt(i), milestones[i]->getType());
+        EXPECT_EQ(record.timeline().timestampAt(i), milestones[i]->calculateTimestamp());
+    }
+    EXPECT_EQ(record.getEnding(), universe.ending());
+}
+
+TEST(TimelineCacheTest, NegativeZeroIsCanonicalized) {
+    const ParameterKey positive(0.3, 0.0, 70.0, 1e-9, -1.0);
+    const ParameterKey negative(0.3, -0.0, 70.0, 1e-9, -1.0);
+    EXPECT_EQ(positive, negative);
+    EXPECT_EQ(ParameterKeyHash{}(positive), ParameterKeyHash{}(negative));
+}
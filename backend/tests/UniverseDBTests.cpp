@@ -0,0 +1,75 @@
+#include <gtest/gtest.h>
+#include "../src/UniverseDB.hpp"
+#include "../src/ParallelFor.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(UniverseDBTest, AddUniversesAssignsConsecutiveIds) {
+    auto& db = UniverseDB::instance();
+    const int before = db.addUniverse(std::make_unique<SimulatedUniverse>("Single", 0.3, 0.7, 70.0, 1e-9, -1.0));
+
+    std::vector<std::unique_ptr<SimulatedUniverse>> batch;
+    for (int i = 0; i < 5; ++i) {
+        batch.push_back(std::make_unique<SimulatedUniverse>("Batch " + std::to_string(i), 0.3, 0.7, 70.0, 1e-9, -1.0));
+    }
+    const int firstId = db.addUniverses(std::move(batch));
+
+    EXPECT_EQ(firstId, before + 1);
+    for (int i = 0; i < 5; ++i) {
+        auto universe = db.getUniverse(firstId + i);
+        ASSERT_TRUE(universe);
+        EXPECT_EQ(universe->getName(), "Batch " + std::to_string(i));
+    }
+    EXPECT_EQ(db.addUniverses({}), firstId + 5);
+}
+
+TEST(UniverseDBTest, ListsCarryDatabaseIds) {
+    auto& db = UniverseDB::instance();
+    const int first = db.addUniverse(std::make_unique<SimulatedUniverse>("Listed zeta", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    const int removed = db.addUniverse(std::make_unique<SimulatedUniverse>("Listed zeta", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    const int last = db.addUniverse(std::make_unique<SimulatedUniverse>("Listed zeta", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    db.removeUniverse(removed);
+
+    // Ids skip removed universes instead of counting positions
+    const auto found = db.searchUniverses("listed ZETA");
+    ASSERT_EQ(found.size(), 2u);
+    EXPECT_EQ(found[0].id, first);
+    EXPECT_EQ(found[1].id, last);
+    for (const auto& [id, universe] : db.getAllUniverses()) {
+        EXPECT_EQ(universe, db.getUniverse(id));
+    }
+}
+
+TEST(UniverseDBTest, ViewsShareStoredObjects) {
+    auto& db = UniverseDB::instance();
+    ASSERT_EQ(db.getStorage(), UniverseDB::Storage::Objects);
+    const int id = db.addUniverse(std::make_unique<SimulatedUniverse>("Viewed", 0.3, 0.7, 70.0, 1e-9, -1.0));
+
+    const UniverseDB::View view = db.view();
+    const auto universe = view.get(id);
+    ASSERT_TRUE(universe);
+    EXPECT_EQ(universe->getName(), "Viewed");
+    EXPECT_EQ(universe->universe(), db.getUniverse(id));
+    EXPECT_FALSE(view.get(static_cast<int>(view.size())));
+    EXPECT_THROW(db.setStorage(UniverseDB::Storage::Compact), std::logic_error);
+}
+
+TEST(ParallelForTest, CoversRangeOnceAndRethrows) {
+    std::vector<std::atomic<int>> visits(10000);
+    parallelFor(visits.size(), 64, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+    for (const auto& count : visits) {
+        EXPECT_EQ(count.load(), 1);
+    }
+
+    EXPECT_THROW(parallelFor(1000, 1, [](size_t begin, size_t) {
+        if (begin == 0) {
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+}
@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "../src/UniverseTable.hpp"
+#include <memory>
+#include <string>
+
+static UniverseTable::UniversePtr universe(const std::string& name) {
+    return std::make_shared<const SimulatedUniverse>(name, 0.3, 0.7, 70.0, 1e-9, -1.0);
+}
+
+TEST(UniverseTableTest, ViewsKeepTheirContents) {
+    UniverseTable table;
+    const size_t ids = 3 * UniverseTable::kChunkSize + 5;
+    for (size_t id = 0; id < ids; ++id) {
+        table.push_back(universe("U" + std::to_string(id)));
+    }
+    const UniverseTable::View before = table.view();
+    const auto first = table[0];
+
+    table.set(0, universe("Replaced"));
+    table.set(UniverseTable::kChunkSize, nullptr);
+    table.push_back(universe("Appended"));
+
+    EXPECT_EQ(before.size(), ids);
+    EXPECT_EQ(before.count(), ids);
+    EXPECT_EQ(before[0], first);
+    EXPECT_EQ(before[UniverseTable::kChunkSize]->getName(), "U" + std::to_string(UniverseTable::kChunkSize));
+
+    const UniverseTable::View after = table.view();
+    EXPECT_EQ(after.size(), ids + 1);
+    EXPECT_EQ(after.count(), ids);
+    EXPECT_EQ(after[0]->getName(), "Replaced");
+    EXPECT_EQ(after[UniverseTable::kChunkSize], nullptr);
+    EXPECT_EQ(after[ids]->getName(), "Appended");
+    // Untouched chunks are shared, not copied
+    EXPECT_EQ(&before[2 * UniverseTable::kChunkSize], &after[2 * UniverseTable::kChunkSize]);
+}
+
+TEST(UniverseTableTest, OnlySharedChunksAreCloned) {
+    UniverseTable table;
+    table.push_back(universe("A"));
+    const UniverseTable::UniversePtr* slot = &table[0];
+    table.set(0, universe("B"));
+    EXPECT_EQ(&table[0], slot);
+
+    {
+        const UniverseTable::View view = table.view();
+        table.set(0, universe("C"));
+        EXPECT_NE(&table[0], slot);
+        EXPECT_EQ(view[0]->getName(), "B");
+        slot = &table[0];
+    }
+    table.set(0, nullptr);
+    EXPECT_EQ(&table[0], slot);
+    EXPECT_EQ(table.count(), 0u);
+}
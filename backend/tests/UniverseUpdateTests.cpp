@@ -0,0 +1,195 @@
+#include <gtest/gtest.h>
+#include "../src/MilestoneFormulas.hpp"
+#include "../src/UniverseDB.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+
+static UniverseParameters randomParameters(std::mt19937_64& random) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    return UniverseParameters(0.1 + 1.9 * unit(random), unit(random), 50.0 + 30.0 * unit(random),
+                              std::pow(10.0, -11.0 + 3.0 * unit(random)), -2.0 + 1.5 * unit(random));
+}
+
+static UniverseParameters perturb(const UniverseParameters& params, size_t parameter, double factor) {
+    double values[] = {params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+                       params.getMatterAntimatterRatio(), params.getDarkEnergyW()};
+    values[parameter] *= factor;
+    return UniverseParameters(values[0], values[1], values[2], values[3], values[4]);
+}
+
+static UniverseDB::UniverseUpdate edit(std::optional<std::string> name, const UniverseParameters& params) {
+    UniverseDB::UniverseUpdate update;
+    update.name = std::move(name);
+    update.matterDensity = params.getMatterDensity();
+    update.darkEnergyDensity = params.getDarkEnergyDensity();
+    update.hubbleConstant = params.getHubbleConstant();
+    update.matterAntimatterRatio = params.getMatterAntimatterRatio();
+    update.darkEnergyW = params.getDarkEnergyW();
+    return update;
+}
+
+TEST(UniverseUpdateTest, TimestampsIgnoreParametersOutsideTheirDependencies) {
+    std::mt19937_64 random(3);
+    for (int trial = 0; trial < 200; ++trial) {
+        const UniverseParameters params = randomParameters(random);
+        for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+            const auto type = static_cast<MilestoneType>(t);
+            const double expected = MilestoneFormulas::timestamp(
+                type, MilestoneFormulas::fromUniverseParameters(params));
+            for (size_t p = 0; p < MilestoneFormulas::kParameterCount; ++p) {
+                if (MilestoneFormulas::dependencies(type) & (1u << p)) {
+                    continue;
+                }
+                const double actual = MilestoneFormulas::timestamp(
+                    type, MilestoneFormulas::fromUniverseParameters(perturb(params, p, 1.37)));
+                EXPECT_EQ(actual, expected) << "type " << t << " reads "
+                                            << MilestoneFormulas::kParameterNames[p];
+            }
+        }
+    }
+}
+
+TEST(UniverseUpdateTest, EditReusesIndependentTimestamps) {
+    SimulatedUniverse universe("Edited", 0.31, 0.69, 67.4, 6e-10, -1.0);
+    universe.getComputedTimeline().timeline();  // evaluate before the edit
+
+    const auto changed = universe.setParameters(UniverseParameters(0.31, 0.69, 71.3, 6e-10, -1.0));
+    EXPECT_EQ(changed, MilestoneFormulas::kHubbleConstantBit);
+
+    // Carried-over and recomputed values match a timeline built from scratch
+    const LazyTimeline& lazy = universe.getComputedTimeline().timeline();
+    const UniverseParameters params(0.31, 0.69, 71.3, 6e-10, -1.0);
+    LazyTimeline expected(params, SimulatedUniverse::milestoneTypes(params));
+    ASSERT_EQ(lazy.size(), expected.size());
+    for (size_t i = 0; i < lazy.size(); ++i) {
+        EXPECT_EQ(lazy.typeAt(i), expected.typeAt(i));
+        EXPECT_EQ(lazy.timestampAt(i), expected.timestampAt(i));
+    }
+
+    EXPECT_EQ(universe.setParameters(UniverseParameters(0.31, 0.69, 71.3, 6e-10, -1.0)), 0u);
+}
+
+TEST(UniverseUpdateTest, SeededTimelineOnlyCachesIndependentMilestones) {
+    const UniverseParameters before(0.28, 0.72, 68.0, 2e-10, -0.95);
+    const UniverseParameters after(0.28, 0.72, 74.0, 2e-10, -0.95);
+    const auto types = SimulatedUniverse::milestoneTypes(before);
+    LazyTimeline previous(before, types);
+    for (size_t i = 0; i < previous.size(); ++i) {
+        previous.timestampAt(i);
+    }
+
+    LazyTimeline seeded(after, SimulatedUniverse::milestoneTypes(after), previous,
+                        MilestoneFormulas::kHubbleConstantBit);
+    for (size_t i = 0; i < seeded.size(); ++i) {
+        const bool independent =
+            !(MilestoneFormulas::dependencies(seeded.typeAt(i)) & MilestoneFormulas::kHubbleConstantBit);
+        EXPECT_EQ(seeded.isEvaluated(i), independent) << "index " << i;
+    }
+}
+
+TEST(UniverseUpdateTest, DatabaseIndexesFollowEdits) {
+    std::mt19937_64 random(17);
+    auto& db = UniverseDB::instance();
+    std::vector<std::unique_ptr<SimulatedUniverse>> batch;
+    for (int i = 0; i < 200; ++i) {
+        const UniverseParameters params = randomParameters(random);
+        batch.push_back(std::make_unique<SimulatedUniverse>(
+            "U" + std::to_string(i), params.getMatterDensity(), params.getDarkEnergyDensity(),
+            params.getHubbleConstant(), params.getMatterAntimatterRatio(), params.getDarkEnergyW()));
+    }
+    const int first = db.addUniverses(std::move(batch));
+
+    std::uniform_int_distribution<size_t> parameter(0, MilestoneFormulas::kParameterCount - 1);
+    for (int id = first; id < first + 200; id += 2) {
+        const auto universe = db.getUniverse(id);
+        ASSERT_TRUE(db.updateUniverse(id, edit("Edited " + std::to_string(id),
+                                               perturb(universe->parameters(), parameter(random), 1.1))));
+    }
+    EXPECT_FALSE(db.updateUniverse(-1, edit(std::nullopt, UniverseParameters())));
+    EXPECT_EQ(db.getUniverse(first)->getName(), "Edited " + std::to_string(first));
+
+    // Every stored milestone is found at its current timestamp, and nowhere else
+    const auto all = db.getAllUniverses();
+    size_t milestones = 0;
+    for (int id = first; id < first + 200; ++id) {
+        const LazyTimeline& timeline = db.getUniverse(id)->getComputedTimeline().timeline();
+        for (size_t i = 0; i < timeline.size(); ++i) {
+            const double t = timeline.timestampAt(i);
+            const auto events = db.findEvents({timeline.typeAt(i)}, t, t, all.size() * kMilestoneTypeCount);
+            EXPECT_TRUE(std::any_of(events.begin(), events.end(), [&](const auto& event) { return event.id == id; }));
+            ++milestones;
+        }
+    }
+    size_t indexed = 0;
+    for (size_t t = 0; t < kMilestoneTypeCount; ++t) {
+        for (const auto& event : db.findEvents({static_cast<MilestoneType>(t)}, -1e300, 1e300, SIZE_MAX)) {
+            indexed += event.id >= first && event.id < first + 200;
+        }
+    }
+    EXPECT_EQ(indexed, milestones);
+
+    // The nearest neighbour of an edited universe is itself
+    const auto point = ParameterIndex::normalize(*db.getUniverse(first));
+    const auto nearest = db.findNearest(point, 1);
+    ASSERT_EQ(nearest.size(), 1u);
+    EXPECT_EQ(nearest[0].id, first);
+    EXPECT_EQ(nearest[0].distance, 0.0);
+
+    // Statistics agree with a recount
+    EnsembleStatistics recount;
+    for (const auto& [id, universe] : all) {
+        recount.add(id, EnsembleStatistics::Sample::of(*universe));
+    }
+    const auto expected = recount.snapshot();
+    const auto actual = db.getStatistics();
+    EXPECT_EQ(actual.total, expected.total);
+    for (size_t q = 0; q < EnsembleStatistics::kQuantities; ++q) {
+        EXPECT_EQ(actual.quantities[q].count, expected.quantities[q].count);
+        EXPECT_EQ(actual.quantities[q].min, expected.quantities[q].min);
+        EXPECT_EQ(actual.quantities[q].max, expected.quantities[q].max);
+        EXPECT_NEAR(actual.quantities[q].sum, expected.quantities[q].sum,
+                    1e-9 * std::max(1.0, std::abs(expected.quantities[q].sum)));
+    }
+}
+
+TEST(UniverseUpdateTest, UpdatesMergeOmittedFieldsAndKeepEarlierCopies) {
+    auto& db = UniverseDB::instance();
+    const int id = db.addUniverse(std::make_unique<SimulatedUniverse>("Original", 0.3, 0.7, 70.0, 1e-9, -1.0));
+    const auto before = db.getUniverse(id);
+
+    UniverseDB::UniverseUpdate hubble;
+    hubble.hubbleConstant = 72.0;
+    ASSERT_TRUE(db.updateUniverse(id, hubble));
+    UniverseDB::UniverseUpdate renamed;
+    renamed.name = "Renamed";
+    renamed.darkEnergyW = -1.2;
+    const auto result = db.updateUniverse(id, renamed);
+    ASSERT_TRUE(result);
+    EXPECT_EQ(result->changed, MilestoneFormulas::kDarkEnergyWBit);
+
+    // Both partial updates are in the stored universe
+    const auto after = db.getUniverse(id);
+    EXPECT_EQ(after, result->universe);
+    EXPECT_EQ(after->getName(), "Renamed");
+    EXPECT_EQ(after->getHubbleConstant(), 72.0);
+    EXPECT_EQ(after->getDarkEnergyW(), -1.2);
+    EXPECT_EQ(after->getMatterDensity(), 0.3);
+
+    // A reader's earlier copy is untouched
+    EXPECT_EQ(before->getName(), "Original");
+    EXPECT_EQ(before->getHubbleConstant(), 70.0);
+    EXPECT_EQ(before->getComputedTimeline().getEnding(), MilestoneType::HeatDeath);
+
+    // A rejecting check leaves the universe as it was
+    UniverseDB::UniverseUpdate rejected;
+    rejected.matterDensity = 5.0;
+    EXPECT_THROW(db.updateUniverse(id, rejected, [](const UniverseParameters& params) {
+        if (params.getMatterDensity() > 2.0) throw std::invalid_argument("matter density");
+    }), std::invalid_argument);
+    EXPECT_EQ(db.getUniverse(id), after);
+}
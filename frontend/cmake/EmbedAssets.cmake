@@ -0,0 +1,163 @@
+# Packs every file under SOURCE_DIR into OUTPUT, a C++ source defining the
+# embedded_assets table from EmbeddedAssets.hpp. Each entry holds complete
+# HTTP responses (headers and body) that the file handler returns as is:
+#  - a gzip-compressed body next to the raw one when that saves at least
+#    10%, for clients that accept gzip
+#  - every response carries a strong ETag (SHA-256 of the body, with a
+#    "-gzip" suffix for the compressed one)
+#  - HTML pages reference the other files as "name?v=<etag>". Only those
+#    versioned URLs are cached as immutable; pages and unversioned URLs are
+#    revalidated.
+#
+#   cmake -DSOURCE_DIR=ui -DOUTPUT=EmbeddedAssetData.cpp -P EmbedAssets.cmake
+cmake_minimum_required(VERSION 3.18)
+
+set(work_dir "${OUTPUT}.work")
+file(REMOVE_RECURSE "${work_dir}")
+file(MAKE_DIRECTORY "${work_dir}")
+
+file(GLOB_RECURSE files RELATIVE "${SOURCE_DIR}" "${SOURCE_DIR}/*")
+list(SORT files)
+
+function(content_type path out)
+    get_filename_component(ext "${path}" LAST_EXT)
+    string(TOLOWER "${ext}" ext)
+    if(ext STREQUAL ".html")
+        set(type "text/html; charset=utf-8")
+    elseif(ext STREQUAL ".js")
+        set(type "text/javascript; charset=utf-8")
+    elseif(ext STREQUAL ".css")
+        set(type "text/css; charset=utf-8")
+    elseif(ext STREQUAL ".json")
+        set(type "application/json")
+    elseif(ext STREQUAL ".svg")
+        set(type "image/svg+xml")
+    elseif(ext STREQUAL ".png")
+        set(type "image/png")
+    elseif(ext STREQUAL ".jpg" OR ext STREQUAL ".jpeg")
+        set(type "image/jpeg")
+    elseif(ext STREQUAL ".ico")
+        set(type "image/x-icon")
+    else()
+        set(type "application/octet-stream")
+    endif()
+    set(${out} "${type}" PARENT_SCOPE)
+endfunction()
+
+# Raw body as hex, and the gzip body as hex when it saves at least 10%
+function(encode_body path source out_raw out_gzip)
+    file(READ "${source}" raw HEX)
+    string(MAKE_C_IDENTIFIER "${path}" name)
+    set(gz "${work_dir}/${name}.gz")
+    file(ARCHIVE_CREATE OUTPUT "${gz}" PATHS "${source}" FORMAT raw COMPRESSION GZip MTIME 0)
+    file(READ "${gz}" compressed HEX)
+    string(LENGTH "${raw}" raw_length)
+    string(LENGTH "${compressed}" compressed_length)
+    math(EXPR limit "${raw_length} * 9 / 10")
+    set(${out_raw} "${raw}" PARENT_SCOPE)
+    if(compressed_length LESS limit)
+        set(${out_gzip} "${compressed}" PARENT_SCOPE)
+    else()
+        set(${out_gzip} "" PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Non-HTML files first, so pages can reference them by ETag
+set(pages "")
+set(others "")
+foreach(path IN LISTS files)
+    if(path MATCHES "\\.html$")
+        list(APPEND pages "${path}")
+    else()
+        list(APPEND others "${path}")
+    endif()
+endforeach()
+
+set(rewrites "")
+foreach(path IN LISTS others)
+    file(SHA256 "${SOURCE_DIR}/${path}" digest)
+    string(SUBSTRING "${digest}" 0 16 etag_${path})
+endforeach()
+
+string(REPEAT "0x[0-9a-f][0-9a-f]," 24 row_pattern)
+set(definitions "")
+set(entries "")
+set(index 0)
+set(response_count 0)
+
+# Append a response array to definitions; sets out to its initializer
+function(define_response header_text body_hex out)
+    string(HEX "${header_text}" header_hex)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," bytes "${header_hex}${body_hex}")
+    string(REGEX REPLACE "(${row_pattern})" "\\1\n    " bytes "${bytes}")
+    set(name "kResponse${response_count}")
+    set(definitions "${definitions}const unsigned char ${name}[] = {\n    ${bytes}\n};\n" PARENT_SCOPE)
+    math(EXPR next "${response_count} + 1")
+    set(response_count ${next} PARENT_SCOPE)
+    set(${out} "{${name}, sizeof(${name})}" PARENT_SCOPE)
+endfunction()
+
+foreach(path IN LISTS files)
+    content_type("${path}" type)
+    if(path IN_LIST pages)
+        # Point references to embedded files at their versioned URL
+        file(READ "${SOURCE_DIR}/${path}" page)
+        foreach(other IN LISTS others)
+            string(REPLACE "\"${other}\"" "\"${other}?v=${etag_${other}}\"" page "${page}")
+        endforeach()
+        set(source "${work_dir}/page_${index}.html")
+        file(WRITE "${source}" "${page}")
+    else()
+        set(source "${SOURCE_DIR}/${path}")
+    endif()
+
+    encode_body("${path}" "${source}" raw gzip)
+    file(SHA256 "${source}" digest)
+    string(SUBSTRING "${digest}" 0 16 etag)
+    if(gzip)
+        set(vary "Vary: Accept-Encoding\r\n")
+    else()
+        set(vary "")
+    endif()
+
+    # [versioned][gzip]; without a gzip body the gzip slots repeat the raw ones
+    string(APPEND definitions "// ${path}\n")
+    set(responses "")
+    foreach(versioned IN ITEMS 0 1)
+        # A page has no versioned URL and keeps its unversioned slots
+        if(NOT (versioned AND path IN_LIST pages))
+            if(versioned)
+                set(cache_control "public, max-age=31536000, immutable")
+            else()
+                set(cache_control "no-cache")
+            endif()
+            string(LENGTH "${raw}" length)
+            math(EXPR length "${length} / 2")
+            define_response("HTTP/1.1 200 OK\r\nContent-Type: ${type}\r\nContent-Length: ${length}\r\n${vary}ETag: \"${etag}\"\r\nCache-Control: ${cache_control}\r\n\r\n" "${raw}" identity)
+            set(compressed "${identity}")
+            if(gzip)
+                string(LENGTH "${gzip}" length)
+                math(EXPR length "${length} / 2")
+                define_response("HTTP/1.1 200 OK\r\nContent-Type: ${type}\r\nContent-Length: ${length}\r\nContent-Encoding: gzip\r\n${vary}ETag: \"${etag}-gzip\"\r\nCache-Control: ${cache_control}\r\n\r\n" "${gzip}" compressed)
+            endif()
+            set(slots "{${identity}, ${compressed}}")
+        endif()
+        list(APPEND responses "${slots}")
+    endforeach()
+    string(APPEND definitions "\n")
+    list(JOIN responses ", " responses)
+    string(APPEND entries "    {\"${path}\", \"${etag}\", {${responses}}},\n")
+    math(EXPR index "${index} + 1")
+endforeach()
+
+file(REMOVE_RECURSE "${work_dir}")
+file(WRITE "${OUTPUT}.tmp"
+    "// Generated by EmbedAssets.cmake from ${SOURCE_DIR}. Do not edit.\n"
+    "#include \"EmbeddedAssets.hpp\"\n\n"
+    "namespace {\n${definitions}}\n\n"
+    "// Sorted by path\n"
+    "const EmbeddedAsset embedded_assets[] = {\n${entries}};\n"
+    "const size_t embedded_asset_count = ${index};\n")
+# Keep the timestamp when nothing changed, so dependents do not rebuild
+file(COPY_FILE "${OUTPUT}.tmp" "${OUTPUT}" ONLY_IF_DIFFERENT)
+file(REMOVE "${OUTPUT}.tmp")
@@ -0,0 +1,88 @@
+// Writes OUTPUT, a C++ source defining the getPresets responses declared
+// in src/PresetData.hpp. Run by the build; the timelines themselves were
+// already evaluated by the compiler (PresetCatalog.hpp), this only adds
+// the milestone descriptions and serializes.
+//
+//   cosmic_embed_presets PresetData.cpp
+
+#include "LazyTimeline.hpp"
+#include "PresetCatalog.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+static json preset_json(const PresetCatalog::Preset& preset) {
+    const UniverseParameters& params = preset.parameters;
+    MilestoneSequence types;
+    for (size_t i = 0; i < preset.milestoneCount; ++i) {
+        types.push_back(preset.milestones[i].type);
+    }
+    const LazyTimeline text(params, types);  // descriptions and asset ids only
+
+    json milestones = json::array();
+    for (size_t i = 0; i < preset.milestoneCount; ++i) {
+        milestones.push_back({
+            {"assetId", text.assetIdAt(i)},
+            {"description", text.descriptionAt(i)},
+            {"timestamp", preset.milestones[i].timestamp},
+            {"type", kMilestoneTypeNames[static_cast<size_t>(preset.milestones[i].type)]},
+        });
+    }
+    return {
+        {"darkEnergyDensity", params.getDarkEnergyDensity()},
+        {"darkEnergyW", params.getDarkEnergyW()},
+        {"description", preset.description},
+        {"ending", preset.ending ? json(kMilestoneTypeNames[static_cast<size_t>(*preset.ending)]) : json()},
+        {"hubbleConstant", params.getHubbleConstant()},
+        {"matterAntimatterRatio", params.getMatterAntimatterRatio()},
+        {"matterDensity", params.getMatterDensity()},
+        {"milestones", std::move(milestones)},
+        {"name", preset.name},
+    };
+}
+
+// Every byte escaped, so no escape can run into the next character
+template <typename Bytes>
+static void write_literal(std::ostream& out, const char* name, const Bytes& bytes) {
+    out << "const std::string_view " << name << "(\n    \"";
+    size_t column = 0;
+    for (unsigned char byte : bytes) {
+        char escaped[5];
+        std::snprintf(escaped, sizeof escaped, "\\x%02x", byte);
+        out << escaped;
+        if (++column % 32 == 0) {
+            out << "\"\n    \"";
+        }
+    }
+    out << "\",\n    " << bytes.size() << ");\n\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::cerr << "Usage: cosmic_embed_presets OUTPUT" << std::endl;
+        return 2;
+    }
+
+    json presets = json::array();
+    for (const auto& preset : PresetCatalog::kPresets) {
+        presets.push_back(preset_json(preset));
+    }
+    const json response = {{"presets", std::move(presets)}, {"status", "success"}};
+
+    std::ofstream out(argv[1]);
+    out << "// Generated by frontend/cmake/EmbedPresets.cpp; do not edit\n"
+        << "#include \"PresetData.hpp\"\n\n";
+    write_literal(out, "preset_response_json", response.dump());
+    write_literal(out, "preset_response_cbor", json::to_cbor(response));
+    write_literal(out, "preset_response_msgpack", json::to_msgpack(response));
+    if (!out.flush()) {
+        std::cerr << "Cannot write " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
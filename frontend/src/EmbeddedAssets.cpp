@@ -0,0 +1,89 @@
+#include "EmbeddedAssets.hpp"
+#include <algorithm>
+#include <cctype>
+#include <optional>
+
+const EmbeddedAsset* find_embedded_asset(std::string_view path) {
+    // Cache-busting query strings and the leading slash are not part of the name
+    path = path.substr(0, path.find_first_of("?#"));
+    while (!path.empty() && (path.front() == '/' || path.front() == '\\')) {
+        path.remove_prefix(1);
+    }
+
+    const EmbeddedAsset* end = embedded_assets + embedded_asset_count;
+    const EmbeddedAsset* asset = std::lower_bound(embedded_assets, end, path,
+        [](const EmbeddedAsset& entry, std::string_view name) { return entry.path < name; });
+    if (asset == end || asset->path != path) {
+        return nullptr;
+    }
+    return asset;
+}
+
+static std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+static bool equals_ignore_case(std::string_view a, std::string_view b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+        return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y));
+    });
+}
+
+bool accepts_gzip(std::string_view acceptEncoding) {
+    // "gzip;q=0" refuses it; otherwise gzip or a wildcard admits it
+    std::optional<bool> gzip, wildcard;
+    while (!acceptEncoding.empty()) {
+        const size_t comma = acceptEncoding.find(',');
+        std::string_view coding = acceptEncoding.substr(0, comma);
+        acceptEncoding = comma == std::string_view::npos ? std::string_view() : acceptEncoding.substr(comma + 1);
+
+        bool admitted = true;
+        const size_t semicolon = coding.find(';');
+        if (semicolon != std::string_view::npos) {
+            const std::string_view parameter = trim(coding.substr(semicolon + 1));
+            if (parameter.size() > 2 && (parameter[0] == 'q' || parameter[0] == 'Q') && parameter[1] == '=') {
+                admitted = parameter.find_first_not_of("0.", 2) != std::string_view::npos;
+            }
+            coding = coding.substr(0, semicolon);
+        }
+        coding = trim(coding);
+        if (equals_ignore_case(coding, "gzip") || equals_ignore_case(coding, "x-gzip")) {
+            gzip = admitted;
+        } else if (coding == "*") {
+            wildcard = admitted;
+        }
+    }
+    return gzip.value_or(wildcard.value_or(false));
+}
+
+const EmbeddedResponse& select_embedded_response(const EmbeddedAsset& asset, std::string_view target,
+                                                 bool gzip) {
+    // A stale version must not be cached as this content
+    bool versioned = false;
+    const size_t query = target.find('?');
+    if (query != std::string_view::npos) {
+        std::string_view parameters = target.substr(query + 1);
+        parameters = parameters.substr(0, parameters.find('#'));
+        while (!parameters.empty() && !versioned) {
+            const size_t amp = parameters.find('&');
+            const std::string_view parameter = parameters.substr(0, amp);
+            versioned = parameter.substr(0, 2) == "v=" && parameter.substr(2) == asset.etag;
+            parameters = amp == std::string_view::npos ? std::string_view() : parameters.substr(amp + 1);
+        }
+    }
+    return asset.responses[versioned][gzip];
+}
+
+const void* serve_embedded_asset(const char* filename, int* length) {
+    const EmbeddedAsset* asset = find_embedded_asset(filename);
+    if (!asset) {
+        return nullptr;  // webui answers 404
+    }
+    // webui passes the handler no request headers. Its window is a browser
+    // or webview, and all of those accept gzip.
+    const EmbeddedResponse& response = select_embedded_response(*asset, filename, true);
+    *length = static_cast<int>(response.size);
+    return response.data;
+}
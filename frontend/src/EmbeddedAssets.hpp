@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+// One complete HTTP response (headers and body)
+struct EmbeddedResponse {
+    const unsigned char* data;
+    size_t size;
+};
+
+// A UI file compiled into the executable by cmake/EmbedAssets.cmake
+struct EmbeddedAsset {
+    const char* path;  // relative to frontend/ui, e.g. "assets/mock_asset0.png"
+    const char* etag;  // the version pages request it under, "path?v=<etag>"
+    // Indexed [versioned][gzip]: versioned URLs are immutable, the others
+    // revalidated. Files that do not compress repeat the raw responses.
+    EmbeddedResponse responses[2][2];
+};
+
+// Generated table, sorted by path
+extern const EmbeddedAsset embedded_assets[];
+extern const size_t embedded_asset_count;
+
+// Look up a request path such as "/app.js?v=1f2e"; nullptr if not embedded
+const EmbeddedAsset* find_embedded_asset(std::string_view path);
+
+// Whether an Accept-Encoding header value admits gzip
+bool accepts_gzip(std::string_view acceptEncoding);
+
+// Response for a request target: immutable only when the target carries the
+// asset's current version, gzip only when the client accepts it
+const EmbeddedResponse& select_embedded_response(const EmbeddedAsset& asset, std::string_view target,
+                                                 bool gzip);
+
+// webui file handler serving the embedded assets. The responses are static,
+// so webui's free of the returned pointer is a no-op.
+const void* serve_embedded_asset(const char* filename, int* length);
@@ -0,0 +1,1799 @@
+#include "Handlers.hpp"
+#include <string>
+#include <nlohmann/json.hpp>
+#include <vector>
+#include <limits>
+#include <atomic>
+#include <future>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <iostream>
+#include "SimulatedUniverse.hpp"
+#include "Timeline.hpp"
+#include "UniverseParameters.hpp"
+#include "UniverseDB.hpp"
+#include "NameMatch.hpp"
+#include "UniverseValidator.hpp"
+#include "Transport.hpp"
+#include "RequestArena.hpp"
+#include "Projection.hpp"
+#include "ParallelFor.hpp"
+#include "ExpansionHistory.hpp"
+#include "InverseSolver.hpp"
+#include "PushChannel.hpp"
+#include "LatestWinsQueue.hpp"
+#include "PriorityScheduler.hpp"
+#include "PresetData.hpp"
+
+using json = nlohmann::json;
+
+// Convert milestone type to string
+std::string_view getMilestoneTypeString(int type) {
+    if (type < 0 || type >= static_cast<int>(kMilestoneTypeCount)) {
+        return "UNKNOWN";
+    }
+    return kMilestoneTypeNames[type];
+}
+
+// Milestone type from its index or its getMilestoneTypeString() name
+MilestoneType parse_milestone_type(const json& value) {
+    for (size_t type = 0; type < kMilestoneTypeCount; ++type) {
+        if (value.is_number_integer() ? value.get<size_t>() == type
+                                      : value.get<std::string>() == getMilestoneTypeString(static_cast<int>(type))) {
+            return static_cast<MilestoneType>(type);
+        }
+    }
+    throw std::runtime_error("Unknown milestone type: " + value.dump());
+}
+
+// Column order of expansion samples
+static constexpr const char* kExpansionColumns[] = {
+    "time", "scaleFactor", "hubble", "temperature",
+    "matterFraction", "radiationFraction", "darkEnergyFraction",
+};
+
+// Universes a bulk handler processes between two scheduler checkpoints
+static constexpr size_t kBulkSlice = 1024;
+
+// Static response keys, pre-quoted so the writer copies them verbatim
+static constexpr JsonKey kAssetIdKey{"\"assetId\""};
+static constexpr JsonKey kBinsPerDecadeKey{"\"binsPerDecade\""};
+static constexpr JsonKey kBulkAgedKey{"\"bulkAged\""};
+static constexpr JsonKey kBulkPausesKey{"\"bulkPauses\""};
+static constexpr JsonKey kBulkQueuedKey{"\"bulkQueued\""};
+static constexpr JsonKey kBulkRunningKey{"\"bulkRunning\""};
+static constexpr JsonKey kBulkWaitingKey{"\"bulkWaiting\""};
+static constexpr JsonKey kCandidatesKey{"\"candidates\""};
+static constexpr JsonKey kChangedKey{"\"changed\""};
+static constexpr JsonKey kColumnsKey{"\"columns\""};
+static constexpr JsonKey kConvergedKey{"\"converged\""};
+static constexpr JsonKey kCostKey{"\"cost\""};
+static constexpr JsonKey kCountKey{"\"count\""};
+static constexpr JsonKey kCountsKey{"\"counts\""};
+static constexpr JsonKey kCreatedKey{"\"created\""};
+static constexpr JsonKey kDarkEnergyDensityKey{"\"darkEnergyDensity\""};
+static constexpr JsonKey kDarkEnergyWKey{"\"darkEnergyW\""};
+static constexpr JsonKey kDataKey{"\"data\""};
+static constexpr JsonKey kDescriptionKey{"\"description\""};
+static constexpr JsonKey kDistanceKey{"\"distance\""};
+static constexpr JsonKey kDistinctKey{"\"distinct\""};
+static constexpr JsonKey kDoneKey{"\"done\""};
+static constexpr JsonKey kEndingKey{"\"ending\""};
+static constexpr JsonKey kEndingsKey{"\"endings\""};
+static constexpr JsonKey kErrorKey{"\"error\""};
+static constexpr JsonKey kErrorsKey{"\"errors\""};
+static constexpr JsonKey kEvaluationsKey{"\"evaluations\""};
+static constexpr JsonKey kEventsKey{"\"events\""};
+static constexpr JsonKey kFailedKey{"\"failed\""};
+static constexpr JsonKey kGradientKey{"\"gradient\""};
+static constexpr JsonKey kHitRateKey{"\"hitRate\""};
+static constexpr JsonKey kHitsKey{"\"hits\""};
+static constexpr JsonKey kHubbleConstantKey{"\"hubbleConstant\""};
+static constexpr JsonKey kIdKey{"\"id\""};
+static constexpr JsonKey kInteractiveRunningKey{"\"interactiveRunning\""};
+static constexpr JsonKey kInteractiveWaitingKey{"\"interactiveWaiting\""};
+static constexpr JsonKey kLinearKey{"\"linear\""};
+static constexpr JsonKey kLogKey{"\"log\""};
+static constexpr JsonKey kLookupsKey{"\"lookups\""};
+static constexpr JsonKey kMatchesKey{"\"matches\""};
+static constexpr JsonKey kMatterAntimatterRatioKey{"\"matterAntimatterRatio\""};
+static constexpr JsonKey kMatterDensityKey{"\"matterDensity\""};
+static constexpr JsonKey kMaxKey{"\"max\""};
+static constexpr JsonKey kMeanKey{"\"mean\""};
+static constexpr JsonKey kMessageKey{"\"message\""};
+static constexpr JsonKey kMilestonesKey{"\"milestones\""};
+static constexpr JsonKey kMinKey{"\"min\""};
+static constexpr JsonKey kNameKey{"\"name\""};
+static constexpr JsonKey kNeighborsKey{"\"neighbors\""};
+static constexpr JsonKey kOverflowKey{"\"overflow\""};
+static constexpr JsonKey kParametersKey{"\"parameters\""};
+static constexpr JsonKey kQuantitiesKey{"\"quantities\""};
+static constexpr JsonKey kRecomputedKey{"\"recomputed\""};
+static constexpr JsonKey kResultsKey{"\"results\""};
+static constexpr JsonKey kRowsKey{"\"rows\""};
+static constexpr JsonKey kSamplesKey{"\"samples\""};
+static constexpr JsonKey kSchedulerKey{"\"scheduler\""};
+static constexpr JsonKey kSequenceKey{"\"sequence\""};
+static constexpr JsonKey kStartExponentKey{"\"startExponent\""};
+static constexpr JsonKey kStartsRunKey{"\"startsRun\""};
+static constexpr JsonKey kStatusKey{"\"status\""};
+static constexpr JsonKey kStreamIdKey{"\"streamId\""};
+static constexpr JsonKey kTextKey{"\"text\""};
+static constexpr JsonKey kTimedOutKey{"\"timedOut\""};
+static constexpr JsonKey kTimelineCacheKey{"\"timelineCache\""};
+static constexpr JsonKey kTimestampKey{"\"timestamp\""};
+static constexpr JsonKey kTotalKey{"\"total\""};
+static constexpr JsonKey kTruncatedKey{"\"truncated\""};
+static constexpr JsonKey kTypeKey{"\"type\""};
+static constexpr JsonKey kUnderflowKey{"\"underflow\""};
+static constexpr JsonKey kUniverseKey{"\"universe\""};
+static constexpr JsonKey kUniversesKey{"\"universes\""};
+
+// Stream the projected fields of a SimulatedUniverse, or of a UniverseView
+// of a stored one, as a response object. Keys are written in sorted order so
+// the bytes match the former DOM output. Milestones come from the timeline
+// record shared by all universes with the same parameters; it is evaluated
+// once, when milestones are first requested.
+template <typename Stored>
+void write_universe(ResponseWriter& writer, const Stored& universe, int id, const Projection& projection) {
+    writer.beginObject();
+    if (projection.has(UniverseField::DarkEnergyDensity)) {
+        writer.key(kDarkEnergyDensityKey);
+        writer.value(universe.getDarkEnergyDensity());
+    }
+    if (projection.has(UniverseField::DarkEnergyW)) {
+        writer.key(kDarkEnergyWKey);
+        writer.value(universe.getDarkEnergyW());
+    }
+    if (projection.has(UniverseField::Ending)) {
+        // Known without evaluating the timeline
+        writer.key(kEndingKey);
+        if (auto ending = universe.ending()) {
+            writer.value(getMilestoneTypeString(static_cast<int>(*ending)));
+        } else {
+            writer.null();
+        }
+    }
+    if (projection.has(UniverseField::HubbleConstant)) {
+        writer.key(kHubbleConstantKey);
+        writer.value(universe.getHubbleConstant());
+    }
+    if (projection.has(UniverseField::Id)) {
+        writer.key(kIdKey);
+        writer.value(id);
+    }
+    if (projection.has(UniverseField::MatterAntimatterRatio)) {
+        writer.key(kMatterAntimatterRatioKey);
+        writer.value(universe.getMatterAntimatterRatio());
+    }
+    if (projection.has(UniverseField::MatterDensity)) {
+        writer.key(kMatterDensityKey);
+        writer.value(universe.getMatterDensity());
+    }
+    
+    if (projection.hasMilestones()) {
+        // Generate timeline and log details
+        std::cout << "Generating timeline for universe " << id << " (" << universe.getName() << ")" << std::endl;
+        const LazyTimeline& timeline = universe.getComputedTimeline().timeline();
+        std::cout << "Timeline generated with " << timeline.size()
+                  << " milestones" << std::endl;
+        
+        // Milestone types are sent as strings
+        writer.key(kMilestonesKey);
+        writer.beginArray();
+        for (size_t i = 0; i < timeline.size(); ++i) {
+            writer.beginObject();
+            if (projection.has(UniverseField::MilestoneAssetId)) {
+                writer.key(kAssetIdKey);
+                writer.value(timeline.assetIdAt(i));
+            }
+            if (projection.has(UniverseField::MilestoneDescription)) {
+                writer.key(kDescriptionKey);
+                writer.value(timeline.descriptionAt(i));
+            }
+            if (projection.has(UniverseField::MilestoneTimestamp)) {
+                writer.key(kTimestampKey);
+                writer.value(timeline.timestampAt(i));
+            }
+            if (projection.has(UniverseField::MilestoneType)) {
+                writer.key(kTypeKey);
+                writer.value(getMilestoneTypeString(static_cast<int>(timeline.typeAt(i))));
+            }
+            writer.endObject();
+        }
+        writer.endArray();
+    }
+
+    if (projection.has(UniverseField::Name)) {
+        writer.key(kNameKey);
+        writer.value(universe.getName());
+    }
+    writer.endObject();
+}
+
+// Callback to create a new universe
+void create_universe(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+        
+        // Extract parameters from JSON
+        std::string name = data["name"].get<std::string>();
+        double matterDensity = data["matterDensity"].get<double>();
+        double darkEnergyDensity = data["darkEnergyDensity"].get<double>();
+        double hubbleConstant = data["hubbleConstant"].get<double>();
+        double matterAntimatterRatio = data["matterAntimatterRatio"].get<double>();
+        double darkEnergyW = data["darkEnergyW"].get<double>();
+        
+        // Create new universe with parameters
+        auto universe = std::make_shared<const SimulatedUniverse>(
+            name, matterDensity, darkEnergyDensity, hubbleConstant,
+            matterAntimatterRatio, darkEnergyW
+        );
+        
+        // Store universe and get its ID
+        int id = UniverseDB::instance().addUniverse(universe);
+        
+        // Create the response JSON
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kMessageKey);
+        response.value("Universe created successfully");
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kUniverseKey);
+        write_universe(response, *universe, id, Projection::all());
+        response.endObject();
+        
+        send_response(call, transport, encoded);
+        
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Error creating universe: ") + ex.what());
+    }
+}
+
+// Result of one entry of a createUniverses batch
+struct BatchItem {
+    std::unique_ptr<SimulatedUniverse> universe;
+    std::optional<MilestoneType> ending;
+    std::string error;
+};
+
+// Parse, validate and evaluate one createUniverses entry
+static BatchItem evaluate_batch_item(const json& entry) {
+    BatchItem item;
+    try {
+        const double matterDensity = entry.at("matterDensity").get<double>();
+        const double darkEnergyDensity = entry.at("darkEnergyDensity").get<double>();
+        const double hubbleConstant = entry.at("hubbleConstant").get<double>();
+        const double matterAntimatterRatio = entry.at("matterAntimatterRatio").get<double>();
+        const double darkEnergyW = entry.at("darkEnergyW").get<double>();
+
+        auto validation = UniverseValidator::validateParameters(
+            matterDensity, darkEnergyDensity, hubbleConstant,
+            matterAntimatterRatio, darkEnergyW);
+        if (!validation.isValid) {
+            item.error = std::move(validation.message);
+            return item;
+        }
+
+        item.universe = std::make_unique<SimulatedUniverse>(
+            entry.at("name").get<std::string>(), matterDensity, darkEnergyDensity,
+            hubbleConstant, matterAntimatterRatio, darkEnergyW);
+        item.ending = item.universe->ending();
+    } catch (const std::exception& ex) {
+        item.error = ex.what();
+    }
+    return item;
+}
+
+// Callback to create many universes in one call:
+//   {"universes": [{"name": ..., "matterDensity": ..., ...}, ...]}
+// Entries are parsed, validated and evaluated in parallel and stored under
+// one database lock per slice. The response lists {"ending", "id"} or {"error"} per
+// entry, in request order.
+void create_universes(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        const json& entries = data.at("universes");
+        if (!entries.is_array()) {
+            throw std::runtime_error("universes must be an array");
+        }
+
+        // Entries are evaluated and stored a slice at a time, yielding to
+        // interactive calls in between. Each slice gets consecutive ids.
+        std::vector<BatchItem> items(entries.size());
+        std::vector<int> ids(entries.size(), -1);
+        int created = 0;
+        for (size_t slice = 0; slice < items.size(); slice += kBulkSlice) {
+            const size_t sliceEnd = std::min(items.size(), slice + kBulkSlice);
+            parallelFor(sliceEnd - slice, 256, [&](size_t begin, size_t end) {
+                for (size_t i = slice + begin; i < slice + end; ++i) {
+                    items[i] = evaluate_batch_item(entries[i]);
+                }
+            });
+
+            std::vector<std::unique_ptr<SimulatedUniverse>> batch;
+            for (size_t i = slice; i < sliceEnd; ++i) {
+                if (items[i].universe) {
+                    batch.push_back(std::move(items[i].universe));
+                }
+            }
+            int nextId = UniverseDB::instance().addUniverses(std::move(batch));
+            for (size_t i = slice; i < sliceEnd; ++i) {
+                if (items[i].error.empty()) {
+                    ids[i] = nextId++;
+                    ++created;
+                }
+            }
+            PriorityScheduler::checkpoint();
+        }
+        std::cout << "Created " << created << " of " << items.size() << " universes" << std::endl;
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kCreatedKey);
+        response.value(created);
+        response.key(kFailedKey);
+        response.value(static_cast<int>(items.size()) - created);
+        response.key(kResultsKey);
+        response.beginArray();
+        for (size_t i = 0; i < items.size(); ++i) {
+            const BatchItem& item = items[i];
+            response.beginObject();
+            if (!item.error.empty()) {
+                response.key(kErrorKey);
+                response.value(item.error);
+            } else {
+                response.key(kEndingKey);
+                if (item.ending) {
+                    response.value(getMilestoneTypeString(static_cast<int>(*item.ending)));
+                } else {
+                    response.null();
+                }
+                response.key(kIdKey);
+                response.value(ids[i]);
+            }
+            response.endObject();
+        }
+        response.endArray();
+        response.key(kStatusKey);
+        response.value("success");
+        response.endObject();
+
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Error creating universes: ") + ex.what());
+    }
+}
+
+// Callback to edit a stored universe:
+//   {"id": 3, "name": ..., "matterDensity": ..., ...}
+// Omitted fields keep their current value. Only the milestones that read a
+// changed parameter are recomputed; the response lists the changed
+// parameters and those milestones next to the updated universe.
+void update_universe(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        const int id = data.at("id").get<int>();
+        UniverseDB::UniverseUpdate update;
+        if (data.contains("name")) {
+            update.name = data["name"].get<std::string>();
+        }
+        if (data.contains("matterDensity")) {
+            update.matterDensity = data["matterDensity"].get<double>();
+        }
+        if (data.contains("darkEnergyDensity")) {
+            update.darkEnergyDensity = data["darkEnergyDensity"].get<double>();
+        }
+        if (data.contains("hubbleConstant")) {
+            update.hubbleConstant = data["hubbleConstant"].get<double>();
+        }
+        if (data.contains("matterAntimatterRatio")) {
+            update.matterAntimatterRatio = data["matterAntimatterRatio"].get<double>();
+        }
+        if (data.contains("darkEnergyW")) {
+            update.darkEnergyW = data["darkEnergyW"].get<double>();
+        }
+
+        // Omitted fields are merged under the database lock, so concurrent
+        // partial updates of one universe cannot undo each other
+        const auto updated = UniverseDB::instance().updateUniverse(id, update, [](const UniverseParameters& params) {
+            auto validation = UniverseValidator::validateParameters(
+                params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+                params.getMatterAntimatterRatio(), params.getDarkEnergyW());
+            if (!validation.isValid) {
+                throw std::runtime_error(validation.message);
+            }
+        });
+        if (!updated) {
+            throw std::runtime_error("Universe not found");
+        }
+        const MilestoneFormulas::ParameterMask changed = updated->changed;
+        const SimulatedUniverse& universe = *updated->universe;
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kChangedKey);
+        response.beginArray();
+        for (size_t i = 0; i < MilestoneFormulas::kParameterCount; ++i) {
+            if (changed & (1u << i)) {
+                response.value(MilestoneFormulas::kParameterNames[i]);
+            }
+        }
+        response.endArray();
+        response.key(kMessageKey);
+        response.value("Universe updated successfully");
+        response.key(kRecomputedKey);
+        response.beginArray();
+        const LazyTimeline& timeline = universe.getComputedTimeline().timeline();
+        for (size_t i = 0; i < timeline.size(); ++i) {
+            if (MilestoneFormulas::dependencies(timeline.typeAt(i)) & changed) {
+                response.value(getMilestoneTypeString(static_cast<int>(timeline.typeAt(i))));
+            }
+        }
+        response.endArray();
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kUniverseKey);
+        write_universe(response, universe, id, Projection::all());
+        response.endObject();
+
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Error updating universe: ") + ex.what());
+    }
+}
+
+// Scratch universe per window for live previews. Only that window's preview
+// worker touches it, so consecutive previews edit it in place and keep the
+// timestamps that the changed parameters do not affect. release_client()
+// drops it; a preview still computing keeps its own reference.
+static LatestWinsQueue previews;
+static std::mutex preview_universes_mutex;
+static std::unordered_map<size_t, std::shared_ptr<SimulatedUniverse>> preview_universes;
+
+static std::shared_ptr<SimulatedUniverse> preview_universe_for(size_t client) {
+    std::lock_guard<std::mutex> lock(preview_universes_mutex);
+    auto& universe = preview_universes[client];
+    if (!universe) {
+        universe = std::make_shared<SimulatedUniverse>("Preview", 0.3, 0.7, 70.0, 1e-9, -1.0);
+    }
+    return universe;
+}
+
+// Callback for a live preview while the create form is edited:
+//   {"name": ..., "matterDensity": ..., ...} as for createUniverse
+// Nothing is stored. The call returns {"sequence": n, "status": "queued"}
+// at once; the timeline is pushed to receivePreview with the same sequence.
+// A newer preview from the same window replaces one that has not started,
+// and a result that is superseded while computing is not sent at all.
+void preview_universe(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        std::string name = data.value("name", std::string("Preview"));
+        const UniverseParameters params(
+            data.at("matterDensity").get<double>(), data.at("darkEnergyDensity").get<double>(),
+            data.at("hubbleConstant").get<double>(), data.at("matterAntimatterRatio").get<double>(),
+            data.at("darkEnergyW").get<double>());
+        auto validation = UniverseValidator::validateParameters(
+            params.getMatterDensity(), params.getDarkEnergyDensity(), params.getHubbleConstant(),
+            params.getMatterAntimatterRatio(), params.getDarkEnergyW());
+        if (!validation.isValid) {
+            throw std::runtime_error(validation.message);
+        }
+
+        const Pusher push = call.pusher();
+        if (!push) {
+            throw std::runtime_error("Previews are pushed and need a transport that can push");
+        }
+        const size_t target = call.client();
+        const Encoding encoding = transport.encoding;
+        const std::uint64_t sequence = previews.submit(
+            target, [target, push, encoding, params, name = std::move(name)](std::uint64_t sequence) {
+                if (!previews.isCurrent(target, sequence)) {
+                    return;
+                }
+                auto arena = RequestArena::acquire();
+                EncodedResponse encoded(encoding, arena.resource());
+                ResponseWriter& message = encoded.writer();
+                try {
+                    const auto scratch = preview_universe_for(target);
+                    SimulatedUniverse& universe = *scratch;
+                    universe.setName(name);
+                    universe.setParameters(params);
+                    universe.getComputedTimeline().timeline();
+                    if (!previews.isCurrent(target, sequence)) {
+                        return;
+                    }
+                    message.beginObject();
+                    message.key(kSequenceKey);
+                    message.value(static_cast<int>(sequence));
+                    message.key(kStatusKey);
+                    message.value("success");
+                    message.key(kUniverseKey);
+                    write_universe(message, universe, -1, Projection::all());
+                    message.endObject();
+                } catch (const std::exception& ex) {
+                    EncodedResponse failure(encoding, arena.resource());
+                    ResponseWriter& error = failure.writer();
+                    error.beginObject();
+                    error.key(kMessageKey);
+                    error.value(std::string("Preview failed: ") + ex.what());
+                    error.key(kSequenceKey);
+                    error.value(static_cast<int>(sequence));
+                    error.key(kStatusKey);
+                    error.value("error");
+                    error.endObject();
+                    const std::string_view bytes = encoding == Encoding::Json ? failure.finish() : failure.bytes();
+                    push("receivePreview", bytes);
+                    return;
+                }
+                const std::string_view bytes = encoding == Encoding::Json ? encoded.finish() : encoded.bytes();
+                push("receivePreview", bytes);
+            });
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kSequenceKey);
+        response.value(static_cast<int>(sequence));
+        response.key(kStatusKey);
+        response.value("queued");
+        response.endObject();
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Error previewing universe: ") + ex.what());
+    }
+}
+
+// Callback to find stored universes close to a reference point:
+//   {"id": 3} or {"matterDensity": ..., "darkEnergyDensity": ..., ...}
+//   "k": number of neighbours (default 20), "radius": optional distance cap
+//   "weights": optional per-axis weights keyed by parameter name
+// Distances are measured in normalized parameter space. The reference
+// universe itself is not part of the result. Supports "fields" like getUniverses.
+void find_similar_universes(Call& call) {
+    static constexpr long long kMaxNeighbors = 10000;
+    static constexpr const char* kAxisNames[ParameterIndex::kAxes] = {
+        "matterDensity", "darkEnergyDensity", "hubbleConstant", "matterAntimatterRatio", "darkEnergyW",
+    };
+
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        const Projection projection = parse_projection(data);
+        auto arena = RequestArena::acquire();
+
+        auto& db = UniverseDB::instance();
+        int excludeId = -1;
+        ParameterIndex::Point point;
+        if (data.contains("id")) {
+            excludeId = data["id"].get<int>();
+            auto reference = db.getUniverse(excludeId);
+            if (!reference) {
+                throw std::runtime_error("Universe not found");
+            }
+            point = ParameterIndex::normalize(*reference);
+        } else {
+            point = ParameterIndex::normalize(
+                data.at("matterDensity").get<double>(), data.at("darkEnergyDensity").get<double>(),
+                data.at("hubbleConstant").get<double>(), data.at("matterAntimatterRatio").get<double>(),
+                data.at("darkEnergyW").get<double>());
+        }
+
+        ParameterIndex::Weights weights = ParameterIndex::kUniformWeights;
+        if (data.contains("weights")) {
+            const json& given = data["weights"];
+            for (size_t axis = 0; axis < ParameterIndex::kAxes; ++axis) {
+                weights[axis] = given.value(kAxisNames[axis], 1.0);
+                if (!(weights[axis] >= 0.0)) {
+                    throw std::runtime_error(std::string("Weight must be non-negative: ") + kAxisNames[axis]);
+                }
+            }
+        }
+
+        std::optional<size_t> givenK;
+        if (data.contains("k")) {
+            const long long value = data["k"].get<long long>();
+            if (value < 0 || value > kMaxNeighbors) {
+                throw std::runtime_error("k must be between 0 and " + std::to_string(kMaxNeighbors));
+            }
+            givenK = static_cast<size_t>(value);
+        }
+
+        // Radius queries are uncapped unless "k" is given as well
+        std::vector<ParameterIndex::Neighbor> neighbors;
+        size_t k;
+        if (data.contains("radius")) {
+            k = givenK.value_or(std::numeric_limits<size_t>::max());
+            neighbors = db.findWithinRadius(point, data["radius"].get<double>(), weights);
+        } else {
+            k = givenK.value_or(20);
+            // One extra candidate makes up for the reference universe
+            neighbors = db.findNearest(point, excludeId >= 0 ? k + 1 : k, weights);
+        }
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kNeighborsKey);
+        response.beginArray();
+        size_t written = 0;
+        const UniverseDB::View stored = db.view();
+        for (const auto& neighbor : neighbors) {
+            if (written == k) {
+                break;
+            }
+            const auto universe = stored.get(neighbor.id);
+            if (neighbor.id == excludeId || !universe) {
+                continue;  // the reference itself, or removed after the query
+            }
+            ++written;
+            response.beginObject();
+            response.key(kDistanceKey);
+            response.value(neighbor.distance);
+            response.key(kUniverseKey);
+            write_universe(response, *universe, neighbor.id, projection);
+            response.endObject();
+        }
+        response.endArray();
+        response.key(kStatusKey);
+        response.value("success");
+        response.endObject();
+
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Similarity search failed: ") + ex.what());
+    }
+}
+
+// Callback reporting runtime metrics
+void get_metrics(Call& call) {
+    TransportOptions transport;
+    try {
+        transport = negotiate_transport(parse_request(call.body()));
+        auto arena = RequestArena::acquire();
+
+        const auto cache = TimelineCache::instance().getStats();
+        const auto scheduler = PriorityScheduler::instance().getStats();
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        // Calls per lane, and how often bulk work paused for interactive calls
+        response.key(kSchedulerKey);
+        response.beginObject();
+        response.key(kBulkAgedKey);
+        response.value(static_cast<std::int64_t>(scheduler.bulkAged));
+        response.key(kBulkPausesKey);
+        response.value(static_cast<std::int64_t>(scheduler.bulkPauses));
+        response.key(kBulkQueuedKey);
+        response.value(static_cast<int>(scheduler.bulkQueued));
+        response.key(kBulkRunningKey);
+        response.value(static_cast<int>(scheduler.bulkRunning));
+        response.key(kBulkWaitingKey);
+        response.value(static_cast<int>(scheduler.bulkWaiting));
+        response.key(kInteractiveRunningKey);
+        response.value(static_cast<int>(scheduler.interactiveRunning));
+        response.key(kInteractiveWaitingKey);
+        response.value(static_cast<int>(scheduler.interactiveWaiting));
+        response.endObject();
+        response.key(kStatusKey);
+        response.value("success");
+        // Dedup of identical parameter sets: hits are universes that reused
+        // an existing timeline record
+        response.key(kTimelineCacheKey);
+        response.beginObject();
+        response.key(kDistinctKey);
+        response.value(static_cast<std::int64_t>(cache.distinct));
+        response.key(kHitRateKey);
+        response.value(cache.lookups ? static_cast<double>(cache.hits) / cache.lookups : 0.0);
+        response.key(kHitsKey);
+        response.value(static_cast<std::int64_t>(cache.hits));
+        response.key(kLookupsKey);
+        response.value(static_cast<std::int64_t>(cache.lookups));
+        response.endObject();
+        response.key(kUniversesKey);
+        response.value(static_cast<std::int64_t>(UniverseDB::instance().getUniverseCount()));
+        response.endObject();
+
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, ex.what());
+    }
+}
+
+// Write histogram bins as an array of integers
+void write_counts(ResponseWriter& writer, const std::uint64_t* counts, size_t size) {
+    writer.beginArray();
+    for (size_t i = 0; i < size; ++i) {
+        writer.value(static_cast<std::int64_t>(counts[i]));
+    }
+    writer.endArray();
+}
+
+// Callback returning the reference scenarios of PresetCatalog with their
+// timelines. The response was encoded at build time in every encoding, so
+// this only hands out the static bytes.
+void get_presets(Call& call) {
+    TransportOptions transport;
+    try {
+        transport = negotiate_transport(parse_request(call.body()));
+        auto arena = RequestArena::acquire();
+        std::string_view encoded_presets = preset_response_json;
+        if (transport.encoding == Encoding::Cbor) {
+            encoded_presets = preset_response_cbor;
+        } else if (transport.encoding == Encoding::MessagePack) {
+            encoded_presets = preset_response_msgpack;
+        }
+        EncodedResponse encoded(transport.encoding, encoded_presets, arena.resource());
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, ex.what());
+    }
+}
+
+// Callback returning ensemble aggregates maintained by UniverseDB: ending
+// counts plus count, mean, min, max and histograms of every parameter and
+// milestone time. Log histograms are trimmed to their non-empty bins.
+void get_statistics(Call& call) {
+    TransportOptions transport;
+    try {
+        transport = negotiate_transport(parse_request(call.body()));
+        auto arena = RequestArena::acquire();
+
+        const auto statistics = UniverseDB::instance().getStatistics();
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kEndingsKey);
+        response.beginObject();
+        std::vector<std::pair<std::string_view, std::uint64_t>> endings;
+        for (size_t type = 0; type < kMilestoneTypeCount; ++type) {
+            if (statistics.endings[type]) {
+                endings.emplace_back(getMilestoneTypeString(static_cast<int>(type)), statistics.endings[type]);
+            }
+        }
+        endings.emplace_back("NONE", statistics.endings[kMilestoneTypeCount]);
+        std::sort(endings.begin(), endings.end());
+        for (const auto& [name, count] : endings) {
+            response.key(name);
+            response.value(static_cast<std::int64_t>(count));
+        }
+        response.endObject();
+
+        response.key(kQuantitiesKey);
+        response.beginArray();
+        for (size_t q = 0; q < EnsembleStatistics::kQuantities; ++q) {
+            const auto& quantity = statistics.quantities[q];
+            const auto [low, high] = EnsembleStatistics::linearRange(q);
+            response.beginObject();
+            response.key(kCountKey);
+            response.value(static_cast<std::int64_t>(quantity.count));
+
+            response.key(kLinearKey);
+            response.beginObject();
+            response.key(kCountsKey);
+            write_counts(response, quantity.linear.data(), quantity.linear.size());
+            response.key(kMaxKey);
+            response.value(high);
+            response.key(kMinKey);
+            response.value(low);
+            response.key(kOverflowKey);
+            response.value(static_cast<std::int64_t>(quantity.linearOverflow));
+            response.key(kUnderflowKey);
+            response.value(static_cast<std::int64_t>(quantity.linearUnderflow));
+            response.endObject();
+
+            const auto& log = quantity.log;
+            const auto nonEmpty = [](std::uint64_t count) { return count != 0; };
+            const size_t first = std::find_if(log.begin(), log.end(), nonEmpty) - log.begin();
+            const size_t last = first == log.size() ? first
+                              : log.size() - (std::find_if(log.rbegin(), log.rend(), nonEmpty) - log.rbegin());
+            response.key(kLogKey);
+            response.beginObject();
+            response.key(kBinsPerDecadeKey);
+            response.value(EnsembleStatistics::kLogBinsPerDecade);
+            response.key(kCountsKey);
+            write_counts(response, log.data() + first, last - first);
+            response.key(kOverflowKey);
+            response.value(static_cast<std::int64_t>(quantity.logOverflow));
+            response.key(kStartExponentKey);
+            response.value(EnsembleStatistics::kMinExponent +
+                           static_cast<double>(first) / EnsembleStatistics::kLogBinsPerDecade);
+            response.key(kUnderflowKey);
+            response.value(static_cast<std::int64_t>(quantity.logUnderflow));
+            response.endObject();
+
+            response.key(kMaxKey);
+            response.value(quantity.max);
+            response.key(kMeanKey);
+            response.value(quantity.mean());
+            response.key(kMinKey);
+            response.value(quantity.min);
+            response.key(kNameKey);
+            if (q < EnsembleStatistics::kParameterCount) {
+                response.value(MilestoneFormulas::kParameterNames[q]);
+            } else {
+                response.value(getMilestoneTypeString(static_cast<int>(q - EnsembleStatistics::kParameterCount)));
+            }
+            response.endObject();
+        }
+        response.endArray();
+
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kTotalKey);
+        response.value(static_cast<std::int64_t>(statistics.total));
+        response.endObject();
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, ex.what());
+    }
+}
+
+// Write expansion samples as rows of kExpansionColumns
+void write_samples(ResponseWriter& writer, const std::vector<ExpansionSample>& samples) {
+    writer.beginArray();
+    for (const auto& sample : samples) {
+        writer.beginArray();
+        writer.value(sample.time);
+        writer.value(sample.scaleFactor);
+        writer.value(sample.hubble);
+        writer.value(sample.temperature);
+        writer.value(sample.matterFraction);
+        writer.value(sample.radiationFraction);
+        writer.value(sample.darkEnergyFraction);
+        writer.endArray();
+    }
+    writer.endArray();
+}
+
+// Refinements run on a few workers. A window's new stream supersedes its
+// queued one, and cancels the one being pushed through expansion_streams.
+static LatestWinsQueue expansions(2);
+static std::mutex expansion_streams_mutex;
+static std::unordered_map<size_t, std::uint32_t> expansion_streams;  // client -> channel id
+
+// Push refinement chunks of sampler to receiveExpansionChunk() as
+// {"done", "samples", "sequence", "streamId"}, pausing while the page has
+// not acknowledged enough of them (PushChannel)
+static void refine_expansion(const std::shared_ptr<PushChannel>& channel, const Pusher& push, Encoding encoding,
+                             ExpansionSampler& sampler) {
+    static constexpr size_t kChunkSamples = 128;
+
+    while (!sampler.done()) {
+        const auto sequence = channel->reserve();
+        if (!sequence) {
+            break;
+        }
+        auto arena = RequestArena::acquire();
+        const auto chunk = sampler.refine(kChunkSamples);
+
+        EncodedResponse encoded(encoding, arena.resource());
+        ResponseWriter& message = encoded.writer();
+        message.beginObject();
+        message.key(kDoneKey);
+        message.boolean(sampler.done());
+        message.key(kSamplesKey);
+        write_samples(message, chunk);
+        message.key(kSequenceKey);
+        message.value(static_cast<int>(*sequence));
+        message.key(kStreamIdKey);
+        message.value(static_cast<int>(channel->getId()));
+        message.endObject();
+
+        // JSON chunks are sent as UTF-8 bytes, binary ones as-is
+        const std::string_view bytes = encoding == Encoding::Json ? encoded.finish() : encoded.bytes();
+        push("receiveExpansionChunk", bytes);
+    }
+    PushChannel::close(channel->getId());
+}
+
+// Callback returning a coarse expansion history for a universe:
+//   {"id": 3, "maxSamples": 4096, "window": 4}
+// The call answers at once with a coarse curve and a stream id. Refinement
+// chunks of that stream then follow to receiveExpansionChunk() in app.js,
+// largest interpolation error first, until the curve is within tolerance
+// ("done": true). The page acknowledges them with acknowledgeStream; a new
+// call from the same window cancels the previous stream.
+void get_expansion_history(Call& call) {
+    static constexpr size_t kCoarseSamples = 48;
+    static constexpr size_t kSampleLimit = 100000;
+    static constexpr std::uint32_t kMaxWindow = 64;
+
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        auto universe = UniverseDB::instance().getUniverse(data.at("id").get<int>());
+        if (!universe) {
+            throw std::runtime_error("Universe not found");
+        }
+        const SimulatedUniverse& stored = *universe;
+        const UniverseParameters params(stored.getMatterDensity(), stored.getDarkEnergyDensity(),
+                                        stored.getHubbleConstant(), stored.getMatterAntimatterRatio(),
+                                        stored.getDarkEnergyW());
+        const size_t maxSamples = std::min<size_t>(data.value("maxSamples", 4096u), kSampleLimit);
+        const std::uint32_t window = std::clamp<std::uint32_t>(
+            data.value("window", PushChannel::kDefaultWindow), 1, kMaxWindow);
+
+        auto sampler = std::make_shared<ExpansionSampler>(params, maxSamples);
+        const auto samples = sampler->coarse(kCoarseSamples);
+
+        // Transports that cannot push only get the coarse samples
+        const Pusher push = call.pusher();
+        const auto channel = sampler->done() || !push ? nullptr : PushChannel::open(window);
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kColumnsKey);
+        response.beginArray();
+        for (const char* column : kExpansionColumns) {
+            response.value(column);
+        }
+        response.endArray();
+        response.key(kDoneKey);
+        response.boolean(!channel);
+        response.key(kSamplesKey);
+        write_samples(response, samples);
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kStreamIdKey);
+        response.value(channel ? static_cast<int>(channel->getId()) : 0);
+        response.endObject();
+        send_response(call, transport, encoded);
+        if (!channel) {
+            return;
+        }
+
+        const size_t client = call.client();
+        {
+            std::lock_guard<std::mutex> lock(expansion_streams_mutex);
+            std::uint32_t& current = expansion_streams[client];
+            if (auto previous = PushChannel::find(current)) {
+                previous->cancel();
+                PushChannel::close(current);
+            }
+            current = channel->getId();
+        }
+        const Encoding encoding = transport.encoding;
+        expansions.submit(client, [channel, push, encoding, sampler, client](std::uint64_t) {
+            refine_expansion(channel, push, encoding, *sampler);
+            std::lock_guard<std::mutex> lock(expansion_streams_mutex);
+            auto it = expansion_streams.find(client);
+            if (it != expansion_streams.end() && it->second == channel->getId()) {
+                expansion_streams.erase(it);
+            }
+        });
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Expansion history failed: ") + ex.what());
+    }
+}
+
+void release_client(size_t client) {
+    previews.release(client);
+    {
+        std::lock_guard<std::mutex> lock(preview_universes_mutex);
+        preview_universes.erase(client);
+    }
+
+    expansions.release(client);
+    std::lock_guard<std::mutex> lock(expansion_streams_mutex);
+    auto it = expansion_streams.find(client);
+    if (it != expansion_streams.end()) {
+        if (auto channel = PushChannel::find(it->second)) {
+            channel->cancel();
+        }
+        PushChannel::close(it->second);
+        expansion_streams.erase(it);
+    }
+}
+
+// Callback returning d(timestamp)/d(parameter) for every milestone of a
+// universe: {"id": 3}. Each row holds the gradient in "parameters" order.
+void get_sensitivities(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        auto universe = UniverseDB::instance().getUniverse(data.at("id").get<int>());
+        if (!universe) {
+            throw std::runtime_error("Universe not found");
+        }
+        const auto rows = universe->timestampJacobian();
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kParametersKey);
+        response.beginArray();
+        for (const char* name : MilestoneFormulas::kParameterNames) {
+            response.value(name);
+        }
+        response.endArray();
+        response.key(kRowsKey);
+        response.beginArray();
+        for (const auto& row : rows) {
+            response.beginObject();
+            response.key(kGradientKey);
+            response.beginArray();
+            for (double derivative : row.gradient) {
+                response.value(derivative);
+            }
+            response.endArray();
+            response.key(kTimestampKey);
+            response.value(row.timestamp);
+            response.key(kTypeKey);
+            response.value(getMilestoneTypeString(static_cast<int>(row.type)));
+            response.endObject();
+        }
+        response.endArray();
+        response.key(kStatusKey);
+        response.value("success");
+        response.endObject();
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Sensitivity analysis failed: ") + ex.what());
+    }
+}
+
+// Callback searching for parameters that hit target milestone times:
+//   {"targets": [{"type": "FIRST_STARS", "time": 0.15, "weight": 1}],
+//    "ending": "BIG_RIP", "budgetMs": 100, "starts": 64}
+// Answers with the Pareto-best candidates found within the time budget.
+void solve_inverse(Call& call) {
+    static constexpr int kMaxBudgetMs = 2000;
+    static constexpr size_t kMaxStarts = 1024;
+
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        InverseSolver::Problem problem;
+        for (const auto& target : data.at("targets")) {
+            const double time = target.at("time").get<double>();
+            if (!(time > 0.0)) {
+                throw std::runtime_error("Target times must be positive");
+            }
+            problem.targets.push_back({parse_milestone_type(target.at("type")), time,
+                                       target.value("weight", 1.0)});
+        }
+        if (data.contains("ending") && !data["ending"].is_null()) {
+            problem.ending = parse_milestone_type(data["ending"]);
+        }
+        if (problem.targets.empty() && !problem.ending) {
+            throw std::runtime_error("No targets given");
+        }
+
+        InverseSolver::Options options;
+        options.budget = std::chrono::milliseconds(std::clamp(data.value("budgetMs", 100), 1, kMaxBudgetMs));
+        options.starts = std::clamp<size_t>(data.value("starts", options.starts), 1, kMaxStarts);
+        options.maxCandidates = std::max<size_t>(data.value("maxCandidates", options.maxCandidates), 1);
+        const auto result = InverseSolver(std::move(problem)).solve(options);
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kCandidatesKey);
+        response.beginArray();
+        for (const auto& candidate : result.candidates) {
+            const UniverseParameters& params = candidate.parameters;
+            response.beginObject();
+            response.key(kCostKey);
+            response.value(candidate.cost);
+            response.key(kDarkEnergyDensityKey);
+            response.value(params.getDarkEnergyDensity());
+            response.key(kDarkEnergyWKey);
+            response.value(params.getDarkEnergyW());
+            response.key(kErrorsKey);
+            response.beginArray();
+            for (double error : candidate.errors) {
+                response.value(error);
+            }
+            response.endArray();
+            response.key(kHubbleConstantKey);
+            response.value(params.getHubbleConstant());
+            response.key(kMatterAntimatterRatioKey);
+            response.value(params.getMatterAntimatterRatio());
+            response.key(kMatterDensityKey);
+            response.value(params.getMatterDensity());
+            response.endObject();
+        }
+        response.endArray();
+        response.key(kConvergedKey);
+        response.boolean(result.converged);
+        response.key(kEvaluationsKey);
+        response.value(static_cast<int>(result.evaluations));
+        response.key(kStartsRunKey);
+        response.value(static_cast<int>(result.startsRun));
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kTimedOutKey);
+        response.boolean(result.timedOut);
+        response.endObject();
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Inverse search failed: ") + ex.what());
+    }
+}
+
+// Callback listing milestones that fall in a time window:
+//   {"types": ["GALAXY_FORMATION", "FIRST_STARS"], "from": 0, "to": 1, "limit": 1000}
+// Events come from UniverseDB's milestone-time index, earliest first.
+void query_events(Call& call) {
+    static constexpr size_t kMaxLimit = 100000;
+
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        std::vector<MilestoneType> types;
+        for (const auto& type : data.at("types")) {
+            types.push_back(parse_milestone_type(type));
+        }
+        const double from = data.value("from", -std::numeric_limits<double>::infinity());
+        const double to = data.value("to", std::numeric_limits<double>::infinity());
+        const size_t limit = std::min<size_t>(data.value("limit", 1000u), kMaxLimit);
+
+        // One extra event tells whether the list was cut off
+        auto& db = UniverseDB::instance();
+        auto events = db.findEvents(types, from, to, limit + 1);
+        const bool truncated = events.size() > limit;
+        if (truncated) {
+            events.pop_back();
+        }
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kEventsKey);
+        response.beginArray();
+        const UniverseDB::View stored = db.view();
+        for (const auto& event : events) {
+            const auto universe = stored.get(event.id);
+            if (!universe) {
+                continue;  // removed since the query
+            }
+            response.beginObject();
+            response.key(kIdKey);
+            response.value(event.id);
+            response.key(kNameKey);
+            response.value(universe->getName());
+            response.key(kTimestampKey);
+            response.value(event.timestamp);
+            response.key(kTypeKey);
+            response.value(getMilestoneTypeString(static_cast<int>(event.type)));
+            response.endObject();
+        }
+        response.endArray();
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kTruncatedKey);
+        response.boolean(truncated);
+        response.endObject();
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Event query failed: ") + ex.what());
+    }
+}
+
+// Callback to delete a universe
+void delete_universe(Call& call) {
+    TransportOptions transport;
+    try {
+        json params = parse_request(call.body());
+        transport = negotiate_transport(params);
+        auto arena = RequestArena::acquire();
+        int id = params["id"].get<int>();
+        
+        std::cout << "Deleting universe " << id << std::endl;
+        
+        if (UniverseDB::instance().removeUniverse(id)) {
+            EncodedResponse encoded(transport.encoding, arena.resource());
+            ResponseWriter& response = encoded.writer();
+            response.beginObject();
+            response.key(kMessageKey);
+            response.value("Universe deleted successfully");
+            response.key(kStatusKey);
+            response.value("success");
+            response.endObject();
+            send_response(call, transport, encoded);
+        } else {
+            throw std::runtime_error("Universe not found");
+        }
+    } catch (const std::exception& ex) {
+        std::cout << "Error deleting universe: " << ex.what() << std::endl;
+        send_error(call, transport, ex.what());
+    }
+}
+
+// Callback to get list of universes
+void get_universes(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        const Projection projection = parse_projection(data);
+        auto arena = RequestArena::acquire();
+
+        // Read the stored universes in place; only milestones need a timeline
+        const UniverseDB::View universes = UniverseDB::instance().view();
+        
+        // Stream all universes into the response
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kUniversesKey);
+        response.beginArray();
+        for (size_t id = 0; id < universes.size(); ++id) {
+            if (const auto universe = universes.get(static_cast<int>(id))) {
+                write_universe(response, *universe, static_cast<int>(id), projection);
+            }
+        }
+        response.endArray();
+        response.endObject();
+        
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, ex.what());
+    }
+}
+
+// Add new export handlers
+void export_universe(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+        int id = data["id"].get<int>();
+        std::string format = data["format"].get<std::string>();
+        
+        std::optional<std::string> exportData;
+        if (format == "json") {
+            exportData = UniverseDB::instance().exportToJSON(id);
+        } else if (format == "csv") {
+            exportData = UniverseDB::instance().exportToCSV(id);
+        }
+        
+        if (exportData) {
+            EncodedResponse encoded(transport.encoding, arena.resource());
+            ResponseWriter& response = encoded.writer();
+            response.beginObject();
+            response.key(kDataKey);
+            response.value(*exportData);
+            response.key(kStatusKey);
+            response.value("success");
+            response.endObject();
+            send_response(call, transport, encoded);
+        } else {
+            throw std::runtime_error("Universe not found");
+        }
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Export failed: ") + ex.what());
+    }
+}
+
+// Worker of a pushed stream. For each batch it waits until the page has
+// acknowledged enough earlier ones (PushChannel), then, holding a slot of the
+// lane of the handler that started it, lets gather collect the batch and
+// report whether it is the last, and pushes {"done", "sequence", "streamId",
+// ...} with the keys of write to the receiver function in app.js.
+static void run_push_stream(const std::shared_ptr<PushChannel>& channel, const Pusher& push, Encoding encoding,
+                            PriorityScheduler::Lane lane, const char* receiver, const std::function<bool()>& gather,
+                            const std::function<void(ResponseWriter&)>& write) {
+    bool done = false;
+    while (!done) {
+        const auto sequence = channel->reserve();
+        if (!sequence) {
+            break;
+        }
+        const auto slot = PriorityScheduler::instance().acquire(lane);
+        done = gather();
+
+        auto arena = RequestArena::acquire();
+        EncodedResponse encoded(encoding, arena.resource());
+        ResponseWriter& message = encoded.writer();
+        message.beginObject();
+        message.key(kDoneKey);
+        message.boolean(done);
+        message.key(kSequenceKey);
+        message.value(static_cast<int>(*sequence));
+        message.key(kStreamIdKey);
+        message.value(static_cast<int>(channel->getId()));
+        write(message);
+        message.endObject();
+
+        const std::string_view bytes = encoding == Encoding::Json ? encoded.finish() : encoded.bytes();
+        push(receiver, bytes);
+    }
+    PushChannel::close(channel->getId());
+}
+
+// Pushed streams run on a few workers of their own, as each spends most of
+// its time waiting for acknowledgements, and a client may only have a few
+// of them open at once.
+static constexpr size_t kMaxStreamWorkers = 4;
+static constexpr size_t kMaxStreamsPerClient = 4;
+static std::mutex push_streams_mutex;
+static std::unordered_map<size_t, size_t> push_streams;  // client -> open streams
+
+static LatestWinsQueue& push_stream_workers() {
+    // Built after the singletons its jobs use, so it drains before they go
+    UniverseDB::instance();
+    PriorityScheduler::instance();
+    static LatestWinsQueue workers(kMaxStreamWorkers);
+    return workers;
+}
+
+// A stream whose worker is queued but holds off until begin(), so that the
+// reply carrying the stream id reaches the page before the first batch.
+// Dropped without begin(), as when the reply fails, it cancels the stream.
+class PendingStream {
+public:
+    PendingStream(std::shared_ptr<PushChannel> channel, std::shared_ptr<std::promise<void>> started)
+        : channel(std::move(channel)), started(std::move(started)) {}
+    PendingStream(const PendingStream&) = delete;
+    PendingStream& operator=(const PendingStream&) = delete;
+    ~PendingStream() {
+        if (started) {
+            channel->cancel();
+            started->set_value();
+        }
+    }
+
+    std::uint32_t getId() const { return channel->getId(); }
+    void begin() { std::exchange(started, nullptr)->set_value(); }
+
+private:
+    std::shared_ptr<PushChannel> channel;
+    std::shared_ptr<std::promise<void>> started;
+};
+
+// Open a stream of call's client and queue its run_push_stream worker
+static PendingStream start_push_stream(const Call& call, PriorityScheduler::Lane lane, std::uint32_t window,
+                                       Encoding encoding, const char* receiver, std::function<bool()> gather,
+                                       std::function<void(ResponseWriter&)> write) {
+    const Pusher push = call.pusher();
+    const size_t client = call.client();
+    {
+        std::lock_guard<std::mutex> lock(push_streams_mutex);
+        size_t& open = push_streams[client];
+        if (open >= kMaxStreamsPerClient) {
+            throw std::runtime_error("Too many open streams; cancel or finish one first");
+        }
+        ++open;
+    }
+    auto finished = [client] {
+        std::lock_guard<std::mutex> lock(push_streams_mutex);
+        auto it = push_streams.find(client);
+        if (--it->second == 0) {
+            push_streams.erase(it);
+        }
+    };
+
+    auto channel = PushChannel::open(window);
+    auto started = std::make_shared<std::promise<void>>();
+    try {
+        // Keyed by stream id, so streams never supersede one another
+        push_stream_workers().submit(channel->getId(),
+            [channel, push, encoding, lane, receiver, gather = std::move(gather), write = std::move(write),
+             ready = started->get_future().share(), finished](std::uint64_t) {
+                ready.wait();
+                run_push_stream(channel, push, encoding, lane, receiver, gather, write);
+                push_stream_workers().release(channel->getId());
+                finished();
+            });
+    } catch (...) {
+        PushChannel::close(channel->getId());
+        finished();
+        throw;
+    }
+    return PendingStream(std::move(channel), std::move(started));
+}
+
+// Pushed export: the document in pieces of batchSize universes, each as
+// {"done", "sequence", "streamId", "text"} to receiveExportChunk() in app.js
+static void stream_export(Call& call, const TransportOptions& transport, const json& data, bool csv) {
+    static constexpr size_t kMaxBatchSize = 5000;
+    static constexpr std::uint32_t kMaxWindow = 64;
+
+    const size_t batchSize = std::clamp<size_t>(data.value("batchSize", 1000u), 1, kMaxBatchSize);
+    const std::uint32_t window = std::clamp<std::uint32_t>(
+        data.value("window", PushChannel::kDefaultWindow), 1, kMaxWindow);
+    if (!call.pusher()) {
+        throw std::runtime_error("A streamed export is pushed and needs a transport that can push");
+    }
+
+    // The pieces concatenate to the document of an unstreamed export. Each
+    // universe is built from the view as it is written.
+    struct Export {
+        UniverseDB::View universes = UniverseDB::instance().view();
+        size_t next = 0;     // id
+        size_t written = 0;  // universes
+        JsonWriter json{4};
+        std::string text;
+    };
+    auto state = std::make_shared<Export>();
+    auto stream = start_push_stream(call, PriorityScheduler::Lane::Bulk, window, transport.encoding,
+        "receiveExportChunk",
+        [state, batchSize, csv] {
+            Export& exported = *state;
+            exported.text.clear();
+            if (!csv && exported.next == 0) {
+                exported.json.beginArray();
+            }
+            for (size_t batch = 0; exported.next < exported.universes.size() && batch < batchSize; ++exported.next) {
+                const auto stored = exported.universes.get(static_cast<int>(exported.next));
+                if (!stored) {
+                    continue;
+                }
+                ++batch;
+                const auto universe = stored->universe();
+                if (!csv) {
+                    universe->write(exported.json);
+                } else {
+                    if (exported.written > 0) {
+                        exported.text += "\n\n";
+                    }
+                    exported.text += universe->toCSV();
+                }
+                ++exported.written;
+            }
+            const bool done = exported.next == exported.universes.size();
+            if (!csv) {
+                if (done) {
+                    exported.json.endArray();
+                }
+                exported.text = exported.json.str();
+                exported.json.clear();
+            }
+            return done;
+        },
+        [state](ResponseWriter& message) {
+            message.key(kTextKey);
+            message.value(state->text);
+        });
+
+    auto arena = RequestArena::acquire();
+    EncodedResponse encoded(transport.encoding, arena.resource());
+    ResponseWriter& response = encoded.writer();
+    response.beginObject();
+    response.key(kStatusKey);
+    response.value("success");
+    response.key(kStreamIdKey);
+    response.value(static_cast<int>(stream.getId()));
+    response.endObject();
+    send_response(call, transport, encoded);
+    stream.begin();
+}
+
+// Add handler for exporting all universes: {"format": "json"} or "csv".
+// With "stream": true (and optionally "batchSize", "window") the document is
+// pushed in pieces instead (stream_export).
+void export_all_universes(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+        std::string format = data["format"].get<std::string>();
+        if (data.value("stream", false)) {
+            if (format != "json" && format != "csv") {
+                throw std::runtime_error("Unknown format " + format);
+            }
+            stream_export(call, transport, data, format == "csv");
+            return;
+        }
+        
+        // Universes are built one at a time from the view as they are written
+        const UniverseDB::View universes = UniverseDB::instance().view();
+        size_t written = 0;
+        
+        if (format == "json") {
+            // Stream a JSON array of all universes, indented like toJSON()
+            JsonWriter allUniverses(4, arena.resource());
+            allUniverses.beginArray();
+            for (size_t id = 0; id < universes.size(); ++id) {
+                const auto universe = universes.get(static_cast<int>(id));
+                if (!universe) {
+                    continue;
+                }
+                universe->universe()->write(allUniverses, arena.resource());
+                if (++written % kBulkSlice == 0) {
+                    PriorityScheduler::checkpoint();
+                }
+            }
+            allUniverses.endArray();
+
+            EncodedResponse encoded(transport.encoding, arena.resource());
+            ResponseWriter& response = encoded.writer();
+            response.beginObject();
+            response.key(kDataKey);
+            response.value(allUniverses.str());
+            response.key(kStatusKey);
+            response.value("success");
+            response.endObject();
+            send_response(call, transport, encoded);
+        } else if (format == "csv") {
+            // Combine all universes into one CSV
+            std::stringstream combined;
+            for (size_t id = 0; id < universes.size(); ++id) {
+                const auto universe = universes.get(static_cast<int>(id));
+                if (!universe) {
+                    continue;
+                }
+                if (written > 0) {
+                    combined << "\n\n"; // Add separation between universes
+                }
+                combined << universe->universe()->toCSV();
+                if (++written % kBulkSlice == 0) {
+                    PriorityScheduler::checkpoint();
+                }
+            }
+            EncodedResponse encoded(transport.encoding, arena.resource());
+            ResponseWriter& response = encoded.writer();
+            response.beginObject();
+            response.key(kDataKey);
+            response.value(combined.str());
+            response.key(kStatusKey);
+            response.value("success");
+            response.endObject();
+            send_response(call, transport, encoded);
+        }
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Export failed: ") + ex.what());
+    }
+}
+
+// Add search handler. With "maxDistance" the match is typo-tolerant and
+// answers closest first:
+//   {"term": "phantm", "maxDistance": 1, "limit": 100, "fields": [...]}
+//   -> {"matches": [{"distance": 1, "universe": {...}}, ...], "status": "success"}
+void search_universes(Call& call) {
+    static constexpr size_t kMaxLimit = 10000;
+
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        const Projection projection = parse_projection(data);
+        auto arena = RequestArena::acquire();
+        std::string searchTerm = data["term"].get<std::string>();
+
+        if (data.contains("maxDistance")) {
+            const int maxDistance = data["maxDistance"].get<int>();
+            if (maxDistance < 0 || maxDistance > FuzzyNameIndex::kMaxDistance) {
+                throw std::runtime_error("maxDistance must be between 0 and " +
+                                         std::to_string(FuzzyNameIndex::kMaxDistance));
+            }
+            const size_t limit = std::min<size_t>(data.value("limit", 100u), kMaxLimit);
+            UniverseDB& db = UniverseDB::instance();
+            const auto matches = db.fuzzySearch(searchTerm, maxDistance, limit);
+
+            EncodedResponse encoded(transport.encoding, arena.resource());
+            ResponseWriter& response = encoded.writer();
+            response.beginObject();
+            response.key(kMatchesKey);
+            response.beginArray();
+            const UniverseDB::View stored = db.view();
+            for (const auto& match : matches) {
+                const auto universe = stored.get(match.id);
+                if (!universe) {
+                    continue;  // removed after the query
+                }
+                response.beginObject();
+                response.key(kDistanceKey);
+                response.value(match.distance);
+                response.key(kUniverseKey);
+                write_universe(response, *universe, match.id, projection);
+                response.endObject();
+            }
+            response.endArray();
+            response.key(kStatusKey);
+            response.value("success");
+            response.endObject();
+            send_response(call, transport, encoded);
+            return;
+        }
+
+        // Search the stored names in place (nameMatches, as searchUniverses)
+        const UniverseDB::View universes = UniverseDB::instance().view();
+        
+        // Stream results into the response
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kUniversesKey);
+        response.beginArray();
+        for (size_t id = 0; id < universes.size(); ++id) {
+            const auto universe = universes.get(static_cast<int>(id));
+            if (universe && nameMatches(universe->getName(), searchTerm)) {
+                write_universe(response, *universe, static_cast<int>(id), projection);
+            }
+        }
+        response.endArray();
+        response.endObject();
+        
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, ex.what());
+    }
+}
+
+// Callback streaming the universe list in batches:
+//   {"batchSize": 500, "window": 4, "term": "andromeda", "fields": [...]}
+// Answers at once with the stream id. A worker then pushes batches of
+// universes to receiveUniverseBatch() in app.js, each carrying its sequence
+// number, and pauses while `window` batches are unacknowledged
+// (acknowledgeStream). Rows are read from the database as they are sent, so
+// the first batch does not wait for the rest of the list.
+void stream_universes(Call& call) {
+    static constexpr size_t kMaxBatchSize = 5000;
+    static constexpr std::uint32_t kMaxWindow = 64;
+
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        const Projection projection = parse_projection(data);
+        auto arena = RequestArena::acquire();
+
+        const size_t batchSize = std::clamp<size_t>(data.value("batchSize", 500u), 1, kMaxBatchSize);
+        const std::uint32_t window = std::clamp(data.value("window", PushChannel::kDefaultWindow), 1u, kMaxWindow);
+        std::string term = data.value("term", std::string());
+        if (!call.pusher()) {
+            throw std::runtime_error("Batches are pushed and need a transport that can push");
+        }
+
+        // Each batch reads a fresh view of the database, which also keeps its
+        // universes alive against a concurrent delete
+        struct Batch {
+            UniverseDB::View universes;
+            std::vector<int> ids;
+            int next = 0;
+        };
+        auto batch = std::make_shared<Batch>();
+        const int bound = UniverseDB::instance().getIdBound();
+        auto stream = start_push_stream(call, PriorityScheduler::Lane::Interactive, window, transport.encoding,
+            "receiveUniverseBatch",
+            [batch, bound, term = std::move(term), batchSize] {
+                batch->universes = UniverseDB::instance().view();
+                batch->ids.clear();
+                for (; batch->next < bound && batch->ids.size() < batchSize; ++batch->next) {
+                    const auto universe = batch->universes.get(batch->next);
+                    if (universe && (term.empty() || nameMatches(universe->getName(), term))) {
+                        batch->ids.push_back(batch->next);
+                    }
+                }
+                return batch->next >= bound;
+            },
+            [batch, projection](ResponseWriter& message) {
+                message.key(kUniversesKey);
+                message.beginArray();
+                for (const int id : batch->ids) {
+                    write_universe(message, *batch->universes.get(id), id, projection);
+                }
+                message.endArray();
+            });
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kStatusKey);
+        response.value("success");
+        response.key(kStreamIdKey);
+        response.value(static_cast<int>(stream.getId()));
+        response.endObject();
+        send_response(call, transport, encoded);
+        stream.begin();
+    } catch (const std::exception& ex) {
+        send_error(call, transport, std::string("Streaming failed: ") + ex.what());
+    }
+}
+
+// Callback acknowledging pushed batches: {"streamId": 3, "sequence": 7},
+// which confirms batches 0..7, or {"streamId": 3, "cancel": true}
+void acknowledge_stream(Call& call) {
+    TransportOptions transport;
+    try {
+        auto data = parse_request(call.body());
+        transport = negotiate_transport(data);
+        auto arena = RequestArena::acquire();
+
+        // Streams that already finished are not an error
+        if (auto channel = PushChannel::find(data.at("streamId").get<std::uint32_t>())) {
+            if (data.value("cancel", false)) {
+                channel->cancel();
+            } else {
+                channel->acknowledge(data.at("sequence").get<std::uint32_t>());
+            }
+        }
+
+        EncodedResponse encoded(transport.encoding, arena.resource());
+        ResponseWriter& response = encoded.writer();
+        response.beginObject();
+        response.key(kStatusKey);
+        response.value("success");
+        response.endObject();
+        send_response(call, transport, encoded);
+    } catch (const std::exception& ex) {
+        send_error(call, transport, ex.what());
+    }
+}
+
+const std::vector<HandlerEntry>& handler_table() {
+    constexpr auto Interactive = PriorityScheduler::Lane::Interactive;
+    constexpr auto Bulk = PriorityScheduler::Lane::Bulk;
+    static const std::vector<HandlerEntry> table = {
+        {"createUniverse", create_universe, Interactive},
+        {"createUniverses", create_universes, Bulk},
+        {"updateUniverse", update_universe, Interactive},
+        {"previewUniverse", preview_universe, Interactive},
+        {"getUniverses", get_universes, Interactive},
+        {"deleteUniverse", delete_universe, Interactive},
+        {"exportUniverse", export_universe, Interactive},
+        {"exportAllUniverses", export_all_universes, Bulk},
+        {"searchUniverses", search_universes, Interactive},
+        {"findSimilarUniverses", find_similar_universes, Interactive},
+        {"getMetrics", get_metrics, Interactive},
+        {"getStatistics", get_statistics, Interactive},
+        {"getPresets", get_presets, Interactive},
+        {"queryEvents", query_events, Interactive},
+        {"getExpansionHistory", get_expansion_history, Interactive},
+        {"getSensitivities", get_sensitivities, Interactive},
+        {"solveInverse", solve_inverse, Bulk},
+        {"streamUniverses", stream_universes, Interactive},
+        {"acknowledgeStream", acknowledge_stream, Interactive},
+    };
+    return table;
+}
+
+const HandlerEntry* find_handler(std::string_view name) {
+    for (const auto& entry : handler_table()) {
+        if (entry.name == name) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void invoke_handler(const HandlerEntry& entry, Call& call) {
+    const auto slot = PriorityScheduler::instance().acquire(entry.lane);
+    entry.handler(call);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "PriorityScheduler.hpp"
+#include "Transport.hpp"
+#include <string_view>
+#include <vector>
+
+// Entry point of a binding. Handlers only see the Call, so the same code
+// serves the webui window and the headless HTTP server.
+using Handler = void (*)(Call& call);
+
+struct HandlerEntry {
+    std::string_view name;
+    Handler handler;
+    PriorityScheduler::Lane lane;  // bulk handlers yield to interactive ones
+};
+
+// Every handler, under the name app.js calls it by
+const std::vector<HandlerEntry>& handler_table();
+const HandlerEntry* find_handler(std::string_view name);
+// Run the handler once its lane admits it
+void invoke_handler(const HandlerEntry& entry, Call& call);
+// Drop per-client state (previews, expansion streams) once the window or
+// connection behind Call::client() is gone
+void release_client(size_t client);
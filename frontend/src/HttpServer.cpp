@@ -0,0 +1,585 @@
+#include "HttpServer.hpp"
+#include "Handlers.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+constexpr std::size_t kMaxHeaderSize = 64 << 10;
+constexpr std::size_t kReadChunk = 64 << 10;
+constexpr int kMaxEvents = 128;
+
+// epoll tags for the two non-connection descriptors of a loop
+constexpr std::uint64_t kListenerTag = 0;
+constexpr std::uint64_t kWakeupTag = 1;
+constexpr std::uint64_t kCompletionTag = 2;
+
+std::atomic<std::size_t> next_client{1};
+
+[[noreturn]] void throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+bool equals_ignore_case(std::string_view a, std::string_view b) {
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) {
+               return (x | 0x20) == (y | 0x20);
+           });
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) text.remove_prefix(1);
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) text.remove_suffix(1);
+    return text;
+}
+
+void append_response(std::string& out, std::string_view status, std::string_view contentType,
+                     std::string_view body, bool close) {
+    char length[24];
+    auto written = std::to_chars(length, length + sizeof(length), body.size());
+    out.append("HTTP/1.1 ").append(status);
+    out.append("\r\nContent-Type: ").append(contentType);
+    out.append("\r\nContent-Length: ").append(length, written.ptr);
+    if (close) {
+        out.append("\r\nConnection: close");
+    }
+    out.append("\r\n\r\n").append(body);
+}
+
+void append_error(std::string& out, std::string_view status, std::string_view message, bool close) {
+    JsonWriter writer;
+    writer.beginObject();
+    writer.key("message");
+    writer.value(message);
+    writer.key("status");
+    writer.value("error");
+    writer.endObject();
+    append_response(out, status, "application/json", writer.str(), close);
+}
+
+// A handler invocation arriving over HTTP. The response is written straight
+// into the connection's output buffer.
+class HttpCall final : public Call {
+public:
+    HttpCall(std::string_view content, std::size_t clientId, std::string& out, bool close)
+        : content(content), clientId(clientId), out(out), close(close) {}
+
+    std::string_view body() const override { return content; }
+
+    void respond(const TransportOptions& transport, EncodedResponse& response) override {
+        switch (transport.encoding) {
+            case Encoding::Json:
+                append_response(out, "200 OK", "application/json", response.finish(), close);
+                break;
+            case Encoding::Cbor:
+                append_response(out, "200 OK", "application/cbor", response.bytes(), close);
+                break;
+            case Encoding::MessagePack:
+                append_response(out, "200 OK", "application/msgpack", response.bytes(), close);
+                break;
+        }
+        responded = true;
+    }
+
+    // There is no page to push to
+    Pusher pusher() const override { return {}; }
+    std::size_t client() const override { return clientId; }
+
+    bool hasResponded() const { return responded; }
+
+private:
+    std::string_view content;
+    std::size_t clientId;
+    std::string& out;
+    bool close;
+    bool responded = false;
+};
+
+// Run a handler and append its response, or a 500 when it failed to answer
+void run_call(const HandlerEntry& entry, std::string_view body, std::size_t client, std::string& out,
+              bool close) {
+    HttpCall call(body, client, out, close);
+    try {
+        entry.handler(call);
+    } catch (const std::exception& ex) {
+        // Handlers report their own errors; this only catches escapes
+        if (!call.hasResponded()) {
+            append_error(out, "500 Internal Server Error", ex.what(), close);
+        }
+        return;
+    }
+    if (!call.hasResponded()) {
+        append_error(out, "500 Internal Server Error", "Handler did not respond", close);
+    }
+}
+
+// Responses of bulk calls, produced on scheduler workers and handed back to
+// the loop owning the connection through an eventfd in its epoll set. Jobs
+// share it, so one that outlives its loop still has somewhere to post.
+class Completions {
+public:
+    struct Response {
+        int fd;
+        std::size_t client;  // the fd may have been reused by then
+        std::string bytes;
+    };
+
+    Completions() : event(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {
+        if (event < 0) {
+            throw_errno("eventfd");
+        }
+    }
+    ~Completions() { ::close(event); }
+    Completions(const Completions&) = delete;
+    Completions& operator=(const Completions&) = delete;
+
+    int fd() const { return event; }
+
+    void post(Response response) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ready.push_back(std::move(response));
+        }
+        const std::uint64_t one = 1;
+        [[maybe_unused]] auto ignored = ::write(event, &one, sizeof(one));
+    }
+
+    std::vector<Response> take() {
+        std::uint64_t count;
+        [[maybe_unused]] auto ignored = ::read(event, &count, sizeof(count));
+        std::lock_guard<std::mutex> lock(mutex);
+        return std::exchange(ready, {});
+    }
+
+private:
+    const int event;
+    std::mutex mutex;
+    std::vector<Response> ready;
+};
+}
+
+struct HttpServer::Connection {
+    int fd;
+    std::size_t client;
+    std::string in;
+    std::string out;
+    std::size_t written = 0;  // bytes of out already sent
+    bool closing = false;     // close once out is flushed
+    bool writable = true;     // false while waiting for EPOLLOUT
+    // A bulk call is running; requests after it wait for its response
+    bool waiting = false;
+    bool inputClosed = false;  // the peer sent everything it will
+    bool closed = false;       // fd closed; later events of the batch are stale
+    std::uint32_t watched = EPOLLIN | EPOLLRDHUP;
+
+    // The bulk call process() stopped at, for the loop to submit
+    const HandlerEntry* deferred = nullptr;
+    std::string deferredBody;
+    bool deferredClose = false;
+
+    // Answer every complete request in the input buffer, in order, up to
+    // the first bulk call
+    void process(const Options& options);
+    // Send as much output as the socket takes. False once the connection
+    // should be closed: on errors, or when closing, fully flushed and not
+    // waiting for a bulk response.
+    bool flush(int epoll);
+    // Update the epoll interest to the connection's state
+    void watch(int epoll);
+};
+
+void HttpServer::Connection::process(const Options& options) {
+    std::size_t offset = 0;
+    while (!closing && !waiting) {
+        const std::string_view pending = std::string_view(in).substr(offset);
+        const std::size_t headerEnd = pending.find("\r\n\r\n");
+        if (headerEnd == std::string_view::npos) {
+            if (pending.size() > kMaxHeaderSize) {
+                append_error(out, "431 Request Header Fields Too Large", "Request header too large", true);
+                closing = true;
+            }
+            break;
+        }
+
+        // Request line: METHOD SP target SP HTTP/1.x
+        const std::string_view head = pending.substr(0, headerEnd);
+        std::size_t lineEnd = head.find("\r\n");
+        const std::string_view requestLine = head.substr(0, lineEnd);
+        const std::size_t methodEnd = requestLine.find(' ');
+        const std::size_t targetEnd = requestLine.rfind(' ');
+        if (methodEnd == std::string_view::npos || targetEnd <= methodEnd) {
+            append_error(out, "400 Bad Request", "Malformed request line", true);
+            closing = true;
+            break;
+        }
+        const std::string_view method = requestLine.substr(0, methodEnd);
+        std::string_view target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+        const std::string_view version = requestLine.substr(targetEnd + 1);
+        bool close = version == "HTTP/1.0";
+
+        std::size_t contentLength = 0;
+        bool hasLength = false;
+        bool badLength = false;
+        bool chunked = false;
+        std::string_view acceptEncoding;
+        while (lineEnd != std::string_view::npos) {
+            const std::size_t start = lineEnd + 2;
+            lineEnd = head.find("\r\n", start);
+            const std::string_view line = head.substr(start, lineEnd == std::string_view::npos ? lineEnd : lineEnd - start);
+            const std::size_t colon = line.find(':');
+            if (colon == std::string_view::npos) {
+                continue;
+            }
+            const std::string_view name = line.substr(0, colon);
+            const std::string_view value = trim(line.substr(colon + 1));
+            if (equals_ignore_case(name, "Content-Length")) {
+                // Digits only, and repeated headers must agree
+                std::size_t length = 0;
+                const auto parsed = std::from_chars(value.data(), value.data() + value.size(), length);
+                badLength = badLength || parsed.ec != std::errc() || parsed.ptr != value.data() + value.size() ||
+                            (hasLength && length != contentLength);
+                contentLength = length;
+                hasLength = true;
+            } else if (equals_ignore_case(name, "Connection")) {
+                if (equals_ignore_case(value, "close")) {
+                    close = true;
+                } else if (equals_ignore_case(value, "keep-alive")) {
+                    close = false;
+                }
+            } else if (equals_ignore_case(name, "Transfer-Encoding")) {
+                chunked = !equals_ignore_case(value, "identity");
+            } else if (equals_ignore_case(name, "Accept-Encoding")) {
+                acceptEncoding = value;
+            }
+        }
+
+        // Guessing the length would read body bytes as the next request
+        if (badLength) {
+            append_error(out, "400 Bad Request", "Invalid Content-Length", true);
+            closing = true;
+            break;
+        }
+        if (chunked) {
+            append_error(out, "501 Not Implemented", "Chunked request bodies are not supported", true);
+            closing = true;
+            break;
+        }
+        if (contentLength > options.maxRequestSize) {
+            append_error(out, "413 Payload Too Large", "Request body too large", true);
+            closing = true;
+            break;
+        }
+        const std::size_t bodyStart = headerEnd + 4;
+        if (pending.size() < bodyStart + contentLength) {
+            break;  // the rest of the body is still on its way
+        }
+        const std::string_view body = pending.substr(bodyStart, contentLength);
+        offset += bodyStart + contentLength;
+        closing = close;
+
+        constexpr std::string_view kApiPrefix = "/api/";
+        if (options.files && method == "GET" && target.substr(0, kApiPrefix.size()) != kApiPrefix) {
+            const std::string_view response = options.files(target, acceptEncoding);
+            if (response.empty()) {
+                append_error(out, "404 Not Found", "No such file", close);
+            } else {
+                out.append(response);
+            }
+            continue;
+        }
+        target = target.substr(0, target.find('?'));
+        if (target.substr(0, kApiPrefix.size()) != kApiPrefix) {
+            append_error(out, "404 Not Found", "Handlers are served under /api/", close);
+            continue;
+        }
+        if (method != "POST") {
+            append_error(out, "405 Method Not Allowed", "Handlers are called with POST", close);
+            continue;
+        }
+        const HandlerEntry* entry = find_handler(target.substr(kApiPrefix.size()));
+        if (!entry) {
+            append_error(out, "404 Not Found", "Unknown handler", close);
+            continue;
+        }
+
+        if (entry->lane == PriorityScheduler::Lane::Bulk) {
+            // Bulk work would stall every connection of this loop
+            deferred = entry;
+            deferredBody.assign(body);
+            deferredClose = close;
+            waiting = true;
+            continue;
+        }
+        const auto slot = PriorityScheduler::instance().admitInteractive();
+        run_call(*entry, body, client, out, close);
+    }
+    in.erase(0, offset);
+    if (inputClosed && !waiting) {
+        closing = true;
+    }
+}
+
+bool HttpServer::Connection::flush(int epoll) {
+    while (written < out.size()) {
+        const ssize_t sent = ::send(fd, out.data() + written, out.size() - written, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                return false;
+            }
+            writable = false;
+            watch(epoll);
+            return true;
+        }
+        written += static_cast<std::size_t>(sent);
+    }
+    out.clear();
+    written = 0;
+    writable = true;
+    if (closing && !waiting) {
+        return false;
+    }
+    watch(epoll);
+    return true;
+}
+
+void HttpServer::Connection::watch(int epoll) {
+    std::uint32_t events = writable ? 0 : EPOLLOUT;
+    // Closing connections only drain, and waiting ones read no more requests
+    if (!closing && !waiting) {
+        events |= EPOLLIN | EPOLLRDHUP;
+    }
+    if (events != watched) {
+        epoll_event event{events, {}};
+        event.data.ptr = this;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, fd, &event);
+        watched = events;
+    }
+}
+
+HttpServer::HttpServer(Options options)
+    : options(std::move(options))
+{
+    if (this->options.threads == 0) {
+        this->options.threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+HttpServer::~HttpServer() {
+    for (int fd : listeners) {
+        ::close(fd);
+    }
+    if (wakeup >= 0) {
+        ::close(wakeup);
+    }
+}
+
+void HttpServer::start() {
+    wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup < 0) {
+        throw_errno("eventfd");
+    }
+
+    // The first socket picks the port when 0 was asked for; the others join it
+    port = options.port;
+    for (unsigned i = 0; i < options.threads; ++i) {
+        const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            throw_errno("socket");
+        }
+        listeners.push_back(fd);
+        const int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        if (::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on)) < 0) {
+            throw_errno("SO_REUSEPORT");
+        }
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(port);
+        if (::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            throw_errno("bind");
+        }
+        if (::listen(fd, SOMAXCONN) < 0) {
+            throw_errno("listen");
+        }
+        if (port == 0) {
+            socklen_t length = sizeof(address);
+            ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length);
+            port = ntohs(address.sin_port);
+        }
+    }
+}
+
+void HttpServer::run() {
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < listeners.size(); ++i) {
+        workers.emplace_back(&HttpServer::loop, this, i);
+    }
+    loop(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void HttpServer::stop() {
+    stopping = true;
+    if (wakeup >= 0) {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] auto ignored = ::write(wakeup, &one, sizeof(one));
+    }
+}
+
+void HttpServer::loop(std::size_t worker) {
+    const int epoll = ::epoll_create1(EPOLL_CLOEXEC);
+    if (epoll < 0) {
+        throw_errno("epoll_create1");
+    }
+    epoll_event event{EPOLLIN, {}};
+    event.data.u64 = kListenerTag;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listeners[worker], &event);
+    // Level-triggered, and never read, so it wakes every loop
+    event.data.u64 = kWakeupTag;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, wakeup, &event);
+    const auto completions = std::make_shared<Completions>();
+    event.data.u64 = kCompletionTag;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, completions->fd(), &event);
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections;
+    // A completion can close a connection that a later entry of the same
+    // epoll batch still points at, so closed ones are kept until the batch ends
+    std::vector<std::unique_ptr<Connection>> closedConnections;
+    auto closeConnection = [&](Connection* connection) {
+        ::close(connection->fd);  // also removes it from the epoll set
+        connection->closed = true;
+        release_client(connection->client);
+        auto it = connections.find(connection->fd);
+        closedConnections.push_back(std::move(it->second));
+        connections.erase(it);
+    };
+    // Hand the bulk call a connection stopped at to the scheduler's workers
+    auto submitDeferred = [&](Connection* connection) {
+        const HandlerEntry* entry = std::exchange(connection->deferred, nullptr);
+        if (!entry) {
+            return;
+        }
+        PriorityScheduler::instance().submitBulk(
+            [entry, body = std::move(connection->deferredBody), close = connection->deferredClose,
+             fd = connection->fd, client = connection->client, completions] {
+                std::string out;
+                run_call(*entry, body, client, out, close);
+                completions->post({fd, client, std::move(out)});
+            });
+        connection->deferredBody.clear();
+    };
+
+    epoll_event events[kMaxEvents];
+    while (!stopping) {
+        const int count = ::epoll_wait(epoll, events, kMaxEvents, -1);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.u64 == kWakeupTag) {
+                continue;
+            }
+            if (events[i].data.u64 == kCompletionTag) {
+                for (auto& response : completions->take()) {
+                    auto it = connections.find(response.fd);
+                    if (it == connections.end() || it->second->client != response.client) {
+                        continue;  // closed while the call ran
+                    }
+                    Connection* connection = it->second.get();
+                    connection->out.append(response.bytes);
+                    connection->waiting = false;
+                    connection->process(options);
+                    submitDeferred(connection);
+                    if (!connection->flush(epoll)) {
+                        closeConnection(connection);
+                    }
+                }
+                continue;
+            }
+            if (events[i].data.u64 == kListenerTag) {
+                for (;;) {
+                    const int fd = ::accept4(listeners[worker], nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0) {
+                        break;
+                    }
+                    const int on = 1;
+                    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                    auto connection = std::make_unique<Connection>();
+                    connection->fd = fd;
+                    connection->client = next_client.fetch_add(1, std::memory_order_relaxed);
+                    epoll_event added{EPOLLIN | EPOLLRDHUP, {}};
+                    added.data.ptr = connection.get();
+                    epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &added);
+                    connections.emplace(fd, std::move(connection));
+                }
+                continue;
+            }
+
+            auto* connection = static_cast<Connection*>(events[i].data.ptr);
+            if (connection->closed) {
+                continue;
+            }
+            // A waiting connection watches no input, so a hang-up would be
+            // reported until the bulk response; it could not be sent anyway
+            if ((events[i].events & EPOLLERR) || ((events[i].events & EPOLLHUP) && connection->waiting)) {
+                closeConnection(connection);
+                continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+                bool peerClosed = false;
+                for (;;) {
+                    const std::size_t size = connection->in.size();
+                    connection->in.resize(size + kReadChunk);
+                    const ssize_t received = ::recv(connection->fd, connection->in.data() + size, kReadChunk, 0);
+                    connection->in.resize(size + std::max<ssize_t>(received, 0));
+                    if (received > 0) {
+                        continue;
+                    }
+                    if (received < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    peerClosed = received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+                    break;
+                }
+                // Answer what was received even if the peer half-closed
+                connection->inputClosed = connection->inputClosed || peerClosed;
+                connection->process(options);
+                submitDeferred(connection);
+            }
+            if (!connection->flush(epoll)) {
+                closeConnection(connection);
+            }
+        }
+        closedConnections.clear();
+    }
+
+    for (auto& [fd, connection] : connections) {
+        ::close(fd);
+    }
+    ::close(epoll);
+}
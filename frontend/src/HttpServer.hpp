@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// Headless HTTP/1.1 front end for the handlers, for scripting and load
+// tests. It only listens on 127.0.0.1.
+//
+//   POST /api/<handler>   body: the JSON argument app.js would pass
+//   GET  /<file>          the UI files, when Options::files is set
+//
+// The response body is the handler's reply in the negotiated encoding
+// (application/json, application/cbor or application/msgpack); handler
+// errors keep the {"message", "status": "error"} body of the page bindings.
+// Connections are kept alive and pipelined requests are answered in order.
+//
+// Every worker thread runs its own epoll loop over its own SO_REUSEPORT
+// listening socket, so the kernel spreads connections over the threads and
+// no connection state is shared. Interactive handlers run on the loop
+// thread. Bulk ones run on the PriorityScheduler's bulk workers, so they
+// never stall a loop; their connection reads no further requests until the
+// response is back, which keeps pipelined responses in order.
+class HttpServer {
+public:
+    struct Options {
+        std::uint16_t port = 8080;  // 0 picks a free port
+        unsigned threads = 0;       // 0 uses the hardware concurrency
+        std::size_t maxRequestSize = 16 << 20;
+        // Complete response for a GET target outside /api/ given the
+        // request's Accept-Encoding value; empty for 404
+        std::function<std::string_view(std::string_view target, std::string_view acceptEncoding)> files;
+    };
+
+    explicit HttpServer(Options options);
+    ~HttpServer();
+
+    HttpServer(const HttpServer&) = delete;
+    HttpServer& operator=(const HttpServer&) = delete;
+
+    // Bind the listening sockets; throws std::system_error
+    void start();
+    // Port actually bound, once started
+    std::uint16_t getPort() const { return port; }
+    // Serve on the calling thread plus threads - 1 more until stop()
+    void run();
+    // Callable from any thread
+    void stop();
+
+private:
+    struct Connection;
+
+    void loop(std::size_t worker);
+
+    Options options;
+    std::uint16_t port = 0;
+    std::vector<int> listeners;
+    int wakeup = -1;  // eventfd, readable once stop() was called
+    std::atomic<bool> stopping{false};
+};
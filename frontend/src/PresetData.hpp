@@ -0,0 +1,9 @@
+#pragma once
+
+#include <string_view>
+
+// The complete getPresets response in each encoding, serialized from
+// PresetCatalog at build time by cmake/EmbedPresets.cpp
+extern const std::string_view preset_response_json;
+extern const std::string_view preset_response_cbor;
+extern const std::string_view preset_response_msgpack;
@@ -0,0 +1,61 @@
+#include "Projection.hpp"
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+struct FieldName {
+    std::string_view name;
+    std::uint32_t mask;
+};
+
+constexpr std::uint32_t bit(UniverseField field) {
+    return static_cast<std::uint32_t>(field);
+}
+
+constexpr std::uint32_t kMilestoneFields =
+    bit(UniverseField::MilestoneAssetId) | bit(UniverseField::MilestoneDescription) |
+    bit(UniverseField::MilestoneTimestamp) | bit(UniverseField::MilestoneType);
+
+constexpr FieldName kFieldNames[] = {
+    {"darkEnergyDensity", bit(UniverseField::DarkEnergyDensity)},
+    {"darkEnergyW", bit(UniverseField::DarkEnergyW)},
+    {"ending", bit(UniverseField::Ending)},
+    {"hubbleConstant", bit(UniverseField::HubbleConstant)},
+    {"id", bit(UniverseField::Id)},
+    {"matterAntimatterRatio", bit(UniverseField::MatterAntimatterRatio)},
+    {"matterDensity", bit(UniverseField::MatterDensity)},
+    {"name", bit(UniverseField::Name)},
+    {"milestones", kMilestoneFields},
+    {"milestones.assetId", bit(UniverseField::MilestoneAssetId)},
+    {"milestones.description", bit(UniverseField::MilestoneDescription)},
+    {"milestones.timestamp", bit(UniverseField::MilestoneTimestamp)},
+    {"milestones.type", bit(UniverseField::MilestoneType)},
+};
+}
+
+bool Projection::hasMilestones() const {
+    return (mask & kMilestoneFields) != 0;
+}
+
+Projection parse_projection(const nlohmann::json& request) {
+    if (!request.is_object() || !request.contains("fields")) {
+        return Projection::all();
+    }
+
+    std::uint32_t mask = 0;
+    for (const auto& field : request["fields"]) {
+        const auto& name = field.get_ref<const std::string&>();
+        bool known = false;
+        for (const auto& entry : kFieldNames) {
+            if (entry.name == name) {
+                mask |= entry.mask;
+                known = true;
+                break;
+            }
+        }
+        if (!known) {
+            throw std::runtime_error("Unknown field: " + name);
+        }
+    }
+    return Projection(mask);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+
+// Fields of a universe object in list responses
+enum class UniverseField : std::uint32_t {
+    DarkEnergyDensity = 1u << 0,
+    DarkEnergyW = 1u << 1,
+    Ending = 1u << 2,
+    HubbleConstant = 1u << 3,
+    Id = 1u << 4,
+    MatterAntimatterRatio = 1u << 5,
+    MatterDensity = 1u << 6,
+    Name = 1u << 7,
+    MilestoneAssetId = 1u << 8,
+    MilestoneDescription = 1u << 9,
+    MilestoneTimestamp = 1u << 10,
+    MilestoneType = 1u << 11
+};
+
+// Set of fields a call asked for
+class Projection {
+public:
+    Projection() = default;
+    explicit Projection(std::uint32_t mask) : mask(mask) {}
+
+    static Projection all() { return Projection(~0u); }
+
+    bool has(UniverseField field) const { return (mask & static_cast<std::uint32_t>(field)) != 0; }
+    // True if any milestone field is selected
+    bool hasMilestones() const;
+
+private:
+    std::uint32_t mask = 0;
+};
+
+// Read the optional "fields" array of a request, e.g.
+//   "fields": ["id", "name", "ending", "milestones.timestamp"]
+// "milestones" selects every milestone field. Without "fields", all fields
+// are returned, as before projections existed.
+Projection parse_projection(const nlohmann::json& request);
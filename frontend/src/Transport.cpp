@@ -0,0 +1,115 @@
+#include "Transport.hpp"
+#include "RequestArena.hpp"
+#include <stdexcept>
+
+nlohmann::json parse_request(std::string_view body) {
+    if (body.empty()) {
+        return nlohmann::json::object();
+    }
+    return nlohmann::json::parse(body);
+}
+
+TransportOptions negotiate_transport(const nlohmann::json& request) {
+    TransportOptions transport;
+    if (!request.is_object()) {
+        return transport;
+    }
+
+    if (request.contains("encoding")) {
+        const auto name = request["encoding"].get<std::string>();
+        if (name == "cbor") {
+            transport.encoding = Encoding::Cbor;
+        } else if (name == "msgpack") {
+            transport.encoding = Encoding::MessagePack;
+        } else if (name != "json") {
+            throw std::runtime_error("Unsupported encoding: " + name);
+        }
+    }
+
+    if (request.contains("channel") && request["channel"].get<std::string>() == "raw") {
+        transport.rawChannel = transport.encoding != Encoding::Json;
+        transport.requestId = request.value("requestId", 0u);
+    }
+    return transport;
+}
+
+EncodedResponse::EncodedResponse(Encoding encoding, std::pmr::memory_resource* resource)
+    : encoding(encoding)
+    , resource(resource)
+    , json(-1, resource)
+    , binary(encoding == Encoding::MessagePack ? BinaryWriter::Format::MessagePack
+                                               : BinaryWriter::Format::Cbor,
+             resource)
+    , text(resource)
+{}
+
+EncodedResponse::EncodedResponse(Encoding encoding, std::string_view encoded,
+                                 std::pmr::memory_resource* resource)
+    : EncodedResponse(encoding, resource)
+{
+    preencoded = encoded;
+}
+
+ResponseWriter& EncodedResponse::writer() {
+    if (encoding == Encoding::Json) {
+        return json;
+    }
+    return binary;
+}
+
+std::string_view EncodedResponse::finish() {
+    if (encoding == Encoding::Json) {
+        return preencoded ? *preencoded : json.str();
+    }
+    if (text.empty()) {
+        base64_encode(bytes(), text);
+    }
+    return text;
+}
+
+void send_response(Call& call, const TransportOptions& transport, EncodedResponse& response) {
+    call.respond(transport, response);
+}
+
+void send_error(Call& call, const TransportOptions& transport, std::string_view message) {
+    auto arena = RequestArena::acquire();
+    EncodedResponse encoded(transport.encoding, arena.resource());
+    ResponseWriter& response = encoded.writer();
+    response.beginObject();
+    response.key("message");
+    response.value(message);
+    response.key("status");
+    response.value("error");
+    response.endObject();
+    send_response(call, transport, encoded);
+}
+
+void base64_encode(std::string_view bytes, std::pmr::string& encoded) {
+    static constexpr char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    encoded.reserve(encoded.size() + (bytes.size() + 2) / 3 * 4);
+
+    size_t i = 0;
+    for (; i + 2 < bytes.size(); i += 3) {
+        const auto chunk = (static_cast<unsigned char>(bytes[i]) << 16) |
+                           (static_cast<unsigned char>(bytes[i + 1]) << 8) |
+                           static_cast<unsigned char>(bytes[i + 2]);
+        encoded.push_back(alphabet[(chunk >> 18) & 0x3F]);
+        encoded.push_back(alphabet[(chunk >> 12) & 0x3F]);
+        encoded.push_back(alphabet[(chunk >> 6) & 0x3F]);
+        encoded.push_back(alphabet[chunk & 0x3F]);
+    }
+
+    const size_t remaining = bytes.size() - i;
+    if (remaining > 0) {
+        auto chunk = static_cast<unsigned char>(bytes[i]) << 16;
+        if (remaining == 2) {
+            chunk |= static_cast<unsigned char>(bytes[i + 1]) << 8;
+        }
+        encoded.push_back(alphabet[(chunk >> 18) & 0x3F]);
+        encoded.push_back(alphabet[(chunk >> 12) & 0x3F]);
+        encoded.push_back(remaining == 2 ? alphabet[(chunk >> 6) & 0x3F] : '=');
+        encoded.push_back('=');
+    }
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "BinaryWriter.hpp"
+#include "JsonWriter.hpp"
+#include <nlohmann/json.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Wire encodings a binding can answer with
+enum class Encoding {
+    Json,
+    Cbor,
+    MessagePack
+};
+
+// How a binding should deliver its response
+struct TransportOptions {
+    Encoding encoding = Encoding::Json;
+    // Push binary payloads over webui's raw channel instead of base64 text
+    bool rawChannel = false;
+    // Echoed in front of raw payloads so the page can match them to calls
+    std::uint32_t requestId = 0;
+};
+
+// Parse a binding argument; calls made without arguments yield an empty object
+nlohmann::json parse_request(std::string_view body);
+
+// Read the optional transport fields of a request:
+//   "encoding": "json" (default), "cbor" or "msgpack"
+//   "channel": "text" (default) or "raw", together with "requestId"
+TransportOptions negotiate_transport(const nlohmann::json& request);
+
+// Response document in the negotiated encoding. All buffers, including the
+// base64 text, come from the given memory resource (usually a request arena).
+class EncodedResponse {
+public:
+    explicit EncodedResponse(Encoding encoding,
+                             std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+    // Response encoded ahead of time, e.g. at build time: JSON text or the
+    // bytes of a binary encoding, which must outlive the response.
+    // writer() must not be used.
+    EncodedResponse(Encoding encoding, std::string_view encoded,
+                    std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    ResponseWriter& writer();
+    Encoding getEncoding() const { return encoding; }
+    std::pmr::memory_resource* getResource() const { return resource; }
+
+    // Payload as text: JSON as-is, binary encodings base64-encoded.
+    // The view stays valid as long as the response.
+    std::string_view finish();
+    // Encoded bytes of a binary response
+    std::string_view bytes() const { return preencoded ? *preencoded : binary.bytes(); }
+
+private:
+    Encoding encoding;
+    std::pmr::memory_resource* resource;
+    JsonWriter json;
+    BinaryWriter binary;
+    std::pmr::string text;
+    std::optional<std::string_view> preencoded;
+};
+
+// Sends an unsolicited message to the caller: the name of the receiving
+// function in app.js and the encoded payload. Copyable, so worker threads
+// can keep pushing after the call has returned.
+using Pusher = std::function<void(const char* function, std::string_view bytes)>;
+
+// One invocation of a handler, independent of the transport it came in on
+class Call {
+public:
+    virtual ~Call() = default;
+
+    // The JSON argument; empty for calls made without one
+    virtual std::string_view body() const = 0;
+    // Deliver the finished response. Called at most once, before the
+    // handler returns.
+    virtual void respond(const TransportOptions& transport, EncodedResponse& response) = 0;
+    // Empty when the transport cannot push
+    virtual Pusher pusher() const = 0;
+    // Identifies the caller, e.g. to coalesce its requests
+    virtual std::size_t client() const = 0;
+};
+
+// Return a finished response to the caller
+void send_response(Call& call, const TransportOptions& transport, EncodedResponse& response);
+
+// Send {"message": ..., "status": "error"} using the negotiated transport
+void send_error(Call& call, const TransportOptions& transport, std::string_view message);
+
+// Append the base64 encoding of bytes to out
+void base64_encode(std::string_view bytes, std::pmr::string& out);
@@ -1,290 +1,135 @@
 #include "webui.hpp"
-#include <string>
-#include <nlohmann/json.hpp>
-#include <vector>
-#include <iostream>
-#include "SimulatedUniverse.hpp"
-#include "Timeline.hpp"
-#include "UniverseParameters.hpp"
+#include "Handlers.hpp"
+#include "HttpServer.hpp"
+#include "EmbeddedAssets.hpp"
 #include "UniverseDB.hpp"
-#include "UniverseValidator.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
 
-using json = nlohmann::json;
+// A binding call from the page. Binary responses on the raw channel are
+// pushed to receiveBinaryResponse() in app.js, prefixed with the 4-byte
+// big-endian request id, and the call itself returns an empty string.
+class WebuiCall final : public Call {
+public:
+    explicit WebuiCall(webui::window::event* e) : e(e) {}
 
-// Convert milestone type to string
-std::string getMilestoneTypeString(int type) {
-    switch (type) {
-        case 0: return "BIG_BANG";
-        case 1: return "INFLATION";
-        case 2: return "PARTICLE_ERA";
-        case 3: return "NUCLEOSYNTHESIS";
-        case 4: return "RECOMBINATION";
-        case 5: return "DARK_AGES";
-        case 6: return "FIRST_STARS";
-        case 7: return "GALAXY_FORMATION";
-        case 8: return "ACCELERATED_EXPANSION";
-        case 9: return "BIG_RIP";
-        case 10: return "HEAT_DEATH";
-        case 11: return "BIG_CRUNCH";
-        default: return "UNKNOWN";
-    }
-}
+    std::string_view body() const override { return e->get_string(); }
 
-// Convert SimulatedUniverse to JSON
-json universe_to_json(SimulatedUniverse& universe, int id) {
-    json j;
-    j["id"] = id;
-    j["name"] = universe.getName();
-    
-    // Create JSON directly from universe parameters
-    j["matterDensity"] = universe.getMatterDensity();
-    j["darkEnergyDensity"] = universe.getDarkEnergyDensity();
-    j["hubbleConstant"] = universe.getHubbleConstant();
-    j["matterAntimatterRatio"] = universe.getMatterAntimatterRatio();
-    j["darkEnergyW"] = universe.getDarkEnergyW();
-    
-    // Generate timeline and log details
-    std::cout << "Generating timeline for universe " << id << " (" << universe.getName() << ")" << std::endl;
-    auto timeline = universe.generateTimeline();
-    auto timelineJson = timeline->toJson();
-    std::cout << "Timeline generated with " << timelineJson["milestones"].size() 
-              << " milestones" << std::endl;
-    
-    // Convert milestone types to strings
-    json milestones = json::array();
-    for (const auto& milestone : timelineJson["milestones"]) {
-        json m = milestone;
-        m["type"] = getMilestoneTypeString(milestone["type"].get<int>());
-        milestones.push_back(m);
-        
-        // Print for verification
-        if (milestones.size() <= 3) {
-            std::cout << "Milestone " << (milestones.size() - 1) << ": " 
-                      << m["type"].get<std::string>() << " at t=" 
-                      << m["timestamp"].get<double>() << std::endl;
+    void respond(const TransportOptions& transport, EncodedResponse& response) override {
+        if (!transport.rawChannel || response.getEncoding() == Encoding::Json) {
+            e->return_string(response.finish());
+            return;
         }
+
+        const std::string_view bytes = response.bytes();
+        std::pmr::string framed(response.getResource());
+        framed.reserve(4 + bytes.size());
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            framed.push_back(static_cast<char>((transport.requestId >> shift) & 0xFF));
+        }
+        framed.append(bytes);
+
+        webui_send_raw(e->window, "receiveBinaryResponse", framed.data(), framed.size());
+        e->return_string("");
     }
-    j["milestones"] = milestones;
-    
-    return j;
-}
 
-// Callback to create a new universe
-void create_universe(webui::window::event* e) {
-    try {
-        auto data = json::parse(e->get_string());
-        
-        // Extract parameters from JSON
-        std::string name = data["name"].get<std::string>();
-        double matterDensity = data["matterDensity"].get<double>();
-        double darkEnergyDensity = data["darkEnergyDensity"].get<double>();
-        double hubbleConstant = data["hubbleConstant"].get<double>();
-        double matterAntimatterRatio = data["matterAntimatterRatio"].get<double>();
-        double darkEnergyW = data["darkEnergyW"].get<double>();
-        
-        // Create new universe with parameters
-        auto universe = std::make_unique<SimulatedUniverse>(
-            name, matterDensity, darkEnergyDensity, hubbleConstant,
-            matterAntimatterRatio, darkEnergyW
-        );
-        
-        // Generate timeline
-        auto timeline = universe->generateTimeline();
-        
-        // Store universe and get its ID
-        size_t id = UniverseDB::instance().getAllUniverses().size();
-        UniverseDB::instance().addUniverse(std::move(universe));
-        
-        // Get reference to the stored universe
-        auto& stored_universe = UniverseDB::instance().getAllUniverses()[id].get();
-        
-        // Create the response JSON
-        json response;
-        response["status"] = "success";
-        response["message"] = "Universe created successfully";
-        response["universe"] = universe_to_json(stored_universe, id);
-        
-        e->return_string(response.dump());
-        
-    } catch (const std::exception& ex) {
-        json error = {
-            {"status", "error"},
-            {"message", std::string("Error creating universe: ") + ex.what()}
+    Pusher pusher() const override {
+        const size_t window = e->window;
+        return [window](const char* function, std::string_view bytes) {
+            webui_send_raw(window, function, bytes.data(), bytes.size());
         };
-        e->return_string(error.dump());
     }
-}
 
-// Callback to delete a universe
-void delete_universe(webui::window::event* e) {
-    try {
-        json params = json::parse(e->get_string());
-        int id = params["id"].get<int>();
-        
-        std::cout << "Deleting universe " << id << std::endl;
-        
-        if (UniverseDB::instance().removeUniverse(id)) {
-            json response;
-            response["status"] = "success";
-            response["message"] = "Universe deleted successfully";
-            e->return_string(response.dump());
-        } else {
-            throw std::runtime_error("Universe not found");
-        }
-    } catch (const std::exception& ex) {
-        std::cout << "Error deleting universe: " << ex.what() << std::endl;
-        json error;
-        error["status"] = "error";
-        error["message"] = ex.what();
-        e->return_string(error.dump());
-    }
-}
+    size_t client() const override { return e->window; }
 
-// Callback to get list of universes
-void get_universes(webui::window::event* e) {
-    try {
-        json response;
-        response["status"] = "success";
-        
-        // Get all universes from the database
-        auto universes = UniverseDB::instance().getAllUniverses();
-        
-        // Convert all universes to JSON
-        json universe_list = json::array();
-        int id = 0;
-        for (auto& universe : universes) {
-            universe_list.push_back(universe_to_json(universe.get(), id++));
-        }
-        response["universes"] = universe_list;
-        
-        e->return_string(response.dump());
-    } catch (const std::exception& ex) {
-        json error;
-        error["status"] = "error";
-        error["message"] = ex.what();
-        e->return_string(error.dump());
+private:
+    webui::window::event* e;
+};
+
+// Every binding goes through here; the element is the bound name
+void dispatch_binding(webui::window::event* e) {
+    if (const HandlerEntry* entry = find_handler(e->element)) {
+        WebuiCall call(e);
+        invoke_handler(*entry, call);
     }
 }
 
-// Add new export handlers
-void export_universe(webui::window::event* e) {
-    try {
-        auto data = json::parse(e->get_string());
-        int id = data["id"].get<int>();
-        std::string format = data["format"].get<std::string>();
-        
-        std::optional<std::string> exportData;
-        if (format == "json") {
-            exportData = UniverseDB::instance().exportToJSON(id);
-        } else if (format == "csv") {
-            exportData = UniverseDB::instance().exportToCSV(id);
-        }
-        
-        if (exportData) {
-            json response = {
-                {"status", "success"},
-                {"data", *exportData}
-            };
-            e->return_string(response.dump());
-        } else {
-            throw std::runtime_error("Universe not found");
-        }
-    } catch (const std::exception& ex) {
-        json error = {
-            {"status", "error"},
-            {"message", std::string("Export failed: ") + ex.what()}
-        };
-        e->return_string(error.dump());
+// Forget the window's previews and streams when its page goes away
+void on_window_event(webui::window::event* e) {
+    if (e->event_type == webui::DISCONNECTED) {
+        release_client(e->window);
     }
 }
 
-// Add handler for exporting all universes
-void export_all_universes(webui::window::event* e) {
-    try {
-        auto data = json::parse(e->get_string());
-        std::string format = data["format"].get<std::string>();
-        
-        auto universes = UniverseDB::instance().getAllUniverses();
-        
-        if (format == "json") {
-            // Create a JSON array of all universes
-            json allUniverses = json::array();
-            for (const auto& universe : universes) {
-                std::string exportData = universe.get().toJSON();
-                allUniverses.push_back(json::parse(exportData));
-            }
-            json response = {
-                {"status", "success"},
-                {"data", allUniverses.dump(4)}
-            };
-            e->return_string(response.dump());
-        } else if (format == "csv") {
-            // Combine all universes into one CSV
-            std::stringstream combined;
-            bool first = true;
-            for (const auto& universe : universes) {
-                if (!first) {
-                    combined << "\n\n"; // Add separation between universes
-                }
-                combined << universe.get().toCSV();
-                first = false;
-            }
-            json response = {
-                {"status", "success"},
-                {"data", combined.str()}
-            };
-            e->return_string(response.dump());
+// Serve the handlers over HTTP on 127.0.0.1 instead of opening a window
+int run_headless(HttpServer::Options options) {
+    // The UI files too, for checking what the window would be sent
+    options.files = [](std::string_view target, std::string_view acceptEncoding) {
+        const EmbeddedAsset* asset = find_embedded_asset(target);
+        if (!asset) {
+            return std::string_view();
         }
-    } catch (const std::exception& ex) {
-        json error = {
-            {"status", "error"},
-            {"message", std::string("Export failed: ") + ex.what()}
-        };
-        e->return_string(error.dump());
-    }
+        const EmbeddedResponse& response =
+            select_embedded_response(*asset, target, accepts_gzip(acceptEncoding));
+        return std::string_view(reinterpret_cast<const char*>(response.data), response.size);
+    };
+    HttpServer server(options);
+    server.start();
+    std::cout << "Serving " << handler_table().size() << " handlers on http://127.0.0.1:"
+              << server.getPort() << "/api/" << std::endl;
+    server.run();
+    return 0;
 }
 
-// Add search handler
-void search_universes(webui::window::event* e) {
-    try {
-        auto data = json::parse(e->get_string());
-        std::string searchTerm = data["term"].get<std::string>();
-        
-        // Search universes
-        auto universes = UniverseDB::instance().searchUniverses(searchTerm);
-        
-        // Convert results to JSON
-        json response;
-        response["status"] = "success";
-        json universe_list = json::array();
-        int id = 0;
-        for (auto& universe : universes) {
-            universe_list.push_back(universe_to_json(universe.get(), id++));
+int main(int argc, char** argv) {
+    bool headless = false;
+    HttpServer::Options options;
+    std::string snapshot;
+    bool compact = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--port" && i + 1 < argc) {
+            options.port = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+        } else if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--snapshot" && i + 1 < argc) {
+            snapshot = argv[++i];
+        } else if (arg == "--compact") {
+            compact = true;
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                      << " [--headless [--port N] [--threads N]] [--snapshot /shm-name] [--compact]" << std::endl;
+            return 2;
         }
-        response["universes"] = universe_list;
-        
-        e->return_string(response.dump());
-    } catch (const std::exception& ex) {
-        json error;
-        error["status"] = "error";
-        error["message"] = ex.what();
-        e->return_string(error.dump());
     }
-}
+    if (compact) {
+        // Packed records for very large ensembles (CompactUniverseStore)
+        UniverseDB::instance().setStorage(UniverseDB::Storage::Compact);
+    }
+    if (!snapshot.empty()) {
+        // Analysis processes attach with SharedSnapshotReader
+        UniverseDB::instance().publishSnapshots(snapshot);
+    }
+    if (headless) {
+        return run_headless(options);
+    }
 
-int main() {
     webui::window win;
     
-    // Set the base directory for UI files
-    win.set_root_folder("../frontend/ui");
+    // Serve the UI from the assets compiled into the executable
+    win.set_file_handler(serve_embedded_asset);
     
     // Bind backend functions
-    win.bind("createUniverse", create_universe);
-    win.bind("getUniverses", get_universes);
-    win.bind("deleteUniverse", delete_universe);
-    win.bind("exportUniverse", export_universe);
-    win.bind("exportAllUniverses", export_all_universes);
-    win.bind("searchUniverses", search_universes);  // Add new binding
+    for (const auto& entry : handler_table()) {
+        win.bind(entry.name, dispatch_binding);
+    }
+    // An empty element binds every event of the window
+    win.bind("", on_window_event);
     
     // Show the UI starting with index.html
     win.show("index.html");
@@ -292,4 +137,4 @@ int main() {
     // Wait for the window
     webui::wait();
     return 0;
-} 
\ No newline at end of file
+}
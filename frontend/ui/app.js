@@ -52,8 +52,7 @@ function hideTimeline() {
 
 async function loadUniverseList() {
     try {
-        const response = await webui.call('getUniverses');
-        const data = JSON.parse(response);
+        const data = await callBackend('getUniverses', { fields: LIST_FIELDS });
         
         if (data.status === 'success') {
             const universeList = document.getElementById('universe-list');
@@ -138,6 +137,233 @@ function getMilestoneTitle(type) {
 
 let currentUniverseId = null;  // Add this at the top of the file
 
+// Wire encoding requested from the backend: 'cbor', 'msgpack' or 'json'.
+const TRANSPORT_ENCODING = 'cbor';
+// Receive binary responses as raw bytes through webui's binary channel.
+// When false they arrive as base64 text in the call's return value.
+const TRANSPORT_RAW_CHANNEL = true;
+
+// Fields rendered by the universe list; the backend skips everything else.
+// The detail view requests the full objects.
+const LIST_FIELDS = ['id', 'name', 'ending', 'matterDensity', 'darkEnergyDensity', 'hubbleConstant'];
+
+const pendingBinaryResponses = new Map();
+let nextRequestId = 1;
+
+// Invoked by the backend with a 4-byte big-endian request id plus payload
+function receiveBinaryResponse(data) {
+    const view = new DataView(data.buffer, data.byteOffset, data.byteLength);
+    const requestId = view.getUint32(0);
+    const resolve = pendingBinaryResponses.get(requestId);
+    if (resolve) {
+        pendingBinaryResponses.delete(requestId);
+        resolve(data.subarray(4));
+    }
+}
+
+// Call a backend binding and decode its response
+async function callBackend(name, payload = {}) {
+    const request = { ...payload, encoding: TRANSPORT_ENCODING };
+    if (TRANSPORT_ENCODING === 'json' || !TRANSPORT_RAW_CHANNEL) {
+        const response = await webui.call(name, JSON.stringify(request));
+        return decodeResponse(response, TRANSPORT_ENCODING);
+    }
+
+    const requestId = nextRequestId++;
+    const payloadBytes = new Promise(resolve => pendingBinaryResponses.set(requestId, resolve));
+    const response = await webui.call(name, JSON.stringify({ ...request, channel: 'raw', requestId }));
+    if (response) {
+        // Rejected before the transport was negotiated: plain JSON error
+        pendingBinaryResponses.delete(requestId);
+        return JSON.parse(response);
+    }
+    return decodeBinary(await payloadBytes, TRANSPORT_ENCODING);
+}
+
+function decodeResponse(text, encoding) {
+    if (encoding === 'json') {
+        return JSON.parse(text);
+    }
+    const binary = atob(text);
+    const bytes = new Uint8Array(binary.length);
+    for (let i = 0; i < binary.length; i++) {
+        bytes[i] = binary.charCodeAt(i);
+    }
+    return decodeBinary(bytes, encoding);
+}
+
+function decodeBinary(bytes, encoding) {
+    return encoding === 'cbor' ? decodeCbor(bytes) : decodeMsgpack(bytes);
+}
+
+const utf8Decoder = new TextDecoder();
+
+// Minimal CBOR (RFC 8949) decoder for the subset the backend emits,
+// including indefinite-length arrays and maps
+function decodeCbor(bytes) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    const BREAK = Symbol('break');
+    let offset = 0;
+
+    const readLength = (info) => {
+        let value;
+        switch (info) {
+            case 24: value = view.getUint8(offset); offset += 1; return value;
+            case 25: value = view.getUint16(offset); offset += 2; return value;
+            case 26: value = view.getUint32(offset); offset += 4; return value;
+            case 27: value = Number(view.getBigUint64(offset)); offset += 8; return value;
+            case 31: return -1; // indefinite length
+            default:
+                if (info < 24) return info;
+                throw new Error('Invalid CBOR length');
+        }
+    };
+
+    const readHalf = () => {
+        const half = view.getUint16(offset);
+        offset += 2;
+        const exponent = (half >> 10) & 0x1f;
+        const mantissa = half & 0x3ff;
+        const sign = half & 0x8000 ? -1 : 1;
+        if (exponent === 0) return sign * Math.pow(2, -14) * (mantissa / 1024);
+        if (exponent === 31) return mantissa ? NaN : sign * Infinity;
+        return sign * Math.pow(2, exponent - 15) * (1 + mantissa / 1024);
+    };
+
+    const readItems = (length, readOne) => {
+        if (length >= 0) {
+            for (let i = 0; i < length; i++) readOne(readItem());
+            return;
+        }
+        for (let item = readItem(); item !== BREAK; item = readItem()) readOne(item);
+    };
+
+    const readItem = () => {
+        const initial = view.getUint8(offset++);
+        const major = initial >> 5;
+        const info = initial & 0x1f;
+
+        switch (major) {
+            case 0: return readLength(info);
+            case 1: return -1 - readLength(info);
+            case 2:
+            case 3: {
+                const length = readLength(info);
+                if (length < 0) {
+                    const chunks = [];
+                    readItems(-1, chunk => chunks.push(chunk));
+                    return major === 3 ? chunks.join('') : chunks;
+                }
+                const chunk = bytes.subarray(offset, offset + length);
+                offset += length;
+                return major === 3 ? utf8Decoder.decode(chunk) : chunk;
+            }
+            case 4: {
+                const array = [];
+                readItems(readLength(info), item => array.push(item));
+                return array;
+            }
+            case 5: {
+                const object = {};
+                const length = readLength(info);
+                if (length >= 0) {
+                    for (let i = 0; i < length; i++) {
+                        const key = readItem();
+                        object[key] = readItem();
+                    }
+                } else {
+                    for (let key = readItem(); key !== BREAK; key = readItem()) {
+                        object[key] = readItem();
+                    }
+                }
+                return object;
+            }
+            case 6:
+                readLength(info); // tags carry no meaning for our payloads
+                return readItem();
+            default:
+                switch (info) {
+                    case 20: return false;
+                    case 21: return true;
+                    case 22: return null;
+                    case 23: return undefined;
+                    case 25: return readHalf();
+                    case 26: { const value = view.getFloat32(offset); offset += 4; return value; }
+                    case 27: { const value = view.getFloat64(offset); offset += 8; return value; }
+                    case 31: return BREAK;
+                    default: throw new Error('Unsupported CBOR simple value');
+                }
+        }
+    };
+
+    return readItem();
+}
+
+// Minimal MessagePack decoder
+function decodeMsgpack(bytes) {
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    let offset = 0;
+
+    const readString = (length) => {
+        const value = utf8Decoder.decode(bytes.subarray(offset, offset + length));
+        offset += length;
+        return value;
+    };
+    const readArray = (length) => {
+        const array = new Array(length);
+        for (let i = 0; i < length; i++) array[i] = readItem();
+        return array;
+    };
+    const readMap = (length) => {
+        const object = {};
+        for (let i = 0; i < length; i++) {
+            const key = readItem();
+            object[key] = readItem();
+        }
+        return object;
+    };
+    const read = (method, size) => {
+        const value = view[method](offset);
+        offset += size;
+        return value;
+    };
+
+    const readItem = () => {
+        const type = view.getUint8(offset++);
+        if (type <= 0x7f) return type;
+        if (type >= 0xe0) return type - 0x100;
+        if ((type & 0xf0) === 0x80) return readMap(type & 0x0f);
+        if ((type & 0xf0) === 0x90) return readArray(type & 0x0f);
+        if ((type & 0xe0) === 0xa0) return readString(type & 0x1f);
+
+        switch (type) {
+            case 0xc0: return null;
+            case 0xc2: return false;
+            case 0xc3: return true;
+            case 0xca: return read('getFloat32', 4);
+            case 0xcb: return read('getFloat64', 8);
+            case 0xcc: return read('getUint8', 1);
+            case 0xcd: return read('getUint16', 2);
+            case 0xce: return read('getUint32', 4);
+            case 0xcf: return Number(read('getBigUint64', 8));
+            case 0xd0: return read('getInt8', 1);
+            case 0xd1: return read('getInt16', 2);
+            case 0xd2: return read('getInt32', 4);
+            case 0xd3: return Number(read('getBigInt64', 8));
+            case 0xd9: return readString(read('getUint8', 1));
+            case 0xda: return readString(read('getUint16', 2));
+            case 0xdb: return readString(read('getUint32', 4));
+            case 0xdc: return readArray(read('getUint16', 2));
+            case 0xdd: return readArray(read('getUint32', 4));
+            case 0xde: return readMap(read('getUint16', 2));
+            case 0xdf: return readMap(read('getUint32', 4));
+            default: throw new Error('Unsupported MessagePack type 0x' + type.toString(16));
+        }
+    };
+
+    return readItem();
+}
+
 // Wait for WebSocket connection
 function waitForWebSocket() {
     return new Promise((resolve, reject) => {
@@ -169,8 +395,7 @@ async function viewUniverse(id) {
     currentUniverseId = id;
     try {
         await waitForWebSocket();
-        const response = await webui.call('getUniverses');
-        const data = JSON.parse(response);
+        const data = await callBackend('getUniverses');
         
         if (data.status !== 'success') {
             throw new Error(data.message || 'Failed to load universes');
@@ -182,6 +407,7 @@ async function viewUniverse(id) {
         }
         
         showUniverseDetail(universe);
+        loadExpansionHistory(id);
     } catch (error) {
         showNotification('Failed to load universe: ' + error.message, 'is-danger');
     }
@@ -192,8 +418,7 @@ async function deleteUniverse(id, name) {
     if (confirm(`Are you sure you want to delete universe "${name}"?`)) {
         try {
             await waitForWebSocket();
-            const response = await webui.call('deleteUniverse', JSON.stringify({ id }));
-            const data = JSON.parse(response);
+            const data = await callBackend('deleteUniverse', { id });
             
             if (data.status !== 'success') {
                 throw new Error(data.message);
@@ -224,64 +449,115 @@ function addDeleteButton(universeElement, universe) {
     universeElement.querySelector('.media').appendChild(actionsDiv);
 }
 
-// Update the universe list rendering to include delete buttons
+// Universe list. The backend pushes the list in batches to
+// receiveUniverseBatch(); each one is rendered on arrival and acknowledged,
+// and the backend pauses while too many batches are unacknowledged.
+const UNIVERSE_BATCH_SIZE = 500;
+const UNIVERSE_STREAM_WINDOW = 4;
+let universeStreamId = 0;
+let universeStreamCount = 0;
+// Batches can overtake the streamUniverses reply; they wait here for its id
+let universeStreamPending = false;
+const earlyUniverseBatches = [];
+
 async function updateUniverseList() {
     try {
         await waitForWebSocket();
-        const response = await webui.call('getUniverses');
-        const data = JSON.parse(response);
-        
+        if (universeStreamId) {
+            // Stop the previous stream; its late batches are ignored
+            webui.call('acknowledgeStream', JSON.stringify({ streamId: universeStreamId, cancel: true }));
+            universeStreamId = 0;
+        }
+        universeStreamPending = true;
+        earlyUniverseBatches.length = 0;
+        const data = await callBackend('streamUniverses', {
+            fields: LIST_FIELDS,
+            batchSize: UNIVERSE_BATCH_SIZE,
+            window: UNIVERSE_STREAM_WINDOW
+        });
+
         if (data.status !== 'success') {
             throw new Error(data.message || 'Failed to load universes');
         }
-        
-        const universes = data.universes;
-        const universeList = document.getElementById('universe-list');
-        universeList.innerHTML = '';
-        
-        if (universes.length === 0) {
+
+        universeStreamId = data.streamId;
+        universeStreamCount = 0;
+        document.getElementById('universe-list').innerHTML = '';
+        document.getElementById('universe-count').textContent = 0;
+        universeStreamPending = false;
+        earlyUniverseBatches.splice(0).forEach(renderUniverseBatch);
+    } catch (error) {
+        universeStreamPending = false;
+        console.error('Full error:', error);
+        showNotification('Failed to load universes: ' + error.message, 'is-danger');
+    }
+}
+
+// Invoked by the backend with one encoded batch of universes
+function receiveUniverseBatch(data) {
+    const batch = TRANSPORT_ENCODING === 'json'
+        ? JSON.parse(utf8Decoder.decode(data))
+        : decodeBinary(data, TRANSPORT_ENCODING);
+    if (universeStreamPending) {
+        earlyUniverseBatches.push(batch);
+        return;
+    }
+    renderUniverseBatch(batch);
+}
+
+function renderUniverseBatch(batch) {
+    if (batch.streamId !== universeStreamId) {
+        return;
+    }
+    webui.call('acknowledgeStream', JSON.stringify({ streamId: batch.streamId, sequence: batch.sequence }));
+
+    const universeList = document.getElementById('universe-list');
+    const fragment = document.createDocumentFragment();
+    batch.universes.forEach(universe => fragment.appendChild(createUniverseElement(universe)));
+    universeList.appendChild(fragment);
+    universeStreamCount += batch.universes.length;
+    document.getElementById('universe-count').textContent = universeStreamCount;
+
+    if (batch.done) {
+        universeStreamId = 0;
+        if (universeStreamCount === 0) {
             universeList.innerHTML = `
                 <div class="empty-state">
                     <p class="title is-4 has-text-light">No Universes Yet</p>
                     <p class="subtitle is-6 has-text-light">Create your first universe using the form on the left</p>
                 </div>
             `;
-            return;
         }
-        
-        universes.forEach(universe => {
-            const universeElement = document.createElement('div');
-            universeElement.className = 'box has-background-grey-darker universe-item';
-            universeElement.innerHTML = `
-                <article class="media">
-                    <div class="media-content">
-                        <div class="content has-text-light">
-                            <p>
-                                <strong class="has-text-light">${universe.name}</strong>
-                                <br>
-                                <small class="has-text-grey-lighter">Created: ${new Date(universe.createdAt).toLocaleString()}</small>
-                            </p>
-                            <div class="tags">
-                                <span class="tag is-primary">Ω_m: ${universe.matterDensity}</span>
-                                <span class="tag is-primary">Ω_Λ: ${universe.darkEnergyDensity}</span>
-                                <span class="tag is-primary">H₀: ${universe.hubbleConstant}</span>
-                            </div>
-                        </div>
-                    </div>
-                </article>
-            `;
-            universeElement.addEventListener('click', () => viewUniverse(universe.id));
-            addDeleteButton(universeElement, universe);
-            universeList.appendChild(universeElement);
-        });
-        
-        document.getElementById('universe-count').textContent = universes.length;
-    } catch (error) {
-        console.error('Full error:', error);
-        showNotification('Failed to load universes: ' + error.message, 'is-danger');
     }
 }
 
+function createUniverseElement(universe) {
+    const universeElement = document.createElement('div');
+    universeElement.className = 'box has-background-grey-darker universe-item';
+    universeElement.innerHTML = `
+        <article class="media">
+            <div class="media-content">
+                <div class="content has-text-light">
+                    <p>
+                        <strong class="has-text-light">${universe.name}</strong>
+                        <br>
+                        <small class="has-text-grey-lighter">Created: ${new Date(universe.createdAt).toLocaleString()}</small>
+                    </p>
+                    <div class="tags">
+                        <span class="tag is-primary">Ω_m: ${universe.matterDensity}</span>
+                        <span class="tag is-primary">Ω_Λ: ${universe.darkEnergyDensity}</span>
+                        <span class="tag is-primary">H₀: ${universe.hubbleConstant}</span>
+                        ${universe.ending ? `<span class="tag is-warning">${getMilestoneTitle(universe.ending)}</span>` : ''}
+                    </div>
+                </div>
+            </div>
+        </article>
+    `;
+    universeElement.addEventListener('click', () => viewUniverse(universe.id));
+    addDeleteButton(universeElement, universe);
+    return universeElement;
+}
+
 // Universe detail view
 function showUniverseDetail(universe) {
     const detailView = document.getElementById('universe-detail');
@@ -356,12 +632,147 @@ function showUniverseDetail(universe) {
     }, 300);
 }
 
-// Search functionality
+// Expansion history plot. The first call returns a coarse curve and a stream
+// id; the backend then pushes refinement chunks to receiveExpansionChunk()
+// until it is done. Each chunk is acknowledged, and loading another
+// universe cancels the previous stream on the backend.
+const EXPANSION_STREAM_WINDOW = 4;
+let expansionRequest = 0;
+let expansionStreamId = 0;
+let expansionSamples = [];
+let expansionDrawPending = false;
+// Chunks can overtake the getExpansionHistory reply; they wait here for its id
+const earlyExpansionChunks = [];
+
+async function loadExpansionHistory(id) {
+    const request = ++expansionRequest;
+    expansionStreamId = 0;
+    expansionSamples = [];
+    earlyExpansionChunks.length = 0;
+    try {
+        const data = await callBackend('getExpansionHistory', { id, window: EXPANSION_STREAM_WINDOW });
+        if (data.status !== 'success') {
+            throw new Error(data.message);
+        }
+        if (request !== expansionRequest) {
+            return;
+        }
+        expansionStreamId = data.streamId;
+        mergeExpansionSamples(data.samples);
+        earlyExpansionChunks.splice(0).forEach(renderExpansionChunk);
+    } catch (error) {
+        console.error('Failed to load expansion history:', error);
+    }
+}
+
+// Invoked by the backend with one encoded refinement chunk
+function receiveExpansionChunk(data) {
+    const chunk = TRANSPORT_ENCODING === 'json'
+        ? JSON.parse(utf8Decoder.decode(data))
+        : decodeBinary(data, TRANSPORT_ENCODING);
+    if (!expansionStreamId) {
+        earlyExpansionChunks.push(chunk);
+        return;
+    }
+    renderExpansionChunk(chunk);
+}
+
+function renderExpansionChunk(chunk) {
+    if (chunk.streamId !== expansionStreamId) {
+        return;
+    }
+    webui.call('acknowledgeStream', JSON.stringify({ streamId: chunk.streamId, sequence: chunk.sequence }));
+    mergeExpansionSamples(chunk.samples);
+}
+
+// Rows are [time, scaleFactor, hubble, temperature, matterFraction,
+// radiationFraction, darkEnergyFraction]; chunks arrive in error order
+function mergeExpansionSamples(rows) {
+    expansionSamples = expansionSamples.concat(rows).sort((a, b) => a[0] - b[0]);
+    if (!expansionDrawPending) {
+        expansionDrawPending = true;
+        requestAnimationFrame(() => {
+            expansionDrawPending = false;
+            drawExpansionHistory();
+        });
+    }
+}
+
+function drawExpansionHistory() {
+    const canvas = document.getElementById('expansion-plot');
+    if (!canvas || expansionSamples.length < 2) {
+        return;
+    }
+    const ctx = canvas.getContext('2d');
+    const half = canvas.height / 2;
+    ctx.clearRect(0, 0, canvas.width, canvas.height);
+
+    const logTimes = expansionSamples.map(row => Math.log10(row[0]));
+    const first = logTimes[0];
+    const span = logTimes[logTimes.length - 1] - first || 1;
+    const toX = value => (value - first) / span * canvas.width;
+
+    // a(t) and H(t) on log scales, each fitted to the upper half
+    plotSeries(ctx, logTimes, expansionSamples.map(row => Math.log10(row[1])), toX, 0, half, '#48c774');
+    plotSeries(ctx, logTimes, expansionSamples.map(row => Math.log10(row[2])), toX, 0, half, '#3e8ed0');
+    // Matter, radiation and dark energy fractions on [0, 1] in the lower half
+    plotSeries(ctx, logTimes, expansionSamples.map(row => row[4]), toX, half, half, '#f14668', 0, 1);
+    plotSeries(ctx, logTimes, expansionSamples.map(row => row[5]), toX, half, half, '#ffe08a', 0, 1);
+    plotSeries(ctx, logTimes, expansionSamples.map(row => row[6]), toX, half, half, '#b86bff', 0, 1);
+}
+
+function plotSeries(ctx, xs, ys, toX, top, height, color, min, max) {
+    if (min === undefined) {
+        const finite = ys.filter(Number.isFinite);
+        min = finite.reduce((a, b) => Math.min(a, b), Infinity);
+        max = finite.reduce((a, b) => Math.max(a, b), -Infinity);
+    }
+    const range = max - min || 1;
+    ctx.strokeStyle = color;
+    ctx.lineWidth = 1.5;
+    ctx.beginPath();
+    let drawing = false;
+    ys.forEach((y, i) => {
+        if (!Number.isFinite(y)) {
+            drawing = false;
+            return;
+        }
+        const px = toX(xs[i]);
+        const py = top + height - (y - min) / range * (height - 4) - 2;
+        if (drawing) {
+            ctx.lineTo(px, py);
+        } else {
+            ctx.moveTo(px, py);
+            drawing = true;
+        }
+    });
+    ctx.stroke();
+}
+
+// Search functionality. The backend forgives a typo or two ("phantm"
+// finds "Phantom"); plain substring matching is the fallback.
 const searchUniverses = debounce(async (query) => {
+    const term = query.trim().toLowerCase();
+    let matches = null;
+    if (term.length >= 3) {
+        try {
+            const data = await callBackend('searchUniverses', {
+                term,
+                maxDistance: term.length >= 8 ? 2 : 1,
+                fields: ['name']
+            });
+            if (data.status === 'success') {
+                matches = new Set(data.matches.map(match => match.universe.name.toLowerCase()));
+            }
+        } catch (error) {
+            console.error('Fuzzy search failed:', error);
+        }
+    }
+
     const universeItems = document.querySelectorAll('.universe-item');
     universeItems.forEach(item => {
         const name = item.querySelector('strong').textContent.toLowerCase();
-        if (name.includes(query.toLowerCase())) {
+        if (name.includes(term) || (matches && matches.has(name))) {
             item.style.display = '';
         } else {
             item.style.display = 'none';
@@ -395,11 +806,10 @@ async function exportUniverse(format) {
 
     try {
         await waitForWebSocket();
-        const response = await webui.call('exportUniverse', JSON.stringify({
+        const data = await callBackend('exportUniverse', {
             id: currentUniverseId,
             format: format
-        }));
-        const data = JSON.parse(response);
+        });
         
         if (data.status !== 'success') {
             throw new Error(data.message);
@@ -427,38 +837,86 @@ async function exportUniverse(format) {
     }
 }
 
+// Export of all universes. The backend pushes the document in pieces to
+// receiveExportChunk(), acknowledged like the universe list batches; the
+// download starts once the last piece arrived.
+const EXPORT_BATCH_SIZE = 1000;
+let exportStream = null;  // {id, format, parts}
+let exportStreamPending = false;
+const earlyExportChunks = [];
+
 async function exportAllUniverses(format) {
     try {
         await waitForWebSocket();
-        const response = await webui.call('exportAllUniverses', JSON.stringify({ format }));
-        const data = JSON.parse(response);
+        if (exportStream) {
+            webui.call('acknowledgeStream', JSON.stringify({ streamId: exportStream.id, cancel: true }));
+            exportStream = null;
+        }
+        exportStreamPending = true;
+        earlyExportChunks.length = 0;
+        const data = await callBackend('exportAllUniverses', {
+            format,
+            stream: true,
+            batchSize: EXPORT_BATCH_SIZE,
+            window: UNIVERSE_STREAM_WINDOW
+        });
         
         if (data.status !== 'success') {
             throw new Error(data.message);
         }
         
-        // Create a download link
-        const blob = new Blob([data.data], { 
-            type: format === 'json' ? 'application/json' : 'text/csv',
-            endings: 'native'
-        });
-        const url = window.URL.createObjectURL(blob);
-        const a = document.createElement('a');
-        a.style.display = 'none';
-        a.href = url;
-        const timestamp = new Date().toISOString().replace(/[:.]/g, '-');
-        a.download = `all_universes_${timestamp}.${format}`;
-        
-        document.body.appendChild(a);
-        a.click();
-        
-        window.URL.revokeObjectURL(url);
-        document.body.removeChild(a);
+        exportStream = { id: data.streamId, format, parts: [] };
+        exportStreamPending = false;
+        earlyExportChunks.splice(0).forEach(appendExportChunk);
     } catch (error) {
+        exportStreamPending = false;
         showNotification('Failed to export universes: ' + error.message, 'is-danger');
     }
 }
 
+// Invoked by the backend with one encoded piece of the export
+function receiveExportChunk(data) {
+    const chunk = TRANSPORT_ENCODING === 'json'
+        ? JSON.parse(utf8Decoder.decode(data))
+        : decodeBinary(data, TRANSPORT_ENCODING);
+    if (exportStreamPending) {
+        earlyExportChunks.push(chunk);
+        return;
+    }
+    appendExportChunk(chunk);
+}
+
+function appendExportChunk(chunk) {
+    if (!exportStream || chunk.streamId !== exportStream.id) {
+        return;
+    }
+    webui.call('acknowledgeStream', JSON.stringify({ streamId: chunk.streamId, sequence: chunk.sequence }));
+    exportStream.parts.push(chunk.text);
+    if (!chunk.done) {
+        return;
+    }
+
+    const { format, parts } = exportStream;
+    exportStream = null;
+    // Create a download link
+    const blob = new Blob(parts, { 
+        type: format === 'json' ? 'application/json' : 'text/csv',
+        endings: 'native'
+    });
+    const url = window.URL.createObjectURL(blob);
+    const a = document.createElement('a');
+    a.style.display = 'none';
+    a.href = url;
+    const timestamp = new Date().toISOString().replace(/[:.]/g, '-');
+    a.download = `all_universes_${timestamp}.${format}`;
+    
+    document.body.appendChild(a);
+    a.click();
+    
+    window.URL.revokeObjectURL(url);
+    document.body.removeChild(a);
+}
+
 // Debounce function to limit API calls
 function debounce(func, wait) {
     let timeout;
@@ -475,16 +933,58 @@ function debounce(func, wait) {
 // Initial load
 document.addEventListener('DOMContentLoaded', () => {
     updateUniverseList();
+    loadPresets();
 });
 
-// Universe creation form handling
-document.getElementById('universe-form').addEventListener('submit', async (e) => {
-    e.preventDefault();
-    const formData = new FormData(e.target);
-    const rawData = Object.fromEntries(formData.entries());
-    
-    // Convert numerical fields to numbers
-    const universeData = {
+// Reference scenarios. Their timelines were computed when the backend was
+// built, so choosing one fills the form and shows its timeline at once.
+let presets = [];
+
+async function loadPresets() {
+    try {
+        await waitForWebSocket();
+        const data = await callBackend('getPresets');
+        if (data.status !== 'success') {
+            throw new Error(data.message);
+        }
+        presets = data.presets;
+        const select = document.getElementById('preset-select');
+        presets.forEach((preset, index) => {
+            const option = document.createElement('option');
+            option.value = index;
+            option.textContent = preset.name;
+            option.title = preset.description;
+            select.appendChild(option);
+        });
+    } catch (error) {
+        console.error('Loading presets failed:', error);
+    }
+}
+
+document.getElementById('preset-select').addEventListener('input', (e) => {
+    // The preset's own timeline replaces the live preview
+    e.stopPropagation();
+    const preset = presets[e.target.value];
+    if (!preset) {
+        return;
+    }
+    const form = document.getElementById('universe-form');
+    form.elements.name.value = preset.name;
+    for (const field of ['matterDensity', 'darkEnergyDensity', 'hubbleConstant',
+                         'matterAntimatterRatio', 'darkEnergyW']) {
+        form.elements[field].value = preset[field];
+    }
+    renderPreview(preset.milestones);
+});
+
+// Live preview. Every edit of the form is sent to previewUniverse; the
+// backend drops previews that a newer one overtakes and pushes the result to
+// receivePreview(). Sequence numbers guard against stale pushes.
+let previewSequence = 0;
+
+function universeFormData(form) {
+    const rawData = Object.fromEntries(new FormData(form).entries());
+    return {
         name: rawData.name,
         matterDensity: parseFloat(rawData.matterDensity),
         darkEnergyDensity: parseFloat(rawData.darkEnergyDensity),
@@ -492,11 +992,65 @@ document.getElementById('universe-form').addEventListener('submit', async (e) =>
         matterAntimatterRatio: parseFloat(rawData.matterAntimatterRatio),
         darkEnergyW: parseFloat(rawData.darkEnergyW)
     };
+}
+
+async function requestPreview(form) {
+    const preview = document.getElementById('universe-preview');
+    try {
+        await waitForWebSocket();
+        const data = await callBackend('previewUniverse', universeFormData(form));
+        if (data.status === 'queued') {
+            previewSequence = Math.max(previewSequence, data.sequence);
+        } else {
+            preview.innerHTML = `<p class="has-text-grey-lighter is-size-7">${data.message}</p>`;
+        }
+    } catch (error) {
+        console.error('Preview failed:', error);
+    }
+}
+
+// Invoked by the backend with the encoded preview
+function receivePreview(data) {
+    const result = TRANSPORT_ENCODING === 'json'
+        ? JSON.parse(utf8Decoder.decode(data))
+        : decodeBinary(data, TRANSPORT_ENCODING);
+    if (result.sequence < previewSequence) {
+        return;
+    }
+    const preview = document.getElementById('universe-preview');
+    if (result.status !== 'success') {
+        preview.innerHTML = `<p class="has-text-grey-lighter is-size-7">${result.message}</p>`;
+        return;
+    }
+    renderPreview(result.universe.milestones);
+}
+
+function renderPreview(milestones) {
+    const preview = document.getElementById('universe-preview');
+    preview.innerHTML = milestones
+        .filter(milestone => milestone.timestamp !== null && !isNaN(milestone.timestamp))
+        .map(milestone => `
+            <p class="is-size-7 has-text-light">
+                <strong class="has-text-light">${getMilestoneTitle(milestone.type)}</strong>
+                ${formatTimestamp(milestone.timestamp)}
+            </p>
+        `)
+        .join('');
+}
+
+document.getElementById('universe-form').addEventListener('input', (e) => {
+    document.getElementById('preset-select').value = '';
+    requestPreview(e.currentTarget);
+});
+
+// Universe creation form handling
+document.getElementById('universe-form').addEventListener('submit', async (e) => {
+    e.preventDefault();
+    const universeData = universeFormData(e.target);
     
     try {
         await waitForWebSocket();
-        const response = await webui.call('createUniverse', JSON.stringify(universeData));
-        const data = JSON.parse(response);
+        const data = await callBackend('createUniverse', universeData);
         
         if (data.status === 'success') {
             updateUniverseList();
@@ -0,0 +1,404 @@
+// In-process load generator for the handlers.
+//
+// Calls the same handler functions as the webui bindings and the headless
+// server, without any transport in between, so what it measures is handler
+// and UniverseDB cost, including lock contention between client threads.
+//
+//   cosmic_load --mix create=20,list=10,search=40,export=20,delete=10
+//               --rate 20000 --threads 8 --duration 10 --preload 10000
+//   cosmic_load --rate 0 --threads 8             closed loop, as fast as possible
+//   cosmic_load --record trace.jsonl ...         save the generated requests
+//   cosmic_load --replay trace.jsonl --speed 2   replay a trace at twice the pace
+//
+// With a rate, arrivals are scheduled up front (Poisson, or evenly spaced
+// with --uniform) and latency is measured from each request's scheduled
+// time, not from when a busy client got around to sending it. That is the
+// coordinated-omission correction: a stall shows up in the latency of every
+// request that should have been sent during it. The service time, measured
+// from the actual send, is reported next to it for comparison.
+
+#include "Handlers.hpp"
+#include "LatencyHistogram.hpp"
+#include "UniverseDB.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+struct Operation {
+    std::string name;
+    std::string handler;
+    double weight;
+};
+
+// Default mix; --mix overrides the weights by name
+std::vector<Operation> default_operations() {
+    return {
+        {"create", "createUniverse", 20},
+        {"list", "getUniverses", 10},
+        {"search", "searchUniverses", 40},
+        {"export", "exportUniverse", 20},
+        {"delete", "deleteUniverse", 10},
+    };
+}
+
+struct Options {
+    std::vector<Operation> operations = default_operations();
+    double rate = 1000.0;  // requests per second over all threads; 0 = closed loop
+    bool uniform = false;
+    unsigned threads = 4;
+    double duration = 5.0;
+    size_t preload = 1000;
+    std::uint64_t seed = 1;
+    std::string recordPath;
+    std::string replayPath;
+    double speed = 1.0;
+};
+
+// One request to send: when (relative to the start of the run) and what
+struct Arrival {
+    std::int64_t offset;  // nanoseconds
+    size_t operation;
+    std::string body;     // generated at send time when empty
+};
+
+class LoadCall final : public Call {
+public:
+    LoadCall(std::string_view content, size_t clientId, std::string& reply)
+        : content(content), clientId(clientId), reply(reply) {}
+
+    std::string_view body() const override { return content; }
+    void respond(const TransportOptions&, EncodedResponse& response) override {
+        reply.assign(response.finish());
+    }
+    Pusher pusher() const override { return {}; }
+    size_t client() const override { return clientId; }
+
+private:
+    std::string_view content;
+    size_t clientId;
+    std::string& reply;
+};
+
+json random_universe(std::mt19937_64& random, size_t index) {
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    const double matter = 0.1 + 0.9 * unit(random);
+    return {
+        {"name", "Load " + std::to_string(index)},
+        {"matterDensity", matter},
+        {"darkEnergyDensity", std::clamp(1.0 - matter + 0.18 * (unit(random) - 0.5), 0.0, 1.0)},
+        {"hubbleConstant", 50.0 + 30.0 * unit(random)},
+        {"matterAntimatterRatio", std::pow(10.0, -11.0 + 4.0 * unit(random))},
+        {"darkEnergyW", -2.0 + 1.5 * unit(random)},
+    };
+}
+
+// Request body for a generated operation. Ids are drawn from everything
+// handed out so far, so exports and deletes also hit removed universes.
+std::string make_body(const Operation& operation, std::mt19937_64& random, size_t index) {
+    const int bound = std::max(1, UniverseDB::instance().getIdBound());
+    std::uniform_int_distribution<int> id(0, bound - 1);
+    if (operation.name == "create") {
+        return random_universe(random, index).dump();
+    }
+    if (operation.name == "list") {
+        return json{{"fields", {"id", "name"}}}.dump();
+    }
+    if (operation.name == "search") {
+        return json{{"term", std::to_string(random() % 100)}, {"fields", {"id", "name"}}}.dump();
+    }
+    if (operation.name == "export") {
+        return json{{"format", random() % 2 ? "json" : "csv"}, {"id", id(random)}}.dump();
+    }
+    return json{{"id", id(random)}}.dump();
+}
+
+std::vector<Operation> parse_mix(const std::string& text) {
+    std::vector<Operation> operations = default_operations();
+    for (auto& operation : operations) {
+        operation.weight = 0;
+    }
+    std::stringstream items(text);
+    std::string item;
+    while (std::getline(items, item, ',')) {
+        const size_t equals = item.find('=');
+        const std::string name = item.substr(0, equals);
+        auto it = std::find_if(operations.begin(), operations.end(),
+                               [&](const Operation& operation) { return operation.name == name; });
+        if (it == operations.end() || equals == std::string::npos) {
+            throw std::runtime_error("Unknown mix entry: " + item);
+        }
+        it->weight = std::stod(item.substr(equals + 1));
+    }
+    return operations;
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--mix") {
+            options.operations = parse_mix(next());
+        } else if (arg == "--rate") {
+            options.rate = std::stod(next());
+        } else if (arg == "--uniform") {
+            options.uniform = true;
+        } else if (arg == "--threads") {
+            options.threads = std::max(1, std::stoi(next()));
+        } else if (arg == "--duration") {
+            options.duration = std::stod(next());
+        } else if (arg == "--preload") {
+            options.preload = std::stoul(next());
+        } else if (arg == "--seed") {
+            options.seed = std::stoull(next());
+        } else if (arg == "--record") {
+            options.recordPath = next();
+        } else if (arg == "--replay") {
+            options.replayPath = next();
+        } else if (arg == "--speed") {
+            options.speed = std::stod(next());
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+    return options;
+}
+
+// Open-loop arrivals at the given mean rate
+std::vector<Arrival> schedule(const Options& options) {
+    std::mt19937_64 random(options.seed);
+    std::exponential_distribution<double> gap(options.rate);
+    std::vector<double> weights;
+    for (const auto& operation : options.operations) {
+        weights.push_back(operation.weight);
+    }
+    std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+
+    std::vector<Arrival> arrivals;
+    double at = 0.0;
+    for (size_t i = 0;; ++i) {
+        at = options.uniform ? i / options.rate : at + gap(random);
+        if (at >= options.duration) {
+            break;
+        }
+        arrivals.push_back({static_cast<std::int64_t>(at * 1e9), pick(random), {}});
+    }
+    return arrivals;
+}
+
+// Trace lines: {"at": seconds, "body": {...}, "handler": "..."}
+std::vector<Arrival> load_trace(const Options& options, std::vector<Operation>& operations) {
+    std::ifstream in(options.replayPath);
+    if (!in) {
+        throw std::runtime_error("Cannot open " + options.replayPath);
+    }
+    std::vector<Arrival> arrivals;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        const json entry = json::parse(line);
+        const std::string handler = entry.at("handler").get<std::string>();
+        if (!find_handler(handler)) {
+            throw std::runtime_error("Trace names an unknown handler: " + handler);
+        }
+        auto it = std::find_if(operations.begin(), operations.end(),
+                               [&](const Operation& operation) { return operation.handler == handler; });
+        if (it == operations.end()) {
+            operations.push_back({handler, handler, 0});
+            it = operations.end() - 1;
+        }
+        const double at = entry.at("at").get<double>() / options.speed;
+        arrivals.push_back({static_cast<std::int64_t>(at * 1e9), static_cast<size_t>(it - operations.begin()),
+                            entry.at("body").dump()});
+    }
+    std::stable_sort(arrivals.begin(), arrivals.end(),
+                     [](const Arrival& a, const Arrival& b) { return a.offset < b.offset; });
+    return arrivals;
+}
+
+struct ClientResult {
+    std::vector<LatencyHistogram> latency;  // from the scheduled time
+    std::vector<LatencyHistogram> service;  // from the actual send
+    std::vector<std::uint64_t> errors;
+    std::vector<json> trace;
+};
+
+void preload(size_t count, std::uint64_t seed) {
+    constexpr size_t kBatch = 1000;
+    const HandlerEntry* create = find_handler("createUniverses");
+    std::mt19937_64 random(seed ^ 0x9e3779b97f4a7c15ull);
+    std::string reply;
+    for (size_t done = 0; done < count; done += kBatch) {
+        json batch = json::array();
+        for (size_t i = done; i < std::min(count, done + kBatch); ++i) {
+            batch.push_back(random_universe(random, i));
+        }
+        const std::string body = json{{"universes", std::move(batch)}}.dump();
+        LoadCall call(body, 0, reply);
+        invoke_handler(*create, call);
+    }
+}
+
+void print_row(const std::string& name, const LatencyHistogram& latency, const LatencyHistogram& service,
+               std::uint64_t errors, double seconds) {
+    auto us = [](std::uint64_t ns) { return ns / 1000.0; };
+    std::printf("%-16s %9llu %7llu %10.0f %10.1f %10.1f %10.1f %10.1f %10.1f\n", name.c_str(),
+                static_cast<unsigned long long>(latency.getCount()), static_cast<unsigned long long>(errors),
+                latency.getCount() / seconds, us(latency.percentile(0.5)), us(latency.percentile(0.99)),
+                us(latency.percentile(0.999)), us(latency.getMax()), us(service.percentile(0.99)));
+}
+
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::vector<Arrival> arrivals;
+    try {
+        options = parse_options(argc, argv);
+        if (!options.replayPath.empty()) {
+            arrivals = load_trace(options, options.operations);
+        } else if (options.rate > 0) {
+            arrivals = schedule(options);
+        }
+    } catch (const std::exception& ex) {
+        std::cerr << "cosmic_load: " << ex.what() << std::endl;
+        return 2;
+    }
+    const bool closedLoop = options.replayPath.empty() && options.rate <= 0;
+
+    // Handlers log every create and delete; keep that off the terminal
+    std::streambuf* console = std::cout.rdbuf(nullptr);
+    preload(options.preload, options.seed);
+
+    const size_t operationCount = options.operations.size();
+    std::vector<ClientResult> results(options.threads);
+    for (auto& result : results) {
+        result.latency.resize(operationCount);
+        result.service.resize(operationCount);
+        result.errors.resize(operationCount);
+    }
+
+    std::vector<double> weights;
+    for (const auto& operation : options.operations) {
+        weights.push_back(operation.weight);
+    }
+
+    const auto start = Clock::now() + std::chrono::milliseconds(10);
+    const auto end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+    std::vector<std::thread> clients;
+    for (unsigned t = 0; t < options.threads; ++t) {
+        clients.emplace_back([&, t] {
+            ClientResult& result = results[t];
+            std::mt19937_64 random(options.seed * 1000003 + t);
+            std::discrete_distribution<size_t> pick(weights.begin(), weights.end());
+            std::string body;
+            std::string reply;
+
+            auto send = [&](size_t operation, Clock::time_point scheduled) {
+                const Operation& op = options.operations[operation];
+                const HandlerEntry* entry = find_handler(op.handler);
+                const auto sent = Clock::now();
+                LoadCall call(body, t, reply);
+                invoke_handler(*entry, call);
+                const auto done = Clock::now();
+                result.latency[operation].record(std::chrono::nanoseconds(done - scheduled).count());
+                result.service[operation].record(std::chrono::nanoseconds(done - sent).count());
+                if (reply.find("\"status\":\"error\"") != std::string::npos) {
+                    ++result.errors[operation];
+                }
+                if (!options.recordPath.empty()) {
+                    result.trace.push_back({{"at", std::chrono::duration<double>(scheduled - start).count()},
+                                            {"body", json::parse(body)},
+                                            {"handler", op.handler}});
+                }
+            };
+
+            std::this_thread::sleep_until(start);
+            if (closedLoop) {
+                for (size_t i = 0; Clock::now() < end; ++i) {
+                    const size_t operation = pick(random);
+                    body = make_body(options.operations[operation], random, i);
+                    send(operation, Clock::now());
+                }
+                return;
+            }
+            for (size_t i = t; i < arrivals.size(); i += options.threads) {
+                const Arrival& arrival = arrivals[i];
+                const auto scheduled = start + std::chrono::nanoseconds(arrival.offset);
+                body = arrival.body.empty() ? make_body(options.operations[arrival.operation], random, i)
+                                            : arrival.body;
+                std::this_thread::sleep_until(scheduled);
+                send(arrival.operation, scheduled);
+            }
+        });
+    }
+    for (auto& client : clients) {
+        client.join();
+    }
+    const double seconds = std::max(options.duration, std::chrono::duration<double>(Clock::now() - start).count());
+    std::cout.rdbuf(console);
+
+    if (!options.recordPath.empty()) {
+        std::vector<json> trace;
+        for (auto& result : results) {
+            trace.insert(trace.end(), result.trace.begin(), result.trace.end());
+        }
+        std::stable_sort(trace.begin(), trace.end(),
+                         [](const json& a, const json& b) { return a["at"].get<double>() < b["at"].get<double>(); });
+        std::ofstream out(options.recordPath);
+        for (const auto& entry : trace) {
+            out << entry.dump() << '\n';
+        }
+    }
+
+    std::printf("%s, %u threads, %.1f s, %zu universes preloaded\n",
+                closedLoop ? "closed loop" : options.replayPath.empty() ? "open loop" : "replay",
+                options.threads, seconds, options.preload);
+    std::printf("%-16s %9s %7s %10s %10s %10s %10s %10s %10s\n", "operation", "requests", "errors", "req/s",
+                "p50 us", "p99 us", "p99.9 us", "max us", "svc p99");
+    LatencyHistogram totalLatency;
+    LatencyHistogram totalService;
+    std::uint64_t totalErrors = 0;
+    for (size_t operation = 0; operation < operationCount; ++operation) {
+        LatencyHistogram latency;
+        LatencyHistogram service;
+        std::uint64_t errors = 0;
+        for (const auto& result : results) {
+            latency.merge(result.latency[operation]);
+            service.merge(result.service[operation]);
+            errors += result.errors[operation];
+        }
+        if (latency.getCount() == 0) {
+            continue;
+        }
+        print_row(options.operations[operation].name, latency, service, errors, seconds);
+        totalLatency.merge(latency);
+        totalService.merge(service);
+        totalErrors += errors;
+    }
+    print_row("total", totalLatency, totalService, totalErrors, seconds);
+    return 0;
+}
@@ -0,0 +1,168 @@
+// Parameter sweep with checkpoint and resume.
+//
+// Evaluates the timeline of every point of a parameter grid and writes the
+// aggregates (ending counts and per-milestone timestamp moments) as JSON.
+//
+//   cosmic_sweep --steps 12 --checkpoint sweep.ckpt --output sweep.json
+//   cosmic_sweep --axis hubbleConstant=60:75:31 --axis darkEnergyW=-1.5:-0.7:41 ...
+//   cosmic_sweep --steps 40 --precision fast
+//
+// --precision fast evaluates the formulas with FastMath's pow (relative
+// error below 1e-10); the default is exact unless the build was configured
+// with -DCOSMIC_FAST_MATH=ON.
+//
+// Progress is checkpointed every --interval seconds (and on Ctrl-C). Run the
+// same command again after a crash or kill to resume: finished chunks are
+// skipped and the output is identical to that of an uninterrupted run. The
+// checkpoint is removed once the output has been written.
+
+#include "BatchSweep.hpp"
+#include <nlohmann/json.hpp>
+#include <csignal>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr const char* kAxisNames[SweepSpec::kAxes] = {
+    "matterDensity", "darkEnergyDensity", "hubbleConstant", "matterAntimatterRatio", "darkEnergyW",
+};
+
+struct Options {
+    SweepSpec spec;
+    BatchSweep::Options sweep;
+    std::string outputPath = "sweep.json";
+};
+
+// name=min:max:steps
+void parse_axis(SweepSpec& spec, const std::string& text) {
+    const size_t equals = text.find('=');
+    const size_t first = text.find(':', equals);
+    const size_t second = text.find(':', first + 1);
+    if (equals == std::string::npos || first == std::string::npos || second == std::string::npos) {
+        throw std::runtime_error("Expected name=min:max:steps, got " + text);
+    }
+    const std::string name = text.substr(0, equals);
+    for (size_t a = 0; a < SweepSpec::kAxes; ++a) {
+        if (name == kAxisNames[a]) {
+            spec.axes[a].min = std::stod(text.substr(equals + 1, first - equals - 1));
+            spec.axes[a].max = std::stod(text.substr(first + 1, second - first - 1));
+            spec.axes[a].steps = std::stoul(text.substr(second + 1));
+            return;
+        }
+    }
+    throw std::runtime_error("Unknown axis: " + name);
+}
+
+Options parse_options(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("Missing value for " + arg);
+            }
+            return argv[++i];
+        };
+        if (arg == "--steps") {
+            const size_t steps = std::stoul(next());
+            for (auto& axis : options.spec.axes) {
+                axis.steps = steps;
+            }
+        } else if (arg == "--axis") {
+            parse_axis(options.spec, next());
+        } else if (arg == "--chunk") {
+            options.spec.chunkSize = std::stoul(next());
+        } else if (arg == "--threads") {
+            options.sweep.threads = static_cast<unsigned>(std::stoul(next()));
+        } else if (arg == "--checkpoint") {
+            options.sweep.checkpointPath = next();
+        } else if (arg == "--interval") {
+            options.sweep.checkpointInterval = std::chrono::milliseconds(static_cast<long>(std::stod(next()) * 1000));
+        } else if (arg == "--precision") {
+            const std::string precision = next();
+            if (precision == "exact") {
+                options.sweep.precision = MilestoneFormulas::Precision::Exact;
+            } else if (precision == "fast") {
+                options.sweep.precision = MilestoneFormulas::Precision::Fast;
+            } else {
+                throw std::runtime_error("Expected exact or fast, got " + precision);
+            }
+        } else if (arg == "--output") {
+            options.outputPath = next();
+        } else {
+            throw std::runtime_error("Unknown option: " + arg);
+        }
+    }
+    return options;
+}
+
+BatchSweep* running = nullptr;
+
+extern "C" void stop_sweep(int) {
+    if (running) {
+        running->stop();
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& ex) {
+        std::cerr << "cosmic_sweep: " << ex.what() << std::endl;
+        return 2;
+    }
+
+    try {
+        size_t reported = 0;
+        options.sweep.progress = [&](size_t done, size_t total) {
+            if (done * 100 / total != reported) {
+                reported = done * 100 / total;
+                std::cerr << "\r" << reported << "% (" << done << "/" << total << " chunks)" << std::flush;
+            }
+        };
+        BatchSweep sweep(options.spec, options.sweep);
+        running = &sweep;
+        std::signal(SIGINT, stop_sweep);
+        std::signal(SIGTERM, stop_sweep);
+        const BatchSweep::Result result = sweep.run();
+        running = nullptr;
+        std::cerr << std::endl;
+
+        std::printf("%zu universes in %zu chunks: %zu run, %zu resumed, %.2f s\n", options.spec.size(),
+                    options.spec.chunkCount(), result.chunksRun, result.chunksResumed, result.seconds);
+        if (!options.sweep.checkpointPath.empty()) {
+            std::printf("%zu checkpoints, %.3f s (%.3f%% of the run)\n", result.checkpoints,
+                        result.checkpointSeconds, 100.0 * result.checkpointSeconds / std::max(result.seconds, 1e-9));
+        }
+        if (!result.complete) {
+            std::printf("Stopped; run the same command again to resume\n");
+            return 1;
+        }
+
+        std::ofstream out(options.outputPath);
+        const bool fast = options.sweep.precision == MilestoneFormulas::Precision::Fast;
+        out << json{{"aggregate", result.aggregate.toJson()}, {"precision", fast ? "fast" : "exact"},
+                    {"spec", options.spec.toJson()}}.dump(2) << "\n";
+        if (!out) {
+            throw std::runtime_error("Cannot write " + options.outputPath);
+        }
+        out.close();
+        if (!options.sweep.checkpointPath.empty()) {
+            std::remove(options.sweep.checkpointPath.c_str());
+        }
+        std::printf("Wrote %s\n", options.outputPath.c_str());
+    } catch (const std::exception& ex) {
+        std::cerr << "\ncosmic_sweep: " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}